@@ -18,8 +18,6 @@ SPDX-License-Identifier: Apache-2.0
 #include <pixenals_alloc_utils.h>
 #include <pixenals_io_utils.h>
 
-#define STUC_DISABLE_EDGES_IN_BUF
-
 #define STUC_DISABLE_TRIANGULATION
 
 
@@ -31,12 +29,14 @@ SPDX-License-Identifier: Apache-2.0
 
 #define STUC_ATTRIB_NAME_MAX_LEN 96
 #define STUC_ATTRIB_STRING_MAX_LEN 64
+#define STUC_CODEC_MAX 16
 
 //TODO remove opaque strctures to allow external stack allocation
 typedef struct StucContextInternal *StucContext;
 typedef struct StucMapInternal *StucMap;
 typedef struct StucMapExportIntern StucMapExport;
 typedef struct StucMapLoadIntern StucMapLoad;
+typedef struct StucCancelTokenIntern StucCancelToken;
 
 //TODO unify naming. different structs and enums called "type", "attrib", "blend".
 //Make it consistent. They're attribute types;
@@ -283,6 +283,12 @@ typedef struct StucMapArrEntry {
 	StucBlendOptArr blendOptArr[STUC_DOMAIN_MESH];
 	float wScale;
 	float receiveLen;
+	//if > 0, and the map was exported with lods, each in-face is mapped with the
+	//finest level whose avg edge len, once scaled by the face's uv to world ratio,
+	//is at least this len, or the coarsest if none are.
+	//Levels aren't stitched where adjacent in-faces use different ones.
+	//Ignored for maps with usgs
+	float lodEdgeLen;
 	int8_t matIdx;
 } StucMapArrEntry;
 
@@ -292,6 +298,33 @@ typedef struct StucMapArr {
 	int32_t count;
 } StucMapArr;
 
+typedef enum StucRoiType {
+	STUC_ROI_NONE,
+	STUC_ROI_FACES,
+	STUC_ROI_UV_RECTS,
+	STUC_ROI_WORLD_BOUNDS
+} StucRoiType;
+
+typedef struct StucRoiRect {
+	Stuc_V2_F32 min;
+	Stuc_V2_F32 max;
+} StucRoiRect;
+
+//Region of interest for stucMapToMesh.
+//In-faces outside the region are skipped before any map lookup,
+//so the out-mesh only contains geometry mapped onto in-faces within it.
+//STUC_ROI_FACES - pFaceMask is a bitmask with 1 bit per in-face (lsb first)
+//STUC_ROI_UV_RECTS - in-faces whose uv bounds overlap any rect in pUvRects
+//STUC_ROI_WORLD_BOUNDS - in-faces whose pos bounds overlap worldMin/worldMax
+typedef struct StucRoi {
+	StucRoiType type;
+	const uint8_t *pFaceMask;
+	const StucRoiRect *pUvRects;
+	int32_t uvRectCount;
+	Stuc_V3_F32 worldMin;
+	Stuc_V3_F32 worldMax;
+} StucRoi;
+
 typedef struct StucAttribActive {
 	StucDomain domain;
 	int16_t idx;
@@ -315,6 +348,17 @@ typedef struct StucMesh {
 	int32_t vertCount;
 } StucMesh;
 
+//Per-mesh args for stucMapToMeshBatch, which match those of stucMapToMesh.
+//pInIndexedAttribs & pRoi may be NULL
+typedef struct StucMapToMeshBatchEntry {
+	const StucMesh *pMeshIn;
+	const StucAttribIndexedArr *pInIndexedAttribs;
+	StucMesh *pMeshOut;
+	StucAttribIndexedArr *pOutIndexedAttribs;
+	const StucRoi *pRoi;
+	bool keepExistingIdxAttribs;
+} StucMapToMeshBatchEntry;
+
 typedef struct StucObject {
 	StucObjectData *pData;
 	Stuc_M4x4 transform;
@@ -354,13 +398,87 @@ typedef struct StucThreadPool {
 
 typedef PixioFileOpenType StucFileOpenType;
 
+//open types passed to StucIo.fpOpen. Write truncates, update opens an existing file
+//for reading and writing without truncating it (only used if fpSeek is set)
+#define STUC_FILE_OPEN_WRITE ((StucFileOpenType)0)
+#define STUC_FILE_OPEN_READ ((StucFileOpenType)1)
+#define STUC_FILE_OPEN_UPDATE ((StucFileOpenType)2)
+
 typedef struct StucIo {
 	StucErr (*fpOpen)(void **, const char *, StucFileOpenType, const StucAlloc *);
 	StucErr (*fpWrite)(void *, const unsigned char *, int32_t);
 	StucErr (*fpRead)(void *, unsigned char *, int32_t);
 	StucErr (*fpClose)(void *);
+	//Optional async reads, used to read ahead while map data is decoded.
+	//Submit starts a read and outputs a request handle. Poll checks the request,
+	//or blocks until it's complete if wait is true. Once done, the request is
+	//destroyed and the result of the read is returned.
+	//At most one read is in flight per file, and fpSeek is only called between reads.
+	//The default io runs these on an io thread per file.
+	//If NULL, reads are instead run on the thread pool with fpRead, except for
+	//map loads which are themselves pool jobs, where reads are synchronous
+	StucErr (*fpReadSubmit)(void *, unsigned char *, int32_t, void **);
+	StucErr (*fpReadPoll)(void *, bool, bool *);
+	//Optional. Moves the file's position to an absolute byte offset.
+	//Used to update map files in place, and to read files that have been.
+	//If NULL, updates rewrite the whole file, and files updated in place
+	//can only be read if their records are still in order
+	StucErr (*fpSeek)(void *, int64_t);
 } StucIo;
 
+//codec ids are stored in map files, so they must stay the same between builds.
+//Custom codecs can use any id from STUC_CODEC_CUSTOM up to STUC_CODEC_MAX
+typedef enum StucCodecId {
+	STUC_CODEC_STORE,
+	STUC_CODEC_DEFLATE,
+	STUC_CODEC_CUSTOM
+} StucCodecId;
+
+//Optional compact encoding of map geometry.
+//Active pos and uv attribs are stored as fixed point values against the object's
+//bounds, so the max error per component is half a step, (max - min) / (2^bits - 1) / 2,
+//plus the rounding of the decoded value to F32.
+//Active normals are octahedral encoded, with a max angular error of around
+//0.9, 0.06, and 0.004 degrees at 8, 12, and 16 bits respectively.
+//Bit counts of 0 leave an attrib as F32, and can otherwise be at most 24.
+//Only V3_F32 pos & normal attribs, and V2_F32 uv attribs are quantized
+typedef struct StucMapQuantize {
+	int32_t posBits;
+	int32_t uvBits;
+	int32_t normalBits;
+	//stores the face, corner, and edge lists as varint coded deltas
+	bool deltaLists;
+	//renumbers verts and edges in the order corners first reference them,
+	//which keeps deltas small. The original vert and edge order isn't kept
+	bool reorder;
+} StucMapQuantize;
+
+#define STUC_MAP_LOD_MAX 8
+
+//fpCompress may be called from multiple threads at once
+typedef struct StucCodec {
+	//compresses the input in full. The output is allocated with the StucAlloc
+	StucErr (*fpCompress)(
+		const StucAlloc *,
+		const unsigned char *,
+		int64_t,
+		unsigned char **,
+		int64_t *
+	);
+	StucErr (*fpDecompressInit)(const StucAlloc *, void **);
+	//decompresses as much as it can, advancing the in and out ptrs,
+	//and decrementing their remaining sizes
+	StucErr (*fpDecompress)(
+		void *,
+		const unsigned char **,
+		int64_t *,
+		unsigned char **,
+		int64_t *
+	);
+	//only called if init output a non-NULL state
+	void (*fpDecompressDestroy)(const StucAlloc *, void *);
+} StucCodec;
+
 typedef struct StucImage {
 	void *pData;
 	StucImageType type;
@@ -383,6 +501,22 @@ typedef struct StucUsgArr {
 	int32_t count;
 } StucUsgArr;
 
+//selects which records stucMapFileLoadForEdit decodes.
+//Files from older map versions have no table of contents and are rejected
+//on load, they must be re-exported
+typedef struct StucMapLoadFilter {
+	//file-order indices of the objects (and targets) to decode. If NULL, all are decoded.
+	//The output object arr still has a slot per object in the file, in file order,
+	//so indices match a full load. Skipped objects are left with a NULL pData
+	const int32_t *pObjIdxArr;
+	int32_t objIdxCount;
+	bool skipUsgs;
+	//usg flat-cutoff indices still refer to the file's cutoffs if these are skipped
+	bool skipFlatCutoffs;
+	//ignored if any objects are decoded, as they reference them
+	bool skipIdxAttribs;
+} StucMapLoadFilter;
+
 #define STUC_STAGE_NAME_LEN 64
 typedef struct StucStageReport {
 	char stage[STUC_STAGE_NAME_LEN];
@@ -407,6 +541,23 @@ StucErr stucContextInit(
 	StucTypeDefaultConfig *pTypeDefaultConfig,
 	StucStageReport *pStageReport
 );
+//Enables memoization of clip results. In-pieces whose tile-relative border UVs
+//match a previously clipped piece against the same map face, after snapping to
+//a 1/65536 grid, reuse that result. The cache is shared across a stage's jobs.
+//Intended for in-meshes with repeated UV layouts (trim sheets, instanced geometry, etc).
+//Off by default
+STUC_EXPORT
+StucErr stucContextClipCacheSet(StucContext pCtx, bool enable);
+//Keeps the in-mesh's derived tables (edge list, edge adjacency, seam & preserve tables)
+//on the context between stucMapToMesh calls. They're reused if a later call's in-mesh
+//has the same topology, uvs, and preserve attribs (a copy of these is kept to compare).
+//Concurrent calls can share the cached tables.
+//Must not be toggled while a map-to-mesh job is in flight. Off by default
+STUC_EXPORT
+StucErr stucContextInMeshCacheSet(StucContext pCtx, bool enable);
+//registers a custom codec for use in map files
+STUC_EXPORT
+StucErr stucCodecSet(StucContext pCtx, int32_t id, const StucCodec *pCodec);
 STUC_EXPORT
 StucErr stucMapExportInit(
 	StucContext pCtx,
@@ -414,8 +565,44 @@ StucErr stucMapExportInit(
 	const char *pPath,
 	bool compress
 );
+//Starts an update of an existing map file, to be written to pPath (which can be
+//the same as pSrcPath). Records in the file are kept as they are, without being
+//decoded or recompressed, unless replaced with one of the stucMapExport*Replace funcs.
+//Records added with the stucMapExport*Add funcs are appended, though targets
+//can't be added in an update. Call stucMapExportEnd to write the file.
+//If pPath is pSrcPath and the io has fpSeek, only new and replaced records, and the
+//header, are written. They're appended to the file, and the space of replaced records
+//isn't reclaimed until the map is re-exported, or updated to a different path
+STUC_EXPORT
+StucErr stucMapExportUpdateInit(
+	StucContext pCtx,
+	StucMapExport **ppHandle,
+	const char *pSrcPath,
+	const char *pPath,
+	bool compress
+);
 STUC_EXPORT
 StucErr stucMapExportEnd(StucMapExport **ppHandle);
+//Sets the codec used for objects, usgs and flat-cutoffs added after this call,
+//and for the idx attribs if called before stucMapExportEnd.
+//Defaults to STUC_CODEC_DEFLATE, or STUC_CODEC_STORE if compress is false
+STUC_EXPORT
+StucErr stucMapExportCodecSet(StucMapExport *pHandle, int32_t codec);
+//Sets the geometry encoding used for records added after this call.
+//Pass NULL to go back to the default of storing everything at full precision
+STUC_EXPORT
+StucErr stucMapExportQuantizeSet(StucMapExport *pHandle, const StucMapQuantize *pOpts);
+//Stores up to levelCount (at most STUC_MAP_LOD_MAX) decimated copies of each object
+//added after this call, each with double the avg edge len of the last.
+//Levels that fail to reduce the vert count are skipped. Targets aren't decimated.
+//Pass 0 to stop adding lods
+STUC_EXPORT
+StucErr stucMapExportLodsSet(StucMapExport *pHandle, int32_t levelCount);
+//If bake is true, the target is mapped now, and the result is stored alongside the
+//source mesh. On load, the stored result is used as long as the timestamps of the maps
+//it was mapped with, and of their deps (recursively), haven't changed, otherwise the
+//target's re-mapped as usual.
+//Maps and their deps must have been loaded with a non-zero timestamp for a target to be baked
 STUC_EXPORT
 StucErr stucMapExportTargetAdd(
 	StucMapExport *pHandle,
@@ -423,7 +610,8 @@ StucErr stucMapExportTargetAdd(
 	const StucObject *pObj,
 	const StucAttribIndexedArr *pIndexedAttribs,
 	float wScale,
-	float receiveLen
+	float receiveLen,
+	bool bake
 );
 STUC_EXPORT
 StucErr stucMapExportObjAdd(
@@ -435,6 +623,26 @@ STUC_EXPORT
 StucErr stucMapExportUsgAdd(StucMapExport *pHandle, StucUsg *pUsg);
 STUC_EXPORT
 StucErr stucMapExportUsgCutoffAdd(StucMapExport *pHandle, StucObject *pFlatCutoff);
+//Replace a record in a map file being updated. Indices are the same as the
+//arrays output by stucMapFileLoadForEdit. If objIdx is a target, it's replaced
+//with a plain object
+STUC_EXPORT
+StucErr stucMapExportObjReplace(
+	StucMapExport *pHandle,
+	int32_t objIdx,
+	const StucObject *pObj,
+	const StucAttribIndexedArr *pIndexedAttribs
+);
+STUC_EXPORT
+StucErr stucMapExportUsgReplace(StucMapExport *pHandle, int32_t usgIdx, StucUsg *pUsg);
+STUC_EXPORT
+StucErr stucMapExportUsgCutoffReplace(
+	StucMapExport *pHandle,
+	int32_t cutoffIdx,
+	StucObject *pFlatCutoff
+);
+//Loads the objects in a map file as they were exported.
+//Pass a filter to only decode some of them, or NULL to decode everything
 STUC_EXPORT
 StucErr stucMapFileLoadForEdit(
 	StucContext pCtx,
@@ -445,7 +653,8 @@ StucErr stucMapFileLoadForEdit(
 	StucUsg **ppUsgArr,
 	int32_t *pFlatCutoffCount,
 	StucObject **ppFlatCutoffArr,
-	StucAttribIndexedArr *pIndexedAttribs
+	StucAttribIndexedArr *pIndexedAttribs,
+	const StucMapLoadFilter *pFilter
 );
 STUC_EXPORT
 StucErr stucMapFileLoadInit(
@@ -506,6 +715,24 @@ StucErr stucDestroyBlendOptArr(
 	StucContext pCtx,
 	StucBlendOptArr *pBlendOptArr
 );
+//Cancel token for map-to-mesh calls.
+//Call stucCancelTokenCancel from any thread to stop a call or queued job early.
+//If deadlineMs is non-zero, a call is cancelled once it's been running that long,
+//in which case the token is cancelled by the call itself.
+//A cancelled call frees it's working memory and returns an error with an empty out-mesh.
+//The token mustn't be destroyed while a call using it is running
+STUC_EXPORT
+StucErr stucCancelTokenCreate(
+	StucContext pCtx,
+	StucCancelToken **ppToken,
+	int64_t deadlineMs
+);
+STUC_EXPORT
+void stucCancelTokenCancel(StucCancelToken *pToken);
+STUC_EXPORT
+bool stucCancelTokenIsCancelled(const StucCancelToken *pToken);
+STUC_EXPORT
+StucErr stucCancelTokenDestroy(StucContext pCtx, StucCancelToken *pToken);
 STUC_EXPORT
 StucErr stucQueueMapToMesh(
 	StucContext pCtx,
@@ -517,8 +744,12 @@ StucErr stucQueueMapToMesh(
 	StucAttribIndexedArr *pOutIndexedAttribs,
 	float wScale,
 	float receiveLen,
-	bool triangulate
+	bool triangulate,
+	const StucRoi *pRoi,
+	StucCancelToken *pCancel
 );
+//pRoi may be NULL to map the whole in-mesh, and pCancel may be NULL if the
+//call doesn't need to be cancellable
 STUC_EXPORT
 StucErr stucMapToMesh(
 	StucContext pCtx,
@@ -530,7 +761,27 @@ StucErr stucMapToMesh(
 	float wScale,
 	float receiveLen,
 	bool keepExistingIdxAttribs,
-	bool triangulate
+	bool triangulate,
+	const StucRoi *pRoi,
+	StucCancelToken *pCancel
+);
+//Maps the in-mesh of each entry with the same map arr, as stucMapToMesh would.
+//Runs of consecutive entries which share an attrib layout & in indexed attribs
+//are mapped together, so each mapping stage's jobs span the faces of every mesh
+//in the run. This is cheaper than calling stucMapToMesh per mesh when there are
+//many small meshes.
+//The cancel token & it's deadline apply to the whole batch.
+//If an error is returned, out-meshes which were written must still be destroyed
+STUC_EXPORT
+StucErr stucMapToMeshBatch(
+	StucContext pCtx,
+	const StucMapArr *pMapArr,
+	int32_t entryCount,
+	const StucMapToMeshBatchEntry *pEntries,
+	float wScale,
+	float receiveLen,
+	bool triangulate,
+	StucCancelToken *pCancel
 );
 STUC_EXPORT
 StucErr stucObjArrDestroy(const StucContext pCtx, StucObjArr *pArr);
@@ -662,6 +913,7 @@ STUC_EXPORT
 StucErr stucMeshAttribsCornerToVert(StucContext pCtx, StucMesh *pMesh);
 STUC_EXPORT
 StucErr stucMeshBuildTangentsForTris(StucContext pCtx, StucMesh *pMesh);
+//The edge list and edge attribs are freed, as they don't apply to the new corners
 STUC_EXPORT
 StucErr stucMeshTriangulate(StucContext pCtx, StucMesh *pMesh);
 STUC_EXPORT
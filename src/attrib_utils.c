@@ -1661,10 +1661,8 @@ StucErr stucAllocAttribsFromMeshArr(
 	bool activeOnly
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
-	bool skipEdge = false;
-#ifdef STUC_DISABLE_EDGES_IN_BUF
-	skipEdge = pDest->core.type.type == STUC_OBJECT_DATA_MESH_BUF;
-#endif
+	//edge attribs aren't interpolated, so out-meshes (buf meshes) only carry the edge list
+	bool skipEdge = pDest->core.type.type == STUC_OBJECT_DATA_MESH_BUF;
 	const StucMesh **ppMeshSrcsCore = pCtx->alloc.fpMalloc(sizeof(void *) * srcCount);
 	for (I32 i = 0; i < srcCount; ++i) {
 		ppMeshSrcsCore[i] = &ppMeshSrcs[i]->core;
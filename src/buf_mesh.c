@@ -4,6 +4,7 @@ SPDX-License-Identifier: Apache-2.0
 */
 
 #include <string.h>
+#include <math.h>
 
 #include <poly_cutout.h>
 
@@ -230,22 +231,21 @@ void getInPieceBounds(
 	}
 }
 
-static
-InsideStatus isPointInFaceConvex(
+//pNormals may be NULL, in which case edge normals are computed here
+STUC_FORCE_INLINE
+InsideStatus isPointInFaceConvexIntern(
 	bool wind,
 	I32 faceSize,
 	HalfPlane *pCorners,
+	const V2_F32 *pNormals,
 	V2_F32 point,
 	I32 *pOnCorner
 ) {
 	I32 onEdge[2] = {-1, -1};
 	for (I32 i = 0; i < faceSize; ++i) {
-		InsideStatus status = stucIsPointInHalfPlane(
-			point,
-			pCorners[i].uv,
-			pixmV2F32LineNormal(_(pCorners[(i + 1) % faceSize].uv V2SUB pCorners[i].uv)),
-			wind
-		);
+		V2_F32 normal = pNormals ? pNormals[i] :
+			pixmV2F32LineNormal(_(pCorners[(i + 1) % faceSize].uv V2SUB pCorners[i].uv));
+		InsideStatus status = stucIsPointInHalfPlane(point, pCorners[i].uv, normal, wind);
 		if (status == STUC_INSIDE_STATUS_OUTSIDE) {
 			return STUC_INSIDE_STATUS_OUTSIDE;
 		}
@@ -265,7 +265,18 @@ InsideStatus isPointInFaceConvex(
 	return STUC_INSIDE_STATUS_INSIDE;
 }
 
-static
+STUC_FORCE_INLINE
+InsideStatus isPointInFaceConvex(
+	bool wind,
+	I32 faceSize,
+	HalfPlane *pCorners,
+	V2_F32 point,
+	I32 *pOnCorner
+) {
+	return isPointInFaceConvexIntern(wind, faceSize, pCorners, NULL, point, pOnCorner);
+}
+
+STUC_FORCE_INLINE
 bool isQuadConcave(
 	bool wind,
 	I32 faceSize,
@@ -323,7 +334,7 @@ InsideStatus testQuadAsTri(
 	}
 }
 
-static
+STUC_FORCE_INLINE
 InsideStatus isPointInFace(
 	bool wind,
 	I32 faceSize,
@@ -347,6 +358,57 @@ InsideStatus isPointInFace(
 	return isPointInFaceConvex(wind, faceSize, pCorners, point, pOnCorner);
 }
 
+//fixed size variants, used if all in-faces are tris or quads.
+//Tris are always convex, so no concave check is needed
+static
+InsideStatus isPointInTri(bool wind, HalfPlane *pCorners, V2_F32 point, I32 *pOnCorner) {
+	return isPointInFaceConvex(wind, 3, pCorners, point, pOnCorner);
+}
+
+//edge normals are computed once, and shared by the concave check & the point test.
+//Loop bounds are constant, so they're unrolled
+static
+InsideStatus isPointInQuad(bool wind, HalfPlane *pCorners, V2_F32 point, I32 *pOnCorner) {
+	V2_F32 normals[4] = {0};
+	for (I32 i = 0; i < 4; ++i) {
+		normals[i] = pixmV2F32LineNormal(_(pCorners[(i + 1) % 4].uv V2SUB pCorners[i].uv));
+	}
+	for (I32 i = 0; i < 4; ++i) {
+		InsideStatus status =
+			stucIsPointInHalfPlane(pCorners[(i + 2) % 4].uv, pCorners[i].uv, normals[i], wind);
+		if (status == STUC_INSIDE_STATUS_INSIDE) {
+			continue;
+		}
+		//concave, same as isPointInFace
+		I32 corner = (i + 1) % 4;
+		status = testQuadAsTri(corner, wind, pCorners, point, pOnCorner);
+		if (status == STUC_INSIDE_STATUS_INSIDE) {
+			return STUC_INSIDE_STATUS_INSIDE;
+		}
+		return testQuadAsTri((corner + 2) % 4, wind, pCorners, point, pOnCorner);
+	}
+	return isPointInFaceConvexIntern(wind, 4, pCorners, normals, point, pOnCorner);
+}
+
+static
+InsideStatus isPointInInFace(
+	const MapToMeshBasic *pBasic,
+	bool wind,
+	I32 faceSize,
+	HalfPlane *pCorners,
+	V2_F32 point,
+	I32 *pOnCorner
+) {
+	switch (pBasic->inFaceSize) {
+		case 3:
+			return isPointInTri(wind, pCorners, point, pOnCorner);
+		case 4:
+			return isPointInQuad(wind, pCorners, point, pOnCorner);
+		default:
+			return isPointInFace(wind, faceSize, pCorners, point, pOnCorner);
+	}
+}
+
 static
 InsideStatus getFaceEncasingVert(
 	const MapToMeshBasic *pBasic,
@@ -373,7 +435,8 @@ InsideStatus getFaceEncasingVert(
 		}
 		HalfPlane *pInCornerCache =
 			getInCornerCache(pBasic, pHalfPlaneAlc, pInPiece, pInFaceEntry);
-		InsideStatus status = isPointInFace(
+		InsideStatus status = isPointInInFace(
+			pBasic,
 			pInFaces->pArr[i].wind,
 			pInFaceEntry->face.size,
 			pInCornerCache,
@@ -1005,6 +1068,223 @@ V3_F32 getMapCornerPos(
 	return stucGetVertPos(pMesh, pMapFace, corner);
 }
 
+typedef struct ClipCacheKey {
+	I32 *pArr;
+	I32 size;
+	I32 count;
+} ClipCacheKey;
+
+typedef struct ClipCacheEntry {
+	PixuctHTableEntryCore core;
+	I32 *pKey;
+	I32 keySize;
+	PlycutFaceArr faces;
+	PlycutCorner *pCorners;
+} ClipCacheEntry;
+
+//shared by every job in the stage. Entries are never modified once added,
+//so a hit's faces can be read after the mutex is released
+typedef struct ClipCache {
+	PixuctHTable table;
+	void *pMutex;
+	StucContext pCtx;
+	bool init;
+} ClipCache;
+
+//per job, the key's rebuilt for each piece
+typedef struct ClipCacheJob {
+	ClipCache *pCache;
+	ClipCacheKey key;
+} ClipCacheJob;
+
+static
+void clipCacheKeyAdd(const StucAlloc *pAlloc, ClipCacheKey *pKey, I32 value) {
+	I32 newIdx = -1;
+	PIXALC_DYN_ARR_ADD(I32, pAlloc, pKey, newIdx);
+	pKey->pArr[newIdx] = value;
+}
+
+//tile-relative border positions are snapped to a grid of this many steps per unit.
+//Subtracting different tile offsets changes the low bits of a position, so exact
+//bits won't match across tiles. At 2^16, the grid's coarser than that rounding error
+//for tiles within +-128 of the origin
+#define CLIP_CACHE_SNAP 65536.0f
+
+//plycut output only references border corners by index, and map corners by
+//map-face-local index, so it depends solely on the map face & border positions.
+//Pieces with the same key can therefore share a clip result.
+//As positions are snapped, shapes that differ by less than a grid step can share
+//a key, in which case the first clipped piece's output is replayed.
+//A position near a step boundary may still snap differently per tile,
+//which only costs a miss
+static
+void clipCacheKeyBuild(
+	const MapToMeshBasic *pBasic,
+	const InPiece *pInPiece,
+	const BorderCache *pBorderCache,
+	ClipCacheJob *pJob
+) {
+	const StucAlloc *pAlloc = &pBasic->pCtx->alloc;
+	ClipCacheKey *pKey = &pJob->key;
+	pKey->count = 0;
+	clipCacheKeyAdd(pAlloc, pKey, pInPiece->pList->mapFace);
+	clipCacheKeyAdd(pAlloc, pKey, pInPiece->borderArr.count);
+	for (I32 i = 0; i < pInPiece->borderArr.count; ++i) {
+		clipCacheKeyAdd(pAlloc, pKey, pInPiece->borderArr.pArr[i].len);
+	}
+	PlycutInput input = {0};
+	for (I32 i = 0; i < pInPiece->borderArr.count; ++i) {
+		for (I32 j = 0; j < pInPiece->borderArr.pArr[i].len; ++j) {
+			V2_F32 pos = getBorderCornerPos(pBasic, pBorderCache, input, i, j, NULL);
+			clipCacheKeyAdd(pAlloc, pKey, (I32)roundf(pos.d[0] * CLIP_CACHE_SNAP));
+			clipCacheKeyAdd(pAlloc, pKey, (I32)roundf(pos.d[1] * CLIP_CACHE_SNAP));
+		}
+	}
+}
+
+static
+PixuctKey clipCacheMakeKey(const void *pKeyData) {
+	const ClipCacheKey *pKey = pKeyData;
+	return (PixuctKey){.pKey = pKey->pArr, .size = pKey->count * sizeof(I32)};
+}
+
+static
+void clipCacheEntryInit(
+	void *pUserData,
+	PixuctHTableEntryCore *pEntryCore,
+	const void *pKeyData,
+	void *pInitInfo,
+	I32 linIdx
+) {
+	const ClipCache *pCache = pUserData;
+	const StucAlloc *pAlloc = &pCache->pCtx->alloc;
+	const ClipCacheKey *pKey = pKeyData;
+	const PlycutFaceArr *pFaces = pInitInfo;
+	ClipCacheEntry *pEntry = (ClipCacheEntry *)pEntryCore;
+	*pEntry = (ClipCacheEntry){.core = pEntry->core, .keySize = pKey->count};
+	pEntry->pKey = pAlloc->fpMalloc(pKey->count * sizeof(I32));
+	memcpy(pEntry->pKey, pKey->pArr, pKey->count * sizeof(I32));
+	if (!pFaces->count) {
+		return;
+	}
+	//plycut corners live in the per-job plycut allocator, so they're deep copied
+	//into a single block, with pNext re-linked within it
+	I32 cornerCount = 0;
+	for (I32 i = 0; i < pFaces->count; ++i) {
+		cornerCount += pFaces->pArr[i].size;
+	}
+	pEntry->faces.pArr = pAlloc->fpMalloc(pFaces->count * sizeof(PlycutFaceRoot));
+	pEntry->faces.count = pFaces->count;
+	pEntry->pCorners = pAlloc->fpMalloc(cornerCount * sizeof(PlycutCorner));
+	I32 cornerIdx = 0;
+	for (I32 i = 0; i < pFaces->count; ++i) {
+		pEntry->faces.pArr[i] = pFaces->pArr[i];
+		pEntry->faces.pArr[i].pRoot = pEntry->pCorners + cornerIdx;
+		const PlycutCorner *pCorner = pFaces->pArr[i].pRoot;
+		for (I32 j = 0; pCorner; ++j, pCorner = pCorner->pNext) {
+			PIX_ERR_ASSERT("", j < pFaces->pArr[i].size);
+			PlycutCorner *pCopy = pEntry->pCorners + cornerIdx;
+			*pCopy = *pCorner;
+			pCopy->pNext = pCorner->pNext ? pCopy + 1 : NULL;
+			++cornerIdx;
+		}
+	}
+}
+
+static
+bool clipCacheEntryCmp(
+	const PixuctHTableEntryCore *pEntryCore,
+	const void *pKeyData,
+	const void *pInitInfo
+) {
+	const ClipCacheEntry *pEntry = (ClipCacheEntry *)pEntryCore;
+	const ClipCacheKey *pKey = pKeyData;
+	return
+		pEntry->keySize == pKey->count &&
+		!memcmp(pEntry->pKey, pKey->pArr, pKey->count * sizeof(I32));
+}
+
+static
+void clipCacheInit(StucContext pCtx, ClipCache *pCache, I32 pieceCount) {
+	pCache->pCtx = pCtx;
+	pixuctHTableInit(
+		&pCtx->alloc,
+		&pCache->table,
+		pieceCount / 4 + 1,
+		(I32Arr) {.pArr = (I32[]) {sizeof(ClipCacheEntry)}, .count = 1},
+		NULL,
+		pCache,
+		true
+	);
+	pCtx->threadPool.fpMutexGet(pCtx->pThreadPoolHandle, &pCache->pMutex);
+	pCache->init = true;
+}
+
+static
+void clipCacheDestroy(ClipCache *pCache) {
+	if (!pCache->init) {
+		return;
+	}
+	StucContext pCtx = pCache->pCtx;
+	PixalcLinAlloc *pTableAlloc = pixuctHTableAllocGet(&pCache->table, 0);
+	PixalcLinAllocIter iter = {0};
+	pixalcLinAllocIterInit(pTableAlloc, (Range) { 0, INT32_MAX }, &iter);
+	for (; !pixalcLinAllocIterAtEnd(&iter); pixalcLinAllocIterInc(&iter)) {
+		ClipCacheEntry *pEntry = pixalcLinAllocGetItem(&iter);
+		pCtx->alloc.fpFree(pEntry->pKey);
+		if (pEntry->faces.pArr) {
+			pCtx->alloc.fpFree(pEntry->faces.pArr);
+			pCtx->alloc.fpFree(pEntry->pCorners);
+		}
+	}
+	pixuctHTableDestroy(&pCache->table);
+	pCtx->threadPool.fpMutexDestroy(pCtx->pThreadPoolHandle, pCache->pMutex);
+	*pCache = (ClipCache){0};
+}
+
+//outputs the cached clip result for the job's key, if there is one
+static
+bool clipCacheFind(ClipCacheJob *pJob, PlycutFaceArr *pFaces) {
+	ClipCache *pCache = pJob->pCache;
+	StucContext pCtx = pCache->pCtx;
+	ClipCacheEntry *pEntry = NULL;
+	pCtx->threadPool.fpMutexLock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	SearchResult result = pixuctHTableGet(
+		&pCache->table,
+		0,
+		&pJob->key,
+		(void **)&pEntry,
+		false,
+		NULL,
+		clipCacheMakeKey, NULL, NULL, clipCacheEntryCmp
+	);
+	bool found = result == PIX_SEARCH_FOUND;
+	if (found) {
+		*pFaces = pEntry->faces;
+	}
+	pCtx->threadPool.fpMutexUnlock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	return found;
+}
+
+//if another job's added the same key in the meantime, its entry is kept
+static
+void clipCacheAdd(ClipCacheJob *pJob, PlycutFaceArr *pFaces) {
+	ClipCache *pCache = pJob->pCache;
+	StucContext pCtx = pCache->pCtx;
+	ClipCacheEntry *pEntry = NULL;
+	pCtx->threadPool.fpMutexLock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	pixuctHTableGet(
+		&pCache->table,
+		0,
+		&pJob->key,
+		(void **)&pEntry,
+		true,
+		pFaces,
+		clipCacheMakeKey, NULL, clipCacheEntryInit, clipCacheEntryCmp
+	);
+	pCtx->threadPool.fpMutexUnlock(pCtx->pThreadPoolHandle, pCache->pMutex);
+}
+
 StucErr stucClipMapFace(
 	const MapToMeshBasic *pBasic,
 	I32 inPieceOffset,
@@ -1012,7 +1292,8 @@ StucErr stucClipMapFace(
 	BufMesh *pBufMesh,
 	BorderCache *pBorderCache,
 	void *pHTableAlc,
-	void *pPlycutAlc
+	void *pPlycutAlc,
+	void *pClipCache
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	FaceRange mapFace = 
@@ -1036,6 +1317,28 @@ StucErr stucClipMapFace(
 
 	borderCacheInit(pBasic, pInPiece, &inFaceCache, pBorderCache);
 
+	ClipCacheJob *pCacheJob = pClipCache;
+	if (pCacheJob) {
+		clipCacheKeyBuild(pBasic, pInPiece, pBorderCache, pCacheJob);
+		PlycutFaceArr cached = {0};
+		if (clipCacheFind(pCacheJob, &cached)) {
+			if (cached.count) {
+				addFacesToBufMesh(
+					pBasic,
+					pBorderCache,
+					inPieceOffset,
+					pInPiece,
+					pBufMesh,
+					&inFaceCache,
+					&mapFace,
+					&cached
+				);
+			}
+			inFaceCacheDestroy(pBasic, &inFaceCache);
+			return err;
+		}
+	}
+
 	PlycutInput inInput = {.boundaries = pInPiece->borderArr.count};
 	inInput.pSizes = pBasic->pCtx->alloc.fpMalloc(inInput.boundaries * sizeof(I32));
 	for (I32 i = 0; i < inInput.boundaries; ++i) {
@@ -1064,6 +1367,9 @@ StucErr stucClipMapFace(
 			&out
 		);
 	}
+	if (pCacheJob) {
+		clipCacheAdd(pCacheJob, &out);
+	}
 	PIX_ERR_CATCH(0, err, 
 		err = PIX_ERR_SUCCESS; //skipping this face, reset err
 	);
@@ -1079,7 +1385,8 @@ StucErr stucAddMapFaceToBufMesh(
 	BufMesh *pBufMesh,
 	BorderCache *pBorderCache,
 	void *pHTableAlc,
-	void *pPlycutAlc //unused, needed for function callback
+	void *pPlycutAlc, //unused, needed for function callback
+	void *pClipCache //unused
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 
@@ -1123,9 +1430,11 @@ typedef struct BufMeshInitJobArgs {
 		BufMesh *,
 		BorderCache *,
 		void *,
+		void *,
 		void *
 	);
 	const InPieceArr *pInPiecesSplit;
+	ClipCache *pClipCache;
 	BufMesh bufMesh;
 } BufMeshInitJobArgs;
 
@@ -1139,8 +1448,11 @@ StucErr stucBufMeshInit(void *pArgsVoid) {
 	const MapToMeshBasic *pBasic = (const MapToMeshBasic *)pArgs->core.pShared;
 	PixuctHTableMem hTableAlc = {0};
 	PlycutMem plycutAlc = {0};
+	ClipCacheJob clipCacheJob = {.pCache = pArgs->pClipCache};
 	for (I32 i = 0; i < rangeSize; ++i) {
 		I32 inPieceIdx = pArgs->core.range.start + i;
+		err = stucJobCancelCheckAt(pBasic->pCancel, inPieceIdx, pArgs->core.range);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
 		pArgs->fpAddPiece(
 			pBasic,
 			inPieceIdx,
@@ -1148,9 +1460,14 @@ StucErr stucBufMeshInit(void *pArgsVoid) {
 			&pArgs->bufMesh,
 			&borderCache,
 			&hTableAlc,
-			&plycutAlc
+			&plycutAlc,
+			clipCacheJob.pCache ? &clipCacheJob : NULL
 		);
 	}
+	PIX_ERR_CATCH(0, err, ;);
+	if (clipCacheJob.key.pArr) {
+		pBasic->pCtx->alloc.fpFree(clipCacheJob.key.pArr);
+	}
 	pixuctHTableMemDestroy(&hTableAlc);
 	plycutMemDestroy(&plycutAlc);
 	const StucAlloc *pAlloc = &pBasic->pCtx->alloc;
@@ -1221,8 +1538,10 @@ typedef struct BufMeshJobInitInfo {
 		BufMesh *,
 		BorderCache *,
 		void *,
+		void *,
 		void *
 	);
+	ClipCache *pClipCache;
 } BufMeshJobInitInfo;
 
 static
@@ -1236,6 +1555,7 @@ void bufMeshInitJobInit(StucContext pCtx, void *pShared, void *pInitInfoVoid, vo
 	BufMeshJobInitInfo *pInitInfo = pInitInfoVoid;
 	pEntry->pInPiecesSplit = pInitInfo->pInPiecesSplit;
 	pEntry->fpAddPiece = pInitInfo->fpAddPiece;
+	pEntry->pClipCache = pInitInfo->pClipCache;
 }
 
 
@@ -1262,23 +1582,35 @@ StucErr stucInPieceArrInitBufMeshes(
 		BufMesh *,
 		BorderCache *,
 		void *,
+		void *,
 		void *
 	)
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
+	//shared across jobs, so pieces with the same clip input are reused
+	//regardless of which job they land in
+	ClipCache clipCache = {0};
+	if (pBasic->pCtx->clipCache && fpAddPiece == stucClipMapFace) {
+		clipCacheInit(pBasic->pCtx, &clipCache, pInPieces->count);
+	}
 	I32 jobCount = 0;
 	BufMeshInitJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
 	stucMakeJobArgs(
 		pBasic->pCtx,
 		pBasic,
 		&jobCount, jobArgs, sizeof(BufMeshInitJobArgs),
-		&(BufMeshJobInitInfo) {.pInPiecesSplit = pInPieces, .fpAddPiece = fpAddPiece},
+		&(BufMeshJobInitInfo) {
+			.pInPiecesSplit = pInPieces,
+			.fpAddPiece = fpAddPiece,
+			.pClipCache = clipCache.init ? &clipCache : NULL
+		},
 		bufMeshInitJobsGetRange, bufMeshInitJobInit);
 	err = stucDoJobInParallel(
 		pBasic->pCtx,
 		jobCount, jobArgs, sizeof(BufMeshInitJobArgs),
 		stucBufMeshInit
 	);
+	clipCacheDestroy(&clipCache);
 	PIX_ERR_RETURN_IFNOT(err, "");
 	bufMeshArrMoveToInPieces(pInPieces, jobArgs, jobCount);
 	return err;
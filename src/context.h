@@ -12,11 +12,14 @@ typedef struct StucContextInternal {
 	StucThreadPool threadPool;
 	StucAlloc alloc;
 	StucIo io;
+	StucCodec codecs[STUC_CODEC_MAX];
 	void *pThreadPoolHandle;
 	I32 threadCount;
 	StucTypeDefaultConfig typeDefaults;
 	StucStageReport stageReport;
 	I32 stageInterval;
+	bool clipCache;
+	struct InMeshCache *pInMeshCache;
 	//these are used only for special attribs
 	// (ie, active attributes which are aliased internally for quick access).
 	//Non active attribs, or active attributes outside the special range, are not limited
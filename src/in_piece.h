@@ -263,7 +263,8 @@ StucErr stucClipMapFace(
 	BufMesh *pBufMesh,
 	BorderCache *pBorderCache,
 	void *pHTableAlc,
-	void *pPlycutAlc
+	void *pPlycutAlc,
+	void *pClipCache
 );
 StucErr stucAddMapFaceToBufMesh(
 	const struct MapToMeshBasic *pBasic,
@@ -272,7 +273,8 @@ StucErr stucAddMapFaceToBufMesh(
 	BufMesh *pBufMesh,
 	BorderCache *pBorderCache,
 	void *pHTableAlc,
-	void *pPlycutAlc
+	void *pPlycutAlc,
+	void *pClipCache
 );
 StucErr stucBufMeshInit(void *pArgsVoid);
 StucErr stucInPieceArrInit(
@@ -291,6 +293,7 @@ StucErr stucInPieceArrInitBufMeshes(
 		BufMesh *,
 		BorderCache *,
 		void *,
+		void *,
 		void *
 	)
 );
@@ -205,6 +205,184 @@ V3_F32 getMapCornerPos(
 	return stucGetVertPos(pMesh, pMapFace, corner);
 }
 
+STUC_FORCE_INLINE
+void projectFaceOntoAxis(
+	const V2_F32 *pVerts,
+	I32 size,
+	V2_F32 axis,
+	F32 *pMin,
+	F32 *pMax
+) {
+	*pMin = *pMax = _(pVerts[0] V2DOT axis);
+	for (I32 i = 1; i < size; ++i) {
+		F32 proj = _(pVerts[i] V2DOT axis);
+		if (proj < *pMin) {
+			*pMin = proj;
+		}
+		else if (proj > *pMax) {
+			*pMax = proj;
+		}
+	}
+}
+
+//tests edge normals of face a against face b.
+//A separating axis proves the faces don't overlap, even if one is concave.
+//Faces that only touch aren't considered separate, they're left to plycut
+STUC_FORCE_INLINE
+bool doesFaceHaveSeparatingAxis(
+	const V2_F32 *pVertsA, I32 sizeA,
+	const V2_F32 *pVertsB, I32 sizeB
+) {
+	for (I32 i = 0; i < sizeA; ++i) {
+		I32 iNext = (i + 1) % sizeA;
+		V2_F32 axis = pixmV2F32LineNormal(_(pVertsA[iNext] V2SUB pVertsA[i]));
+		F32 minA = .0f;
+		F32 maxA = .0f;
+		F32 minB = .0f;
+		F32 maxB = .0f;
+		projectFaceOntoAxis(pVertsA, sizeA, axis, &minA, &maxA);
+		projectFaceOntoAxis(pVertsB, sizeB, axis, &minB, &maxB);
+		if (maxA < minB || maxB < minA) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//returns 1 or -1 depending on wind if convex, or 0 if concave or degenerate.
+//Only tris and quads are checked, as a consistent turn direction
+//doesn't guarantee convexity for larger ngons (eg, a pentagram)
+STUC_FORCE_INLINE
+I32 getConvexFaceWind(const V2_F32 *pVerts, I32 size) {
+	if (size > 4) {
+		return 0;
+	}
+	I32 wind = 0;
+	for (I32 i = 0; i < size; ++i) {
+		I32 iNext = (i + 1) % size;
+		I32 iNextNext = (i + 2) % size;
+		V2_F32 edge = _(pVerts[iNext] V2SUB pVerts[i]);
+		V2_F32 edgeNext = _(pVerts[iNextNext] V2SUB pVerts[iNext]);
+		F32 turn = _(edge V2DET edgeNext);
+		I32 turnWind = (turn > .0f) - (turn < .0f);
+		if (!turnWind || (wind && turnWind != wind)) {
+			return 0;
+		}
+		wind = turnWind;
+	}
+	return wind;
+}
+
+//points on an edge don't count as inside
+STUC_FORCE_INLINE
+bool areVertsInsideConvexFace(
+	const V2_F32 *pFace, I32 faceSize, I32 faceWind,
+	const V2_F32 *pVerts, I32 vertCount
+) {
+	for (I32 i = 0; i < faceSize; ++i) {
+		I32 iNext = (i + 1) % faceSize;
+		V2_F32 edge = _(pFace[iNext] V2SUB pFace[i]);
+		for (I32 j = 0; j < vertCount; ++j) {
+			F32 side = _(edge V2DET _(pVerts[j] V2SUB pFace[i])) * (F32)faceWind;
+			if (side <= .0f) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//cheap tests to avoid running plycut on faces that clearly don't straddle an edge.
+//Returns STUC_FACE_OVERLAP_INTERSECT if undetermined
+STUC_FORCE_INLINE
+OverlapType classifyFaceOverlapIntern(
+	const HalfPlane *pInCorners, I32 inSize,
+	const Mesh *pMapMesh, const FaceRange *pMapFace, I32 mapSize
+) {
+	PIX_ERR_ASSERT("", inSize <= 4 && mapSize <= STUC_NGON_MAX_SIZE);
+	V2_F32 inVerts[4] = {0};
+	for (I32 i = 0; i < inSize; ++i) {
+		inVerts[i] = pInCorners[i].uv;
+	}
+	V2_F32 mapVerts[STUC_NGON_MAX_SIZE];
+	for (I32 i = 0; i < mapSize; ++i) {
+		mapVerts[i] = stucVertPosXy(pMapMesh, pMapFace, i);
+	}
+	if (doesFaceHaveSeparatingAxis(inVerts, inSize, mapVerts, mapSize) ||
+		doesFaceHaveSeparatingAxis(mapVerts, mapSize, inVerts, inSize)
+	) {
+		return STUC_FACE_OVERLAP_NONE;
+	}
+	I32 inWind = getConvexFaceWind(inVerts, inSize);
+	if (inWind && areVertsInsideConvexFace(inVerts, inSize, inWind, mapVerts, mapSize)) {
+		return STUC_FACE_OVERLAP_MAP_INSIDE_IN;
+	}
+	I32 mapWind = getConvexFaceWind(mapVerts, mapSize);
+	if (mapWind && areVertsInsideConvexFace(mapVerts, mapSize, mapWind, inVerts, inSize)) {
+		return STUC_FACE_OVERLAP_IN_INSIDE_MAP;
+	}
+	return STUC_FACE_OVERLAP_INTERSECT;
+}
+
+//fixed size variants, used if all in and map faces are tris or quads
+static
+OverlapType classifyFaceOverlapTriTri(
+	const HalfPlane *pInCorners,
+	const Mesh *pMapMesh, const FaceRange *pMapFace
+) {
+	return classifyFaceOverlapIntern(pInCorners, 3, pMapMesh, pMapFace, 3);
+}
+
+static
+OverlapType classifyFaceOverlapTriQuad(
+	const HalfPlane *pInCorners,
+	const Mesh *pMapMesh, const FaceRange *pMapFace
+) {
+	return classifyFaceOverlapIntern(pInCorners, 3, pMapMesh, pMapFace, 4);
+}
+
+static
+OverlapType classifyFaceOverlapQuadTri(
+	const HalfPlane *pInCorners,
+	const Mesh *pMapMesh, const FaceRange *pMapFace
+) {
+	return classifyFaceOverlapIntern(pInCorners, 4, pMapMesh, pMapFace, 3);
+}
+
+static
+OverlapType classifyFaceOverlapQuadQuad(
+	const HalfPlane *pInCorners,
+	const Mesh *pMapMesh, const FaceRange *pMapFace
+) {
+	return classifyFaceOverlapIntern(pInCorners, 4, pMapMesh, pMapFace, 4);
+}
+
+static
+OverlapType classifyFaceOverlap(
+	const MapToMeshBasic *pBasic,
+	const HalfPlane *pInCorners, const FaceRange *pInFace,
+	const Mesh *pMapMesh, const FaceRange *pMapFace
+) {
+	I32 inSize = pBasic->inFaceSize;
+	I32 mapSize = pMapMesh->uniformFaceSize;
+	if (inSize == 3 && mapSize == 3) {
+		return classifyFaceOverlapTriTri(pInCorners, pMapMesh, pMapFace);
+	}
+	else if (inSize == 3 && mapSize == 4) {
+		return classifyFaceOverlapTriQuad(pInCorners, pMapMesh, pMapFace);
+	}
+	else if (inSize == 4 && mapSize == 3) {
+		return classifyFaceOverlapQuadTri(pInCorners, pMapMesh, pMapFace);
+	}
+	else if (inSize == 4 && mapSize == 4) {
+		return classifyFaceOverlapQuadQuad(pInCorners, pMapMesh, pMapFace);
+	}
+	return classifyFaceOverlapIntern(
+		pInCorners, pInFace->size,
+		pMapMesh, pMapFace, pMapFace->size
+	);
+}
+
 static
 OverlapType doInAndMapFacesOverlap(
 	const MapToMeshBasic *pBasic,
@@ -212,6 +390,11 @@ OverlapType doInAndMapFacesOverlap(
 	const Mesh *pMapMesh, FaceRange *pMapFace,
 	PlycutMem *pPlycutAlc
 ) {
+	OverlapType overlap =
+		classifyFaceOverlap(pBasic, pInCorners, pInFace, pMapMesh, pMapFace);
+	if (overlap != STUC_FACE_OVERLAP_INTERSECT) {
+		return overlap;
+	}
 	PlycutInput inInput =
 		{.pSizes = &pInFace->size, .boundaries = 1, .pUserData = pInFace};
 	PlycutInput mapInput =
@@ -334,11 +517,16 @@ StucErr getEncasedFaces(FindEncasedFacesJobArgs *pArgs, FaceCellsTable *pFaceCel
 	const MapToMeshBasic *pBasic = pArgs->core.pShared;
 	PlycutMem plycutAlc = {0};
 	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		err = stucJobCancelCheckAt(pBasic->pCancel, i, pArgs->core.range);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
 		if (pBasic->maskIdx != -1 && pBasic->pInMesh->pMatIdx &&
 		    pBasic->pInMesh->pMatIdx[i] != pBasic->maskIdx) {
 
 			continue;
 		}
+		if (!stucIsFaceInRoi(pBasic->pInMesh, i)) {
+			continue;
+		}
 		FaceRange inFace = {0};
 		inFace.start = pBasic->pInMesh->core.pFaces[i];
 		inFace.end = pBasic->pInMesh->core.pFaces[i + 1];
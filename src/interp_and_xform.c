@@ -48,7 +48,12 @@ UsgInFace *findUsgForMapCorners(
 		}
 		usgIdx = abs(usgIdx) - 1;
 		*ppUsg = pMap->usgArr.pArr + usgIdx;
-		if (stucIsPointInsideMesh(&pBasic->pCtx->alloc, mapUvw, (*ppUsg)->pMesh)) {
+		if (stucIsPointInsideMesh(
+			&pBasic->pCtx->alloc,
+			mapUvw,
+			(*ppUsg)->pMesh,
+			&(*ppUsg)->bvh
+		)) {
 			//passing NULL for above cutoff,
 			// we don't need to know cause using flatcutoff eitherway here
 			UsgInFace *pUsgEntry = stucGetUsgForCorner(
@@ -94,9 +99,12 @@ void getUsgEntry(
 		);
 		if (*ppUsgEntry) {
 			PIX_ERR_ASSERT("", pUsg);
-			bool insideUsg =
-				stucIsPointInsideMesh(&pBasic->pCtx->alloc, mapUvw, pUsg->pFlatCutoff);
-			*pAboveCutoff = pUsg->pFlatCutoff && insideUsg;
+			*pAboveCutoff = pUsg->pFlatCutoff && stucIsPointInsideMesh(
+				&pBasic->pCtx->alloc,
+				mapUvw,
+				pUsg->pFlatCutoff,
+				&pUsg->cutoffBvh
+			);
 		}
 	}
 }
@@ -164,6 +172,13 @@ StucErr getInterpolatedTbn(
 		STUC_ATTRIB_USE_NORMAL
 	);
 	PIX_ERR_RETURN_IFNOT(err, "");
+	*(V3_F32 *)&pTbn->d[2] = normal;
+	if (!pBasic->needsTbn) {
+		//in-mesh tangents weren't built, as the map has no normals to xform
+		*(V3_F32 *)&pTbn->d[0] = (V3_F32){0};
+		*(V3_F32 *)&pTbn->d[1] = (V3_F32){0};
+		return err;
+	}
 	err = interpActiveAttrib(
 		pBasic,
 		pInPiece,
@@ -523,8 +538,19 @@ void interpAndBlendAttribs(
 	}
 }
 
+//map normals are in tangent space. If the map has none, out normals come from
+//the in-mesh, are already in world space, and are left as is
 static
-void xformNormals(StucMesh *pMesh, I32 idx, const M3x3 *pTbn, StucDomain domain) {
+void xformNormals(
+	const MapToMeshBasic *pBasic,
+	StucMesh *pMesh,
+	I32 idx,
+	const M3x3 *pTbn,
+	StucDomain domain
+) {
+	if (!pBasic->needsTbn) {
+		return;
+	}
 	AttribArray *pAttribArr = stucGetAttribArrFromDomain(pMesh, domain);
 	for (I32 i = 0; i < pAttribArr->count; ++i) {
 		Attrib *pAttrib = pAttribArr->pArr + i;
@@ -547,7 +573,10 @@ StucErr xformAndInterpVertsInRange(void *pArgsVoid) {
 	const MapToMeshBasic *pBasic = pArgs->core.pShared;
 	PixalcLinAllocIter iter = {0};
 	pixalcLinAllocIterInit(pArgs->pVertAlloc, pArgs->core.range, &iter);
+	I32 itemIdx = pArgs->core.range.start;
 	for (; !pixalcLinAllocIterAtEnd(&iter); pixalcLinAllocIterInc(&iter)) {
+		err = stucJobCancelCheckAt(pBasic->pCancel, itemIdx++, pArgs->core.range);
+		PIX_ERR_RETURN_IFNOT(err, "");
 		VertMerge *pEntry = pixalcLinAllocGetItem(&iter);
 		PIX_ERR_ASSERT(
 			"",
@@ -595,6 +624,7 @@ StucErr xformAndInterpVertsInRange(void *pArgsVoid) {
 			NULL
 		);
 		xformNormals(
+			pBasic,
 			&pArgs->pOutMesh->core,
 			pEntry->outVert,
 			&pEntry->transform.tbn,
@@ -704,6 +734,8 @@ StucErr stucInterpCornerAttribs(void *pArgsVoid) {
 			corner < pRange->outCorners.end && corner < pArgs->core.range.end;
 			++corner
 		) {
+			err = stucJobCancelCheckAt(pBasic->pCancel, corner, pArgs->core.range);
+			PIX_ERR_RETURN_IFNOT(err, "");
 			const InPiece *pInPiece = NULL;
 			const BufMesh *pBufMesh = NULL;
 			FaceCorner bufCorner = {0};
@@ -724,21 +756,24 @@ StucErr stucInterpCornerAttribs(void *pArgsVoid) {
 				&interpCaches,
 				NULL
 			);
-			M3x3 tbn = {0};
-			getInterpolatedTbn(
-				pBasic,
-				pInPiece,
-				pBufMesh,
-				bufCorner,
-				&interpCaches.in,
-				&tbn
-			);
-			xformNormals(
-				&pArgs->pOutMesh->core,
-				corner,
-				&tbn,
-				STUC_DOMAIN_CORNER
-			);
+			if (pBasic->needsTbn) {
+				M3x3 tbn = {0};
+				getInterpolatedTbn(
+					pBasic,
+					pInPiece,
+					pBufMesh,
+					bufCorner,
+					&interpCaches.in,
+					&tbn
+				);
+				xformNormals(
+					pBasic,
+					&pArgs->pOutMesh->core,
+					corner,
+					&tbn,
+					STUC_DOMAIN_CORNER
+				);
+			}
 			pArgs->pOutMesh->core.pCorners[corner] = pVertEntry->outVert;
 		}
 	}
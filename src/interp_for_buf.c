@@ -79,6 +79,53 @@ void interpCacheUpdateLerpMap(
 	pCache->lerpMap.t = t;
 }
 
+//if every in or map face is a tri or quad, the fixed-size variant's used,
+//so the face size checks are folded out
+static
+V3_F32 getBarycentricInInFace(
+	const MapToMeshBasic *pBasic,
+	const FaceRange *pInFace,
+	V2_I16 tile,
+	I8 *pTri,
+	V2_F32 uv
+) {
+	const Mesh *pMesh = pBasic->pInMesh;
+	switch (pBasic->inFaceSize) {
+		case 3:
+			return stucGetBarycentricInFaceSized(
+				pMesh, pInFace, 3, tile, stucGetUvPosAsV3, pTri, uv
+			);
+		case 4:
+			return stucGetBarycentricInFaceSized(
+				pMesh, pInFace, 4, tile, stucGetUvPosAsV3, pTri, uv
+			);
+		default:
+			return stucGetBarycentricInFaceFromUvs(pMesh, pInFace, tile, pTri, uv);
+	}
+}
+
+static
+V3_F32 getBarycentricInMapFace(
+	const MapToMeshBasic *pBasic,
+	const FaceRange *pMapFace,
+	I8 *pTri,
+	V2_F32 pos
+) {
+	const Mesh *pMesh = pBasic->pMap->pMesh;
+	switch (pMesh->uniformFaceSize) {
+		case 3:
+			return stucGetBarycentricInFaceSized(
+				pMesh, pMapFace, 3, (V2_I16){0}, stucGetVertPos, pTri, pos
+			);
+		case 4:
+			return stucGetBarycentricInFaceSized(
+				pMesh, pMapFace, 4, (V2_I16){0}, stucGetVertPos, pTri, pos
+			);
+		default:
+			return stucGetBarycentricInFaceFromVerts(pMesh, pMapFace, pTri, pos);
+	}
+}
+
 static
 void interpCacheUpdateTriIn(
 	const MapToMeshBasic *pBasic,
@@ -95,13 +142,7 @@ void interpCacheUpdateTriIn(
 		pBasic->pMap->pMesh->core.pCorners[mapFace.start + mapCorner]
 	];
 	I8 tri[3] = {0};
-	pCache->triIn.bc = stucGetBarycentricInFaceFromUvs(
-		pBasic->pInMesh,
-		&inFace,
-		tile,
-		tri,
-		mapVertPos
-	);
+	pCache->triIn.bc = getBarycentricInInFace(pBasic, &inFace, tile, tri, mapVertPos);
 	for (I32 i = 0; i < 3; ++i) {
 		pCache->triIn.triReal[i] = inFace.start + tri[i];
 		if (domain == STUC_DOMAIN_VERT) {
@@ -133,8 +174,7 @@ void interpCacheUpdateTriMap(
 			stucGetBarycentricInTriFromVerts(pBasic->pMap->pMesh, &mapFace, pTri, inUv);
 	}
 	else {
-		pCache->triMap.bc =
-			stucGetBarycentricInFaceFromVerts(pBasic->pMap->pMesh, &mapFace, triBuf, inUv);
+		pCache->triMap.bc = getBarycentricInMapFace(pBasic, &mapFace, triBuf, inUv);
 		pTri = triBuf;
 	}
 	for (I32 i = 0; i < 3; ++i) {
@@ -7,25 +7,39 @@ SPDX-License-Identifier: Apache-2.0
 #define VERT_ATTRIBUTE_AMOUNT 3
 #define LOOP_ATTRIBUTE_AMOUNT 3
 #define ENCODE_DECODE_BUFFER_LENGTH 34
-#define STUC_MAP_VERSION 101
+#define STUC_MAP_VERSION 102
 #define STUC_FLAT_CUTOFF_HEADER_SIZE 56
 #define STUC_WINDOW_BITS 31 //15 (+16 as using gzip)
+#define STUC_STREAM_READ_SIZE (64 * 1024)
+#define STUC_STREAM_WINDOW_SIZE (256 * 1024)
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <limits.h>
+#include <float.h>
+#include <math.h>
 #include <string.h>
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
 
 #include <zlib.h>
 
 #include <pixenals_io_utils.h>
 #include <pixenals_math_utils.h>
 #include <pixenals_error_utils.h>
+#include <pixenals_thread_utils.h>
 
 #include <io.h>
 #include <map.h>
 #include <context.h>
 #include <attrib_utils.h>
+#include <utils.h>
+#include <job.h>
 
 typedef enum DataTag {
 	TAG_NONE,
@@ -52,6 +66,11 @@ typedef enum DataTag {
 	TAG_TYPE_TARGET,
 	TAG_TYPE_USG,
 	TAG_TYPE_USG_FLAT_CUTOFF,
+	TAG_BAKED_TARGET,
+	TAG_TOC,
+	TAG_CHUNKS,
+	TAG_QUANTIZE,
+	TAG_LOD,
 	TAG_ENUM_COUNT
 } DataTag;
 
@@ -83,6 +102,11 @@ typedef enum DataTag {
 #define TAG_STR_TYPE_TARGET           DATA_TAG_KEY('T', 'T')
 #define TAG_STR_TYPE_USG              DATA_TAG_KEY('T', 'U')
 #define TAG_STR_TYPE_USG_FLAT_CUTOFF  DATA_TAG_KEY('T', 'F')
+#define TAG_STR_BAKED_TARGET          DATA_TAG_KEY('B', 'K')
+#define TAG_STR_TOC                   DATA_TAG_KEY('C', 'T')
+#define TAG_STR_CHUNKS                DATA_TAG_KEY('C', 'K')
+#define TAG_STR_QUANTIZE              DATA_TAG_KEY('Q', 'Z')
+#define TAG_STR_LOD                   DATA_TAG_KEY('L', 'D')
 
 #define DATA_TAG_WRAP(key) (key % DATA_TAG_KEY_MAX)
 static const I8 dataTagKeyToTag[DATA_TAG_KEY_MAX] = {
@@ -109,7 +133,12 @@ static const I8 dataTagKeyToTag[DATA_TAG_KEY_MAX] = {
 	[DATA_TAG_WRAP(TAG_STR_TYPE_OBJECT)] = TAG_TYPE_OBJECT,
 	[DATA_TAG_WRAP(TAG_STR_TYPE_TARGET)] = TAG_TYPE_TARGET,
 	[DATA_TAG_WRAP(TAG_STR_TYPE_USG)] = TAG_TYPE_USG,
-	[DATA_TAG_WRAP(TAG_STR_TYPE_USG_FLAT_CUTOFF)] = TAG_TYPE_USG_FLAT_CUTOFF
+	[DATA_TAG_WRAP(TAG_STR_TYPE_USG_FLAT_CUTOFF)] = TAG_TYPE_USG_FLAT_CUTOFF,
+	[DATA_TAG_WRAP(TAG_STR_BAKED_TARGET)] = TAG_BAKED_TARGET,
+	[DATA_TAG_WRAP(TAG_STR_TOC)] = TAG_TOC,
+	[DATA_TAG_WRAP(TAG_STR_CHUNKS)] = TAG_CHUNKS,
+	[DATA_TAG_WRAP(TAG_STR_QUANTIZE)] = TAG_QUANTIZE,
+	[DATA_TAG_WRAP(TAG_STR_LOD)] = TAG_LOD
 };
 
 static const U64 dataTagToKey[TAG_ENUM_COUNT] = {
@@ -136,7 +165,12 @@ static const U64 dataTagToKey[TAG_ENUM_COUNT] = {
 	TAG_STR_TYPE_OBJECT,
 	TAG_STR_TYPE_TARGET,
 	TAG_STR_TYPE_USG,
-	TAG_STR_TYPE_USG_FLAT_CUTOFF
+	TAG_STR_TYPE_USG_FLAT_CUTOFF,
+	TAG_STR_BAKED_TARGET,
+	TAG_STR_TOC,
+	TAG_STR_CHUNKS,
+	TAG_STR_QUANTIZE,
+	TAG_STR_LOD
 };
 
 void stucIoDataTagValidate() {
@@ -198,6 +232,32 @@ void reallocByteStringIfNeeded(
 	}
 }
 
+//grows to fit byteCount more bytes in one go, for sections with a known size
+static
+void byteStringReserve(const StucAlloc *pAlloc, ByteString *pByteString, I64 byteCount) {
+	//+1 for any partially written byte
+	I64 needed = pByteString->byteIdx + 1 + byteCount;
+	if (needed <= pByteString->size) {
+		return;
+	}
+	I64 oldSize = pByteString->size;
+	pByteString->size = PIXM_MAX(pByteString->size * 2, needed);
+	pByteString->pString = pAlloc->fpRealloc(pByteString->pString, pByteString->size);
+	memset(pByteString->pString + oldSize, 0, pByteString->size - oldSize);
+}
+
+//for byte aligned data, where values can be copied as is
+static
+void encodeBytes(const StucAlloc *pAlloc, ByteString *pData, const void *pSrc, I64 size) {
+	PIX_ERR_ASSERT("", !pData->nextBitIdx);
+	if (!size) {
+		return;
+	}
+	byteStringReserve(pAlloc, pData, size);
+	memcpy(pData->pString + pData->byteIdx, pSrc, size);
+	pData->byteIdx += size;
+}
+
 static
 I32 getByteLen(I32 bitLen) {
 	I32 byteLen = bitLen / 8;
@@ -205,654 +265,2778 @@ I32 getByteLen(I32 bitLen) {
 	return byteLen;
 }
 
-//TODO move these funcs to pixio lib and make U8 *pValue void * instead,
-//having to cast every call is tedious
-void stucEncodeValue(
+static
+StucErr storeCompress(
 	const StucAlloc *pAlloc,
-	ByteString *pByteString,
-	U8 *pValue,
-	I32 bitLen
+	const U8 *pIn,
+	I64 inSize,
+	U8 **ppOut,
+	I64 *pOutSize
 ) {
-	reallocByteStringIfNeeded(pAlloc, pByteString, bitLen);
-	U8 *pStart = pByteString->pString + pByteString->byteIdx;
-
-	I32 byteLen = getByteLen(bitLen);
-	I32 strByteLen = getByteLen(bitLen + pByteString->nextBitIdx);
-	pStart[0] |= pValue[0] << pByteString->nextBitIdx;
-	for (I32 i = 1; i < strByteLen; ++i) {
-		pStart[i] = i == byteLen ? 0x0 : pValue[i] << pByteString->nextBitIdx;
-		U8 nextByte = pValue[i - 1];
-		nextByte >>= 8 - pByteString->nextBitIdx;
-		pStart[i] |= nextByte;
-	}
-	pByteString->nextBitIdx = pByteString->nextBitIdx + bitLen;
-	pByteString->byteIdx += pByteString->nextBitIdx / 8;
-	pByteString->nextBitIdx %= 8;
+	*ppOut = pAlloc->fpMalloc(PIXM_MAX(inSize, 1));
+	memcpy(*ppOut, pIn, inSize);
+	*pOutSize = inSize;
+	return PIX_ERR_SUCCESS;
 }
 
-void stucEncodeString(const StucAlloc *pAlloc, ByteString *pByteString, const char *pString) {
-	I32 lengthInBits = ((I32)strlen(pString) + 1) * 8;
-	I32 lengthInBytes = lengthInBits / 8;
-	//+8 for potential padding
-	reallocByteStringIfNeeded(pAlloc, pByteString, lengthInBits + 8);
-	if (pByteString->nextBitIdx != 0) {
-		//pad to beginning of next byte
-		pByteString->nextBitIdx = 0;
-		pByteString->byteIdx++;
-	}
-	for (I32 i = 0; i < lengthInBytes; ++i) {
-		pByteString->pString[pByteString->byteIdx] = pString[i];
-		pByteString->byteIdx++;
-	}
+static
+StucErr storeDecompressInit(const StucAlloc *pAlloc, void **ppState) {
+	*ppState = NULL;
+	return PIX_ERR_SUCCESS;
 }
 
-void stucDecodeValue(ByteString *pByteString, U8 *pValue, I32 bitLen) {
-	U8 *pStart = pByteString->pString + pByteString->byteIdx;
-
-	I32 strByteLen = getByteLen(bitLen + pByteString->nextBitIdx);
-	for (I32 i = 0; i < strByteLen; ++i) {
-		pValue[i] = pStart[i] >> pByteString->nextBitIdx;
-		if (i != strByteLen - 1) {
-			U8 nextByte = pStart[i + 1];
-			nextByte <<= 8 - pByteString->nextBitIdx;
-			pValue[i] |= nextByte;
-		}
-	}
-	U8 mask = UCHAR_MAX >> (8 - abs(bitLen - strByteLen * 8)) % 8;
-	pValue[strByteLen - 1] &= mask;
-	pByteString->nextBitIdx = pByteString->nextBitIdx + bitLen;
-	pByteString->byteIdx += pByteString->nextBitIdx / 8;
-	pByteString->nextBitIdx %= 8;
+static
+StucErr storeDecompress(
+	void *pState,
+	const U8 **ppIn,
+	I64 *pInSize,
+	U8 **ppOut,
+	I64 *pOutSize
+) {
+	I64 size = PIXM_MIN(*pInSize, *pOutSize);
+	memcpy(*ppOut, *ppIn, size);
+	*ppIn += size;
+	*pInSize -= size;
+	*ppOut += size;
+	*pOutSize -= size;
+	return PIX_ERR_SUCCESS;
 }
 
-void stucDecodeString(ByteString *pByteString, char *pString, I32 maxLen) {
-	pByteString->byteIdx += pByteString->nextBitIdx > 0;
-	U8 *dataPtr = pByteString->pString + pByteString->byteIdx;
-	I32 i = 0;
-	for (; i < maxLen && dataPtr[i]; ++i) {
-		pString[i] = dataPtr[i];
-	}
-	pString[i] = 0;
-	pByteString->byteIdx += i + 1;
-	pByteString->nextBitIdx = 0;
-}
+static
+void storeDecompressDestroy(const StucAlloc *pAlloc, void *pState) {}
 
 static
-void encodeAttribs(
+StucErr deflateCompress(
 	const StucAlloc *pAlloc,
-	ByteString *pData,
-	AttribArray *pAttribs,
-	I32 dataLen
+	const U8 *pIn,
+	I64 inSize,
+	U8 **ppOut,
+	I64 *pOutSize
 ) {
-	for (I32 i = 0; i < pAttribs->count; ++i) {
-		if (pAttribs->pArr[i].core.type == STUC_ATTRIB_STRING) {
-			for (I32 j = 0; j < dataLen; ++j) {
-				void *pString = stucAttribAsVoid(&pAttribs->pArr[i].core, j);
-				stucEncodeString(pAlloc, pData, pString);
-			}
-		}
-		else {
-			I32 attribSize = stucGetAttribSizeIntern(pAttribs->pArr[i].core.type) * 8;
-			for (I32 j = 0; j < dataLen; ++j) {
-				stucEncodeValue(pAlloc, pData, stucAttribAsVoid(&pAttribs->pArr[i].core, j), attribSize);
-			}
-		}
-	}
+	StucErr err = PIX_ERR_SUCCESS;
+	z_stream zStream = {
+		.zalloc = mallocZlibWrap,
+		.zfree = freeZlibWrap,
+		.opaque = (void *)pAlloc
+	};
+	//using gzip with crc32
+	err = checkZlibErr(
+		Z_OK,
+		deflateInit2(
+			&zStream,
+			Z_DEFAULT_COMPRESSION,
+			Z_DEFLATED,
+			STUC_WINDOW_BITS,
+			8,
+			Z_DEFAULT_STRATEGY
+		)
+	);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	zStream.avail_out = deflateBound(&zStream, inSize);
+	*ppOut = pAlloc->fpMalloc(zStream.avail_out);
+	zStream.next_out = *ppOut;
+	zStream.avail_in = (U32)inSize;
+	zStream.next_in = (U8 *)pIn;
+	err = checkZlibErr(Z_STREAM_END, deflate(&zStream, Z_FINISH));
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	*pOutSize = zStream.total_out;
+	PIX_ERR_CATCH(0, err,
+		pAlloc->fpFree(*ppOut);
+		*ppOut = NULL;
+	);
+	deflateEnd(&zStream);
+	return err;
 }
 
-//TODO now that StucAttrib and StucAttribIndexed share the same StucAttribCore
-//struct, try and generalize these funcs for both if possible
 static
-void encodeIndexedAttribs(
-	const StucAlloc *pAlloc,
-	ByteString *pData,
-	AttribIndexedArr *pAttribs
-) {
-	for (I32 i = 0; i < pAttribs->count; ++i) {
-		AttribIndexed *pAttrib = pAttribs->pArr + i;
-		if (pAttrib->core.type == STUC_ATTRIB_STRING) {
-			for (I32 j = 0; j < pAttrib->count; ++j) {
-				void *pString = stucAttribAsVoid(&pAttrib->core, j);
-				stucEncodeString(pAlloc, pData, pString);
-			}
-		}
-		else {
-			I32 attribSize = stucGetAttribSizeIntern(pAttrib->core.type) * 8;
-			for (I32 j = 0; j < pAttrib->count; ++j) {
-				stucEncodeValue(pAlloc, pData, stucAttribAsVoid(&pAttrib->core, j), attribSize);
-			}
-		}
-	}
+StucErr deflateDecompressInit(const StucAlloc *pAlloc, void **ppState) {
+	StucErr err = PIX_ERR_SUCCESS;
+	z_stream *pZStream = pAlloc->fpCalloc(1, sizeof(z_stream));
+	pZStream->zalloc = mallocZlibWrap;
+	pZStream->zfree = freeZlibWrap;
+	pZStream->opaque = (void *)pAlloc;
+	err = checkZlibErr(Z_OK, inflateInit2(pZStream, STUC_WINDOW_BITS));
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	*ppState = pZStream;
+	PIX_ERR_CATCH(0, err, pAlloc->fpFree(pZStream););
+	return err;
 }
 
 static
-void encodeAttribMeta(
-	const StucAlloc *pAlloc,
-	ByteString *pData,
-	AttribArray *pAttribs
+StucErr deflateDecompress(
+	void *pState,
+	const U8 **ppIn,
+	I64 *pInSize,
+	U8 **ppOut,
+	I64 *pOutSize
 ) {
-	for (I32 i = 0; i < pAttribs->count; ++i) {
-		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.type, 8);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.use, 8);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].interpolate, 1);
-		stucEncodeString(pAlloc, pData, pAttribs->pArr[i].core.name);
+	StucErr err = PIX_ERR_SUCCESS;
+	z_stream *pZStream = pState;
+	pZStream->next_in = (U8 *)*ppIn;
+	pZStream->avail_in = (U32)*pInSize;
+	pZStream->next_out = *ppOut;
+	pZStream->avail_out = (U32)*pOutSize;
+	I32 zErr = inflate(pZStream, Z_NO_FLUSH);
+	//buf err just means no progress could be made, the caller handles that
+	if (zErr != Z_STREAM_END && zErr != Z_BUF_ERROR) {
+		err = checkZlibErr(Z_OK, zErr);
+		PIX_ERR_RETURN_IFNOT(err, "");
 	}
+	*ppIn = pZStream->next_in;
+	*pInSize = pZStream->avail_in;
+	*ppOut = pZStream->next_out;
+	*pOutSize = pZStream->avail_out;
+	return err;
 }
 
 static
-void encodeIndexedAttribMeta(
-	const StucAlloc *pAlloc,
-	ByteString *pData,
-	AttribIndexedArr *pAttribs
-) {
-	for (I32 i = 0; i < pAttribs->count; ++i) {
-		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.type, 8);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.use, 8);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].count, 32);
-		stucEncodeString(pAlloc, pData, pAttribs->pArr[i].core.name);
-	}
+void deflateDecompressDestroy(const StucAlloc *pAlloc, void *pState) {
+	inflateEnd(pState);
+	pAlloc->fpFree(pState);
 }
 
-static
-U64 dataTagKeyFromStr(const char *pStr) {
-	return (U64)DATA_TAG_KEY(pStr[0], pStr[1]);
+void stucCodecsSetDefault(StucContext pCtx) {
+	pCtx->codecs[STUC_CODEC_STORE] = (StucCodec){
+		.fpCompress = storeCompress,
+		.fpDecompressInit = storeDecompressInit,
+		.fpDecompress = storeDecompress,
+		.fpDecompressDestroy = storeDecompressDestroy
+	};
+	pCtx->codecs[STUC_CODEC_DEFLATE] = (StucCodec){
+		.fpCompress = deflateCompress,
+		.fpDecompressInit = deflateDecompressInit,
+		.fpDecompress = deflateDecompress,
+		.fpDecompressDestroy = deflateDecompressDestroy
+	};
+}
+
+StucErr stucCodecSet(StucContext pCtx, I32 id, const StucCodec *pCodec) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pCtx && pCodec, "");
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		id >= STUC_CODEC_CUSTOM && id < STUC_CODEC_MAX,
+		"codec id is out of the custom range"
+	);
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		pCodec->fpCompress &&
+		pCodec->fpDecompressInit &&
+		pCodec->fpDecompress &&
+		pCodec->fpDecompressDestroy,
+		"one or more codec functions were NULL"
+	);
+	pCtx->codecs[id] = *pCodec;
+	return err;
 }
 
 static
-DataTag dataTagFromStr(const char *pStr) {
-	return dataTagKeyToTag[DATA_TAG_WRAP(dataTagKeyFromStr(pStr))];
+StucErr codecGet(StucContext pCtx, I32 id, const StucCodec **ppCodec) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		id >= 0 && id < STUC_CODEC_MAX && pCtx->codecs[id].fpDecompress,
+		"map data uses an unregistered codec"
+	);
+	*ppCodec = pCtx->codecs + id;
+	return err;
 }
 
+typedef struct ReadAheadJob {
+	MapDataStream *pStream;
+	U8 *pBuf;
+	I32 size;
+} ReadAheadJob;
+
+typedef struct MapChunk {
+	I64 size;
+	I64 pos;
+	I64 sizeCompressed;
+	I32 codec;
+} MapChunk;
+
+//decompresses map data incrementally as it's decoded, so the compressed and
+//uncompressed data never need to be held in memory in full.
+//Compressed data is double buffered, the next block is read while the
+//current one is decompressed
+struct MapDataStream {
+	StucContext pCtx;
+	void *pFile;
+	U8 *pRead[2];
+	void *pReadReq;
+	ReadAheadJob readJob;
+	I32 readPendingSize;
+	I32 readBuf; //buffer the pending read goes into
+	bool readPending;
+	//set if loading from within a pool job. Read-ahead then only goes through
+	//fpReadSubmit, and otherwise blocks are read synchronously, as a worker
+	//blocking on another pool job can starve the pool
+	bool inPoolJob;
+	//false if the file's been updated in place, and chunks have to be read
+	//from their own positions
+	bool contiguous;
+	I64 compressedLeft; //not yet submitted for reading
+	I64 dataStart; //file offset of the compressed data
+	I64 filePos;
+	I32 readChunk; //chunk the next read starts in, and how far into it
+	I64 readChunkOffset;
+	const U8 *pIn;
+	I64 inSize;
+	MapChunk *pChunks;
+	I32 chunkCount;
+	I32 chunk; //next chunk to start
+	I64 chunkInLeft;
+	I64 chunkOutLeft;
+	const StucCodec *pCodec;
+	void *pCodecState;
+	I64 windowStart;
+	I64 windowLen;
+	StucErr err;
+	bool end;
+};
+
+//moves the file to pos. Without fpSeek, the file can only be moved forward,
+//by reading and discarding
 static
-DataTag decodeDataTag(ByteString *pByteString, char *pTagOut) {
-	//ensure string is aligned with byte (we need to do this manually,
-	//as stucDecodeValue is being used instead of stucDecodeString, given there's
-	//only 2 characters)
-	pByteString->byteIdx += pByteString->nextBitIdx > 0;
-	pByteString->nextBitIdx = 0;
-	char tag[2] = {0};
-	stucDecodeValue(pByteString, (U8 *)tag, 16);
-	if (pTagOut) {
-		pTagOut[0] = tag[0];
-		pTagOut[1] = tag[1];
+StucErr ioSeekTo(StucContext pCtx, void *pFile, I64 *pFilePos, I64 pos) {
+	StucErr err = PIX_ERR_SUCCESS;
+	if (*pFilePos == pos) {
+		return err;
 	}
-	return dataTagFromStr(tag);
+	if (pCtx->io.fpSeek) {
+		err = pCtx->io.fpSeek(pFile, pos);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		*pFilePos = pos;
+		return err;
+	}
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		pos > *pFilePos,
+		"map file was updated in place, reading it requires an io with fpSeek"
+	);
+	U8 buf[4096];
+	while (*pFilePos < pos) {
+		I32 size = (I32)PIXM_MIN(pos - *pFilePos, sizeof(buf));
+		err = pCtx->io.fpRead(pFile, buf, size);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		*pFilePos += size;
+	}
+	return err;
 }
 
+//moves the read cursor forward over size bytes of compressed data.
+//Exhausted chunks are stepped over, so the cursor's always within a chunk
+//until the data's been read
 static
-void strFromDataTag(DataTag tag, char *pStr) {
-	memcpy(pStr, &DATA_TAG_KEY_TO_STR(dataTagToKey[tag]), 2); 
+void streamReadCursorAdvance(MapDataStream *pStream, I64 size) {
+	pStream->readChunkOffset += size;
+	while (pStream->readChunk < pStream->chunkCount) {
+		I64 chunkSize = pStream->pChunks[pStream->readChunk].sizeCompressed;
+		if (pStream->readChunkOffset < chunkSize) {
+			break;
+		}
+		pStream->readChunkOffset -= chunkSize;
+		++pStream->readChunk;
+	}
 }
 
+//outputs the file pos of the read cursor, and how much is left in its chunk
 static
-StucErr isDataTagInvalid(ByteString *pByteString, DataTag tag) {
+StucErr streamReadCursorGet(MapDataStream *pStream, I64 *pPos, I64 *pChunkLeft) {
 	StucErr err = PIX_ERR_SUCCESS;
-	char str[2] = {0};
-	PIX_ERR_THROW_IFNOT_COND(
+	PIX_ERR_RETURN_IFNOT_COND(
 		err,
-		decodeDataTag(pByteString, str) == tag,
-		"tag doesn't match",
-		0
+		pStream->readChunk < pStream->chunkCount,
+		"unexpected end of map data"
 	);
-	char refStr[2] = {0};
-	strFromDataTag(tag, refStr);
-	PIX_ERR_CATCH(0, err, ;);
+	const MapChunk *pChunk = pStream->pChunks + pStream->readChunk;
+	*pPos = pStream->dataStart + pChunk->pos + pStream->readChunkOffset;
+	*pChunkLeft = pChunk->sizeCompressed - pStream->readChunkOffset;
 	return err;
 }
 
+//reads the next size bytes of compressed data, which may span chunks
 static
-void encodeDataTag(const StucAlloc *pAlloc, ByteString *pByteString, DataTag tag) {
-	//not using stucEncodeString, as there's not need for a null terminator.
-	//Only using 2 characters
-	
-	//ensure string is aligned with byte (we need to do this manually,
-	//as stucEncodeValue is being used instead of stucEncodeString)
-	if (pByteString->nextBitIdx != 0) {
-		pByteString->nextBitIdx = 0;
-		pByteString->byteIdx++;
+StucErr streamFileRead(MapDataStream *pStream, U8 *pBuf, I32 size) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucContext pCtx = pStream->pCtx;
+	while (size) {
+		I64 pos = 0;
+		I64 left = 0;
+		err = streamReadCursorGet(pStream, &pos, &left);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		I32 readSize = (I32)PIXM_MIN(left, size);
+		err = ioSeekTo(pCtx, pStream->pFile, &pStream->filePos, pos);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		err = pCtx->io.fpRead(pStream->pFile, pBuf, readSize);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		pStream->filePos += readSize;
+		streamReadCursorAdvance(pStream, readSize);
+		pBuf += readSize;
+		size -= readSize;
 	}
-	char str[2] = {0};
-	strFromDataTag(tag, str);
-	stucEncodeValue(pAlloc, pByteString, (U8 *)str, 16);
+	return err;
 }
 
 static
-PixErr encodeActiveAttribs(
-	const StucAlloc *pAlloc,
-	ByteString *pData,
-	StucMesh *pMesh
-) {
-	PixErr err = PIX_ERR_SUCCESS;
-	
-	encodeDataTag(pAlloc, pData, TAG_ACTIVE_ATTRIBS);
-	I32 count = 0;
-	for (I32 i = 0; i < STUC_ATTRIB_USE_ENUM_COUNT; ++i) {
-		count += pMesh->activeAttribs[i].active;
-	}
-	stucEncodeValue(pAlloc, pData, (U8 *)&count, 8);
-	for (I32 i = 0; i < STUC_ATTRIB_USE_ENUM_COUNT; ++i) {
-		if (!pMesh->activeAttribs[i].active) {
-			continue;
-		}
-		stucEncodeValue(pAlloc, pData, (U8 *)&i, 8);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->activeAttribs[i].domain, 4);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->activeAttribs[i].idx, 16);
-	}
-	return err;
+StucErr readAheadJob(void *pArgs) {
+	ReadAheadJob *pJob = pArgs;
+	return streamFileRead(pJob->pStream, pJob->pBuf, pJob->size);
 }
 
+//no read is pending when this is called, so the file can be moved before
+//the read's submitted. If chunks are out of order, a read can't span them
 static
-void destroyIdxTableArr(StucAlloc *pAlloc, StucIdxTableArr *pArr) {
-	if (pArr->pArr) {
-		for (I32 i = 0; i < pArr->count; ++i) {
-			if (pArr->pArr[i].table.pArr) {
-				pAlloc->fpFree(pArr->pArr[i].table.pArr);
-			}
-		}
-		pAlloc->fpFree(pArr->pArr);
+StucErr streamReadSubmitAsync(MapDataStream *pStream, U8 *pBuf, I32 *pSize) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucContext pCtx = pStream->pCtx;
+	I64 pos = 0;
+	I64 left = 0;
+	err = streamReadCursorGet(pStream, &pos, &left);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	if (!pStream->contiguous) {
+		*pSize = (I32)PIXM_MIN(left, *pSize);
 	}
-	*pArr = (StucIdxTableArr){0};
+	//only moves the file if chunks are out of order, or if data was skipped
+	err = ioSeekTo(pCtx, pStream->pFile, &pStream->filePos, pos);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	err = pCtx->io.fpReadSubmit(pStream->pFile, pBuf, *pSize, &pStream->pReadReq);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	pStream->filePos += *pSize;
+	streamReadCursorAdvance(pStream, *pSize);
+	return err;
 }
 
 static
-void destroyIdxTableArrs(StucAlloc *pAlloc, StucIdxTableArr **ppArr, I32 count) {
-	if (*ppArr) {
-		for (I32 i = 0; i < count; ++i) {
-			destroyIdxTableArr(pAlloc, (*ppArr) + i);
-		}
-		pAlloc->fpFree(*ppArr);
-		*ppArr = NULL;
+StucErr streamReadSubmit(MapDataStream *pStream) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_ASSERT("", !pStream->readPending);
+	if (!pStream->compressedLeft) {
+		return err;
+	}
+	StucContext pCtx = pStream->pCtx;
+	I32 size = (I32)PIXM_MIN(pStream->compressedLeft, STUC_STREAM_READ_SIZE);
+	U8 *pBuf = pStream->pRead[pStream->readBuf];
+	if (pCtx->io.fpReadSubmit) {
+		err = streamReadSubmitAsync(pStream, pBuf, &size);
+		PIX_ERR_RETURN_IFNOT(err, "");
+	}
+	else if (pStream->inPoolJob) {
+		err = streamFileRead(pStream, pBuf, size);
+		PIX_ERR_RETURN_IFNOT(err, "");
 	}
+	else {
+		pStream->readJob = (ReadAheadJob){
+			.pStream = pStream,
+			.pBuf = pBuf,
+			.size = size
+		};
+		void *pArgs = &pStream->readJob;
+		err = pCtx->threadPool.pJobStackPushJobs(
+			pCtx->pThreadPoolHandle,
+			1,
+			&pStream->pReadReq,
+			readAheadJob,
+			&pArgs
+		);
+		PIX_ERR_RETURN_IFNOT(err, "");
+	}
+	pStream->compressedLeft -= size;
+	pStream->readPendingSize = size;
+	pStream->readPending = true;
+	return err;
 }
 
 static
-void encodeRedirectTable(
-	const StucAlloc *pAlloc,
-	ByteString *pData,
-	const StucIdxTableArr *pIdxTable
-) {
-	encodeDataTag(pAlloc, pData, TAG_IDX_REDIRECTS);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pIdxTable->count, 16);
-	for (I32 i = 0; i < pIdxTable->count; ++i) {
-		StucIdxTable *pTable = pIdxTable->pArr + i;
-		stucEncodeValue(pAlloc, pData, (U8 *)&pTable->idx, 16);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pTable->table.count, 8);
-		PIX_ERR_ASSERT("", !pData->nextBitIdx);
-		I32 countMem = pData->byteIdx;
-		stucEncodeValue(pAlloc, pData, &(U8){0}, 8);
-		I32 count = 0;
-		for (I32 j = 0; j < pTable->table.count; ++j) {
-			if (pTable->table.pArr[j] >= 0) {
-				++count;
-				stucEncodeValue(pAlloc, pData, (U8 *)&j, 8);//local
-				stucEncodeValue(pAlloc, pData, (U8 *)&pTable->table.pArr[j], 8);//global
-			}
+StucErr streamReadWait(MapDataStream *pStream) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_ASSERT("", pStream->readPending);
+	StucContext pCtx = pStream->pCtx;
+	pStream->readPending = false;
+	if (pCtx->io.fpReadSubmit) {
+		bool done = false;
+		err = pCtx->io.fpReadPoll(pStream->pReadReq, true, &done);
+		PIX_ERR_RETURN_IFNOT(err, "");
+	}
+	else if (!pStream->inPoolJob) {
+		void **ppHandle = &pStream->pReadReq;
+		err = stucWaitForJobs(pCtx, 1, ppHandle, true, NULL);
+		if (err == PIX_ERR_SUCCESS) {
+			err = stucJobGetErrs(pCtx, 1, &ppHandle);
 		}
-		PIX_ERR_ASSERT("", count <= UINT8_MAX);
-		pData->pString[countMem] = (U8)count;
+		stucJobDestroyHandles(pCtx, 1, ppHandle);
+		PIX_ERR_RETURN_IFNOT(err, "");
 	}
+	pStream->pReadReq = NULL;
+	return err;
 }
 
-typedef struct MappingOpt {
-	F32 wScale;
-	F32 receiveLen;
-} MappingOpt;
-
-typedef struct MatMapEntry {
-	PixuctHTableEntryCore core;
-	I32 linIdx;
-	StucMap pMap;
-	MappingOpt opt;
-} MatMapEntry;
+//makes the pending read the current input, and starts reading the next
+//block into the other buffer
+static
+StucErr streamReadNext(MapDataStream *pStream) {
+	StucErr err = PIX_ERR_SUCCESS;
+	err = streamReadWait(pStream);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	pStream->pIn = pStream->pRead[pStream->readBuf];
+	pStream->inSize = pStream->readPendingSize;
+	pStream->readBuf = !pStream->readBuf;
+	err = streamReadSubmit(pStream);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	return err;
+}
 
-typedef struct MatMapEntryInit {
-	StucMap pMap;
-	MappingOpt opt;
-} MatMapEntryInit;
+static
+void streamCodecStateDestroy(MapDataStream *pStream) {
+	if (pStream->pCodecState) {
+		pStream->pCodec->fpDecompressDestroy(&pStream->pCtx->alloc, pStream->pCodecState);
+		pStream->pCodecState = NULL;
+	}
+}
 
 static
-void matMapEntryInit(
-	void *pUserData,
-	PixuctHTableEntryCore *pCore,
-	const void *pKeyData,
-	void *pInitInfo,
-	I32 linIdx
-) {
-	MatMapEntryInit *pInit = (MatMapEntryInit *)pInitInfo;
-	MatMapEntry *pEntry = (MatMapEntry *)pCore;
-	pEntry->linIdx = linIdx;
-	pEntry->pMap = pInit->pMap;
-	pEntry->opt = pInit->opt;
+StucErr streamChunkNext(MapDataStream *pStream) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_ASSERT("", !pStream->chunkInLeft && !pStream->chunkOutLeft);
+	streamCodecStateDestroy(pStream);
+	if (pStream->chunk == pStream->chunkCount) {
+		pStream->end = true;
+		return err;
+	}
+	const MapChunk *pChunk = pStream->pChunks + pStream->chunk;
+	++pStream->chunk;
+	err = codecGet(pStream->pCtx, pChunk->codec, &pStream->pCodec);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	err = pStream->pCodec->fpDecompressInit(&pStream->pCtx->alloc, &pStream->pCodecState);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	pStream->chunkInLeft = pChunk->sizeCompressed;
+	pStream->chunkOutLeft = pChunk->size;
+	return err;
 }
 
 static
-bool matMapEntryCmp(
-	const PixuctHTableEntryCore *pEntry,
-	const void *pKeyData,
-	const void *pInitInfo
-) {
-	return !strncmp(((MatMapEntry *)pEntry)->pMap->pName, pKeyData, pixioPathMaxGet());
+void streamInSkip(MapDataStream *pStream) {
+	I64 skip = PIXM_MIN(pStream->inSize, pStream->chunkInLeft);
+	pStream->pIn += skip;
+	pStream->inSize -= skip;
+	pStream->chunkInLeft -= skip;
 }
 
+//discards the rest of the current chunk without decompressing it.
+//Whatever of the chunk's already been read is dropped, and the read cursor's
+//moved past the rest, so the next read seeks over it (or with no fpSeek,
+//reads and discards it)
 static
-void encodeBlendConfigOverride(
-	const StucAlloc *pAlloc,
-	ByteString *pCommonBuf,
-	const StucTypeDefault *pDefault,
-	const StucBlendConfig *pBlendConfig
-) {
-	UBitField8 flags =
-		(pBlendConfig->blend != pDefault->blendConfig.blend) |
-		(pBlendConfig->fMax != pDefault->blendConfig.fMax) << 1 |
-		(pBlendConfig->fMin != pDefault->blendConfig.fMin) << 2 |
-		(pBlendConfig->iMax != pDefault->blendConfig.iMax) << 3 |
-		(pBlendConfig->iMin != pDefault->blendConfig.iMin) << 4 |
-		(pBlendConfig->opacity != pDefault->blendConfig.opacity) << 5 |
-		(pBlendConfig->clamp != pDefault->blendConfig.clamp) << 6 |
-		(pBlendConfig->order != pDefault->blendConfig.order) << 7;
-	stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&flags, 8);
-	if (flags & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->blend, 8);
-	}
-	if (flags >> 1 & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->fMax, 64);
-	}
-	if (flags >> 2 & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->fMin, 64);
-	}
-	if (flags >> 3 & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->iMax, 64);
-	}
-	if (flags >> 4 & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->iMin, 64);
+StucErr streamChunkSkip(MapDataStream *pStream) {
+	StucErr err = PIX_ERR_SUCCESS;
+	pStream->windowStart += pStream->chunkOutLeft;
+	pStream->chunkOutLeft = 0;
+	streamInSkip(pStream);
+	if (!pStream->chunkInLeft) {
+		return err;
 	}
-	if (flags >> 5 & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->opacity, 32);
+	if (pStream->readPending) {
+		//in-flight reads can't be cancelled, so the block's used
+		err = streamReadWait(pStream);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		pStream->pIn = pStream->pRead[pStream->readBuf];
+		pStream->inSize = pStream->readPendingSize;
+		pStream->readBuf = !pStream->readBuf;
+		streamInSkip(pStream);
 	}
-	if (flags >> 6 & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->clamp, 1);
+	if (pStream->chunkInLeft) {
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			pStream->chunkInLeft <= pStream->compressedLeft,
+			"unexpected end of map data"
+		);
+		streamReadCursorAdvance(pStream, pStream->chunkInLeft);
+		pStream->compressedLeft -= pStream->chunkInLeft;
+		pStream->chunkInLeft = 0;
 	}
-	if (flags >> 7 & 0x1) {
-		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->order, 1);
+	if (!pStream->readPending) {
+		err = streamReadSubmit(pStream);
+		PIX_ERR_RETURN_IFNOT(err, "");
 	}
+	return err;
 }
 
 static
-void encodeBlendOpts(
-	StucMapExport *pHandle,
-	const StucMesh *pMesh,
-	StucMapArrEntry *pMapArrEntry,
-	const MatMapEntry *pMatMapEntry,
-	ByteString *pBlendOptBuf,
-	bool blendOptOverride
-) {
-	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
-	for (StucDomain domain = STUC_DOMAIN_FACE; domain <= STUC_DOMAIN_VERT; ++domain) {
-		StucBlendOptArr *pArr = pMapArrEntry->blendOptArr + domain; 
-		const AttribArray *pAttribArr = stucGetAttribArrFromDomainConst(pMesh, domain);
+StucErr streamDecompress(MapDataStream *pStream, ByteString *pData, I64 limit) {
+	StucErr err = PIX_ERR_SUCCESS;
+	while (pStream->windowLen < limit && !pStream->end) {
+		if (!pStream->chunkInLeft && !pStream->chunkOutLeft) {
+			err = streamChunkNext(pStream);
+			PIX_ERR_RETURN_IFNOT(err, "");
+			continue;
+		}
+		if (!pStream->inSize && pStream->readPending) {
+			err = streamReadNext(pStream);
+			PIX_ERR_RETURN_IFNOT(err, "");
+		}
+		const U8 *pIn = pStream->pIn;
+		I64 inSize = PIXM_MIN(pStream->inSize, pStream->chunkInLeft);
+		U8 *pOut = pData->pString + pStream->windowLen;
+		I64 outSize = PIXM_MIN(limit - pStream->windowLen, pStream->chunkOutLeft);
+		I64 inSizeStart = inSize;
+		I64 outSizeStart = outSize;
+		err = pStream->pCodec->fpDecompress(
+			pStream->pCodecState,
+			&pIn,
+			&inSize,
+			&pOut,
+			&outSize
+		);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		I64 consumed = inSizeStart - inSize;
+		I64 written = outSizeStart - outSize;
+		pStream->pIn += consumed;
+		pStream->inSize -= consumed;
+		pStream->chunkInLeft -= consumed;
+		pStream->windowLen += written;
+		pStream->chunkOutLeft -= written;
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			consumed || written || !pStream->inSize && pStream->readPending,
+			"map data is corrupt"
+		);
+	}
+	return err;
+}
 
-		I32 countBytePos = pBlendOptBuf->byteIdx;
-		stucEncodeValue(pAlloc, pBlendOptBuf, (U8[]){0, 0}, 16);
-		I32 count = 0;
-		for (I32 j = 0; j < pArr->count; ++j) {
-			const Attrib *pAttrib = pAttribArr->pArr + pArr->pArr[j].attrib;
-			const StucTypeDefault *pDefault = stucGetTypeDefaultConfig(
-				&pHandle->pCtx->typeDefaults,
-				pAttrib->core.type
-			);
-			BlendConfig *pBlendConfig = &pArr->pArr[j].blendConfig;
-			if (memcmp(
-				pBlendConfig,
-				&pDefault->blendConfig,
-				sizeof(BlendConfig))
+//moves the window forward to byteIdx, keeping any bytes already decompressed past it
+static
+StucErr streamAdvance(MapDataStream *pStream, ByteString *pData, I64 byteLen) {
+	StucErr err = PIX_ERR_SUCCESS;
+	I64 offset = pData->byteIdx - pStream->windowStart;
+	PIX_ERR_RETURN_IFNOT_COND(err, offset >= 0, "map data can't be read out of order");
+	if (offset < pStream->windowLen) {
+		pStream->windowLen -= offset;
+		memmove(pData->pString, pData->pString + offset, pStream->windowLen);
+	}
+	else {
+		//skipping ahead
+		pStream->windowStart += pStream->windowLen;
+		pStream->windowLen = 0;
+		while (pStream->windowStart < pData->byteIdx) {
+			if (!pStream->end &&
+				pStream->windowStart + pStream->chunkOutLeft <= pData->byteIdx
 			) {
-				stucEncodeValue(pAlloc, pBlendOptBuf, (U8 *)&pArr->pArr[j].attrib, 16);
-				stucEncodeValue(pAlloc, pBlendOptBuf, (U8 *)&pAttrib->core.type, 8);
-				encodeBlendConfigOverride(pAlloc, pBlendOptBuf, pDefault, pBlendConfig);
-				++count;
+				err = streamChunkSkip(pStream);
+				PIX_ERR_RETURN_IFNOT(err, "");
+				if (pStream->windowStart < pData->byteIdx) {
+					err = streamChunkNext(pStream);
+					PIX_ERR_RETURN_IFNOT(err, "");
+				}
+				continue;
 			}
+			//byteIdx is within the current chunk, decompress and discard up to it
+			I64 skip = PIXM_MIN(pData->byteIdx - pStream->windowStart, STUC_STREAM_WINDOW_SIZE);
+			err = streamDecompress(pStream, pData, skip);
+			PIX_ERR_RETURN_IFNOT(err, "");
+			PIX_ERR_RETURN_IFNOT_COND(err, pStream->windowLen, "unexpected end of map data");
+			pStream->windowStart += pStream->windowLen;
+			pStream->windowLen = 0;
 		}
-		if (count) {
-			blendOptOverride = true;
-		}
-		*(I16 *)&pBlendOptBuf->pString[countBytePos] = count;
 	}
+	pStream->windowStart = pData->byteIdx;
+	err = streamDecompress(pStream, pData, STUC_STREAM_WINDOW_SIZE);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		byteLen <= pStream->windowLen,
+		"unexpected end of map data"
+	);
+	return err;
 }
 
+//returns a pointer to byteIdx with at least byteLen bytes readable
+//(or however many are left in the data)
 static
-void optsFinalEncode(
-	StucMapExport *pHandle,
-	MatMapEntry *pMatMapEntry,
-	I32 matIdx,
-	ByteString *pBlendOpt,
-	bool blendOptOverride,
-	bool wScaleOverride,
-	bool receiveOverride
-) {
-	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
-	ByteString *pData = &pHandle->data;
-	UBitField8 header = !!blendOptOverride | wScaleOverride << 1 | receiveOverride << 2;
-	stucEncodeValue(pAlloc, pData, (U8 *)&matIdx, 16);
-	stucEncodeValue(pAlloc, pData, (U8 *)&header, 8);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMatMapEntry->linIdx, 16);
-	if (blendOptOverride) {
-		reallocByteStringIfNeeded(pAlloc, pData, (I64)pBlendOpt->byteIdx * 8);
-		memcpy(pData->pString, pBlendOpt->pString, pBlendOpt->byteIdx);
-		pData->byteIdx += pBlendOpt->byteIdx;
-	}
-	if (pBlendOpt->pString) {
-		pAlloc->fpFree(pBlendOpt->pString);
+U8 *getReadPtr(ByteString *pData, I64 byteLen) {
+	MapDataStream *pStream = pData->pStream;
+	if (!pStream) {
+		return pData->pString + pData->byteIdx;
 	}
-	if (wScaleOverride) {
-		stucEncodeValue(pAlloc, pData, (U8 *)&pMatMapEntry->opt.wScale, 32);
+	PIX_ERR_ASSERT("", byteLen <= STUC_STREAM_WINDOW_SIZE);
+	I64 needed = PIXM_MIN(byteLen, pData->size - pData->byteIdx);
+	if (pStream->err == PIX_ERR_SUCCESS &&
+		pData->byteIdx + needed > pStream->windowStart + pStream->windowLen
+	) {
+		pStream->err = streamAdvance(pStream, pData, needed);
 	}
-	if (receiveOverride) {
-		stucEncodeValue(pAlloc, pData, (U8 *)&pMatMapEntry->opt.receiveLen, 32);
+	if (pStream->err != PIX_ERR_SUCCESS) {
+		//the decode funcs can't return errors, so they read zeros until the
+		//stream err is checked after the current record
+		pStream->windowStart = pData->byteIdx;
+		pStream->windowLen = 0;
+		memset(pData->pString, 0, byteLen);
+		return pData->pString;
 	}
+	return pData->pString + (pData->byteIdx - pStream->windowStart);
 }
 
+//decompresses whatever's left, so codecs can verify checksums
 static
-StucErr encodeMappingOpt(
-	StucMapExport *pHandle,
-	const StucMesh *pMesh,
-	const StucMapArr *pMapArr,
-	const AttribIndexedArr *pIdxAttribArr,
-	const StucIdxTableArr *pIdxTable,
+StucErr streamEndCheck(MapDataStream *pStream, ByteString *pData) {
+	StucErr err = PIX_ERR_SUCCESS;
+	pStream->windowStart += pStream->windowLen;
+	pStream->windowLen = 0;
+	err = streamDecompress(pStream, pData, STUC_STREAM_WINDOW_SIZE);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		pStream->end &&
+			!pStream->windowLen &&
+			pStream->windowStart == pData->size &&
+			!pStream->inSize &&
+			!pStream->readPending,
+		"Failed to load STUC file. decompressed data len is wrong\n"
+	);
+	return err;
+}
+
+//stream errors take precedence, as the data read after one is garbage
+static
+StucErr streamErrGet(const ByteString *pData, StucErr err) {
+	if (pData->pStream && pData->pStream->err != PIX_ERR_SUCCESS) {
+		return pData->pStream->err;
+	}
+	return err;
+}
+
+//TODO move these funcs to pixio lib and make U8 *pValue void * instead,
+//having to cast every call is tedious
+void stucEncodeValue(
+	const StucAlloc *pAlloc,
+	ByteString *pByteString,
+	U8 *pValue,
+	I32 bitLen
+) {
+	reallocByteStringIfNeeded(pAlloc, pByteString, bitLen);
+	U8 *pStart = pByteString->pString + pByteString->byteIdx;
+
+	I32 byteLen = getByteLen(bitLen);
+	I32 strByteLen = getByteLen(bitLen + pByteString->nextBitIdx);
+	pStart[0] |= pValue[0] << pByteString->nextBitIdx;
+	for (I32 i = 1; i < strByteLen; ++i) {
+		pStart[i] = i == byteLen ? 0x0 : pValue[i] << pByteString->nextBitIdx;
+		U8 nextByte = pValue[i - 1];
+		nextByte >>= 8 - pByteString->nextBitIdx;
+		pStart[i] |= nextByte;
+	}
+	pByteString->nextBitIdx = pByteString->nextBitIdx + bitLen;
+	pByteString->byteIdx += pByteString->nextBitIdx / 8;
+	pByteString->nextBitIdx %= 8;
+}
+
+void stucEncodeString(const StucAlloc *pAlloc, ByteString *pByteString, const char *pString) {
+	I32 lengthInBits = ((I32)strlen(pString) + 1) * 8;
+	I32 lengthInBytes = lengthInBits / 8;
+	//+8 for potential padding
+	reallocByteStringIfNeeded(pAlloc, pByteString, lengthInBits + 8);
+	if (pByteString->nextBitIdx != 0) {
+		//pad to beginning of next byte
+		pByteString->nextBitIdx = 0;
+		pByteString->byteIdx++;
+	}
+	for (I32 i = 0; i < lengthInBytes; ++i) {
+		pByteString->pString[pByteString->byteIdx] = pString[i];
+		pByteString->byteIdx++;
+	}
+}
+
+void stucDecodeValue(ByteString *pByteString, U8 *pValue, I32 bitLen) {
+	I32 strByteLen = getByteLen(bitLen + pByteString->nextBitIdx);
+	U8 *pStart = getReadPtr(pByteString, strByteLen);
+
+	for (I32 i = 0; i < strByteLen; ++i) {
+		pValue[i] = pStart[i] >> pByteString->nextBitIdx;
+		if (i != strByteLen - 1) {
+			U8 nextByte = pStart[i + 1];
+			nextByte <<= 8 - pByteString->nextBitIdx;
+			pValue[i] |= nextByte;
+		}
+	}
+	U8 mask = UCHAR_MAX >> (8 - abs(bitLen - strByteLen * 8)) % 8;
+	pValue[strByteLen - 1] &= mask;
+	pByteString->nextBitIdx = pByteString->nextBitIdx + bitLen;
+	pByteString->byteIdx += pByteString->nextBitIdx / 8;
+	pByteString->nextBitIdx %= 8;
+}
+
+void stucDecodeString(ByteString *pByteString, char *pString, I32 maxLen) {
+	pByteString->byteIdx += pByteString->nextBitIdx > 0;
+	U8 *dataPtr = getReadPtr(pByteString, maxLen + 1);
+	I32 i = 0;
+	for (; i < maxLen && dataPtr[i]; ++i) {
+		pString[i] = dataPtr[i];
+	}
+	pString[i] = 0;
+	pByteString->byteIdx += i + 1;
+	pByteString->nextBitIdx = 0;
+}
+
+//an attrib stored as fixed point values, see StucMapQuantize
+typedef struct QuantAttrib {
+	const Attrib *pAttrib;
+	F32 min[3];
+	F32 max[3];
+	I32 idx;
+	StucDomain domain;
+	StucAttribUse use;
+	I32 bits;
+	I32 compCount;
+} QuantAttrib;
+
+typedef struct MeshQuant {
+	QuantAttrib attribs[3];
+	I32 count;
+	bool deltaLists;
+} MeshQuant;
+
+static
+bool isAttribQuantized(const MeshQuant *pQuant, const Attrib *pAttrib) {
+	for (I32 i = 0; pQuant && i < pQuant->count; ++i) {
+		if (pQuant->attribs[i].pAttrib == pAttrib) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//computed in double, as at higher bit counts, F32 can't represent every step
+static
+U32 quantize(F32 value, F32 min, F32 max, I32 bits) {
+	U32 steps = (1u << bits) - 1;
+	F64 range = (F64)max - (F64)min;
+	if (!(range > .0)) {
+		return 0;
+	}
+	F64 scaled = ((F64)value - (F64)min) / range * (F64)steps + .5;
+	return scaled <= .0 ? 0 : scaled >= (F64)steps ? steps : (U32)scaled;
+}
+
+static
+F32 dequantize(U32 value, F32 min, F32 max, I32 bits) {
+	U32 steps = (1u << bits) - 1;
+	return (F32)((F64)min + ((F64)max - (F64)min) * ((F64)value / (F64)steps));
+}
+
+static
+F32 signNotZero(F32 value) {
+	return value >= .0f ? 1.0f : -1.0f;
+}
+
+//maps a unit vector onto an octahedron, then unfolds it into a square
+static
+void octEncode(const F32 *pNormal, F32 *pOct) {
+	F32 len = fabsf(pNormal[0]) + fabsf(pNormal[1]) + fabsf(pNormal[2]);
+	if (len == .0f) {
+		pOct[0] = pOct[1] = .0f;
+		return;
+	}
+	F32 x = pNormal[0] / len;
+	F32 y = pNormal[1] / len;
+	if (pNormal[2] < .0f) {
+		pOct[0] = (1.0f - fabsf(y)) * signNotZero(x);
+		pOct[1] = (1.0f - fabsf(x)) * signNotZero(y);
+	}
+	else {
+		pOct[0] = x;
+		pOct[1] = y;
+	}
+}
+
+static
+void octDecode(const F32 *pOct, F32 *pNormal) {
+	F32 x = pOct[0];
+	F32 y = pOct[1];
+	F32 z = 1.0f - fabsf(x) - fabsf(y);
+	if (z < .0f) {
+		F32 xFolded = (1.0f - fabsf(y)) * signNotZero(x);
+		y = (1.0f - fabsf(x)) * signNotZero(y);
+		x = xFolded;
+	}
+	F32 len = sqrtf(x * x + y * y + z * z);
+	pNormal[0] = x / len;
+	pNormal[1] = y / len;
+	pNormal[2] = z / len;
+}
+
+static
+U32 zigzagEncode(I32 value) {
+	return (U32)value << 1 ^ (U32)(value >> 31);
+}
+
+static
+I32 zigzagDecode(U32 value) {
+	return (I32)(value >> 1) ^ -(I32)(value & 0x1);
+}
+
+static
+void encodeVarint(const StucAlloc *pAlloc, ByteString *pData, U32 value) {
+	U8 buf[5] = {0};
+	I32 len = 0;
+	do {
+		buf[len] = value & 0x7f;
+		value >>= 7;
+		buf[len] |= (value > 0) << 7;
+		++len;
+	} while (value);
+	encodeBytes(pAlloc, pData, buf, len);
+}
+
+static
+U32 decodeVarint(ByteString *pData) {
+	U32 value = 0;
+	for (I32 shift = 0; shift < 35; shift += 7) {
+		U8 byte = 0;
+		stucDecodeValue(pData, &byte, 8);
+		value |= (U32)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			break;
+		}
+	}
+	return value;
+}
+
+//lists are stored as the difference from the previous entry
+static
+void encodeDeltaList(const StucAlloc *pAlloc, ByteString *pData, const I32 *pList, I32 count) {
+	I32 prev = 0;
+	for (I32 i = 0; i < count; ++i) {
+		encodeVarint(pAlloc, pData, zigzagEncode(pList[i] - prev));
+		prev = pList[i];
+	}
+}
+
+static
+void decodeDeltaList(ByteString *pData, I32 *pList, I32 count) {
+	I32 prev = 0;
+	for (I32 i = 0; i < count; ++i) {
+		prev += zigzagDecode(decodeVarint(pData));
+		pList[i] = prev;
+	}
+}
+
+static
+void encodeAttribs(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	AttribArray *pAttribs,
+	I32 dataLen,
+	const MeshQuant *pQuant
+) {
+	for (I32 i = 0; i < pAttribs->count; ++i) {
+		if (isAttribQuantized(pQuant, pAttribs->pArr + i)) {
+			continue;//encoded with the mesh header
+		}
+		if (pAttribs->pArr[i].core.type == STUC_ATTRIB_STRING) {
+			for (I32 j = 0; j < dataLen; ++j) {
+				void *pString = stucAttribAsVoid(&pAttribs->pArr[i].core, j);
+				stucEncodeString(pAlloc, pData, pString);
+			}
+		}
+		else if (!pData->nextBitIdx) {
+			//attrib data is contiguous, so it's copied in one go if aligned
+			I32 attribSize = stucGetAttribSizeIntern(pAttribs->pArr[i].core.type);
+			if (dataLen) {
+				const void *pSrc = stucAttribAsVoid(&pAttribs->pArr[i].core, 0);
+				encodeBytes(pAlloc, pData, pSrc, (I64)attribSize * dataLen);
+			}
+		}
+		else {
+			I32 attribSize = stucGetAttribSizeIntern(pAttribs->pArr[i].core.type) * 8;
+			for (I32 j = 0; j < dataLen; ++j) {
+				stucEncodeValue(pAlloc, pData, stucAttribAsVoid(&pAttribs->pArr[i].core, j), attribSize);
+			}
+		}
+	}
+}
+
+//TODO now that StucAttrib and StucAttribIndexed share the same StucAttribCore
+//struct, try and generalize these funcs for both if possible
+static
+void encodeIndexedAttribs(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	AttribIndexedArr *pAttribs
+) {
+	for (I32 i = 0; i < pAttribs->count; ++i) {
+		AttribIndexed *pAttrib = pAttribs->pArr + i;
+		if (pAttrib->core.type == STUC_ATTRIB_STRING) {
+			for (I32 j = 0; j < pAttrib->count; ++j) {
+				void *pString = stucAttribAsVoid(&pAttrib->core, j);
+				stucEncodeString(pAlloc, pData, pString);
+			}
+		}
+		else if (!pData->nextBitIdx) {
+			I32 attribSize = stucGetAttribSizeIntern(pAttrib->core.type);
+			if (pAttrib->count) {
+				const void *pSrc = stucAttribAsVoid(&pAttrib->core, 0);
+				encodeBytes(pAlloc, pData, pSrc, (I64)attribSize * pAttrib->count);
+			}
+		}
+		else {
+			I32 attribSize = stucGetAttribSizeIntern(pAttrib->core.type) * 8;
+			for (I32 j = 0; j < pAttrib->count; ++j) {
+				stucEncodeValue(pAlloc, pData, stucAttribAsVoid(&pAttrib->core, j), attribSize);
+			}
+		}
+	}
+}
+
+static
+void encodeAttribMeta(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	AttribArray *pAttribs
+) {
+	for (I32 i = 0; i < pAttribs->count; ++i) {
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.type, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.use, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].interpolate, 1);
+		stucEncodeString(pAlloc, pData, pAttribs->pArr[i].core.name);
+	}
+}
+
+static
+void encodeIndexedAttribMeta(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	AttribIndexedArr *pAttribs
+) {
+	for (I32 i = 0; i < pAttribs->count; ++i) {
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.type, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].core.use, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttribs->pArr[i].count, 32);
+		stucEncodeString(pAlloc, pData, pAttribs->pArr[i].core.name);
+	}
+}
+
+static
+U64 dataTagKeyFromStr(const char *pStr) {
+	return (U64)DATA_TAG_KEY(pStr[0], pStr[1]);
+}
+
+static
+DataTag dataTagFromStr(const char *pStr) {
+	return dataTagKeyToTag[DATA_TAG_WRAP(dataTagKeyFromStr(pStr))];
+}
+
+static
+DataTag decodeDataTag(ByteString *pByteString, char *pTagOut) {
+	//ensure string is aligned with byte (we need to do this manually,
+	//as stucDecodeValue is being used instead of stucDecodeString, given there's
+	//only 2 characters)
+	pByteString->byteIdx += pByteString->nextBitIdx > 0;
+	pByteString->nextBitIdx = 0;
+	char tag[2] = {0};
+	stucDecodeValue(pByteString, (U8 *)tag, 16);
+	if (pTagOut) {
+		pTagOut[0] = tag[0];
+		pTagOut[1] = tag[1];
+	}
+	return dataTagFromStr(tag);
+}
+
+static
+void strFromDataTag(DataTag tag, char *pStr) {
+	memcpy(pStr, &DATA_TAG_KEY_TO_STR(dataTagToKey[tag]), 2); 
+}
+
+static
+StucErr isDataTagInvalid(ByteString *pByteString, DataTag tag) {
+	StucErr err = PIX_ERR_SUCCESS;
+	char str[2] = {0};
+	PIX_ERR_THROW_IFNOT_COND(
+		err,
+		decodeDataTag(pByteString, str) == tag,
+		"tag doesn't match",
+		0
+	);
+	char refStr[2] = {0};
+	strFromDataTag(tag, refStr);
+	PIX_ERR_CATCH(0, err, ;);
+	return err;
+}
+
+static
+void encodeDataTag(const StucAlloc *pAlloc, ByteString *pByteString, DataTag tag) {
+	//not using stucEncodeString, as there's not need for a null terminator.
+	//Only using 2 characters
+	
+	//ensure string is aligned with byte (we need to do this manually,
+	//as stucEncodeValue is being used instead of stucEncodeString)
+	if (pByteString->nextBitIdx != 0) {
+		pByteString->nextBitIdx = 0;
+		pByteString->byteIdx++;
+	}
+	char str[2] = {0};
+	strFromDataTag(tag, str);
+	stucEncodeValue(pAlloc, pByteString, (U8 *)str, 16);
+}
+
+static
+PixErr encodeActiveAttribs(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	StucMesh *pMesh
+) {
+	PixErr err = PIX_ERR_SUCCESS;
+	
+	encodeDataTag(pAlloc, pData, TAG_ACTIVE_ATTRIBS);
+	I32 count = 0;
+	for (I32 i = 0; i < STUC_ATTRIB_USE_ENUM_COUNT; ++i) {
+		count += pMesh->activeAttribs[i].active;
+	}
+	stucEncodeValue(pAlloc, pData, (U8 *)&count, 8);
+	for (I32 i = 0; i < STUC_ATTRIB_USE_ENUM_COUNT; ++i) {
+		if (!pMesh->activeAttribs[i].active) {
+			continue;
+		}
+		stucEncodeValue(pAlloc, pData, (U8 *)&i, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->activeAttribs[i].domain, 4);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->activeAttribs[i].idx, 16);
+	}
+	return err;
+}
+
+static
+void destroyIdxTableArr(StucAlloc *pAlloc, StucIdxTableArr *pArr) {
+	if (pArr->pArr) {
+		for (I32 i = 0; i < pArr->count; ++i) {
+			if (pArr->pArr[i].table.pArr) {
+				pAlloc->fpFree(pArr->pArr[i].table.pArr);
+			}
+		}
+		pAlloc->fpFree(pArr->pArr);
+	}
+	*pArr = (StucIdxTableArr){0};
+}
+
+static
+void destroyIdxTableArrs(StucAlloc *pAlloc, StucIdxTableArr **ppArr, I32 count) {
+	if (*ppArr) {
+		for (I32 i = 0; i < count; ++i) {
+			destroyIdxTableArr(pAlloc, (*ppArr) + i);
+		}
+		pAlloc->fpFree(*ppArr);
+		*ppArr = NULL;
+	}
+}
+
+static
+void encodeRedirectTable(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	const StucIdxTableArr *pIdxTable
+) {
+	encodeDataTag(pAlloc, pData, TAG_IDX_REDIRECTS);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pIdxTable->count, 16);
+	for (I32 i = 0; i < pIdxTable->count; ++i) {
+		StucIdxTable *pTable = pIdxTable->pArr + i;
+		stucEncodeValue(pAlloc, pData, (U8 *)&pTable->idx, 16);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pTable->table.count, 8);
+		PIX_ERR_ASSERT("", !pData->nextBitIdx);
+		I32 countMem = pData->byteIdx;
+		stucEncodeValue(pAlloc, pData, &(U8){0}, 8);
+		I32 count = 0;
+		for (I32 j = 0; j < pTable->table.count; ++j) {
+			if (pTable->table.pArr[j] >= 0) {
+				++count;
+				stucEncodeValue(pAlloc, pData, (U8 *)&j, 8);//local
+				stucEncodeValue(pAlloc, pData, (U8 *)&pTable->table.pArr[j], 8);//global
+			}
+		}
+		PIX_ERR_ASSERT("", count <= UINT8_MAX);
+		pData->pString[countMem] = (U8)count;
+	}
+}
+
+typedef struct MappingOpt {
+	F32 wScale;
+	F32 receiveLen;
+} MappingOpt;
+
+typedef struct MatMapEntry {
+	PixuctHTableEntryCore core;
+	I32 linIdx;
+	StucMap pMap;
+	MappingOpt opt;
+} MatMapEntry;
+
+typedef struct MatMapEntryInit {
+	StucMap pMap;
+	MappingOpt opt;
+} MatMapEntryInit;
+
+static
+void matMapEntryInit(
+	void *pUserData,
+	PixuctHTableEntryCore *pCore,
+	const void *pKeyData,
+	void *pInitInfo,
+	I32 linIdx
+) {
+	MatMapEntryInit *pInit = (MatMapEntryInit *)pInitInfo;
+	MatMapEntry *pEntry = (MatMapEntry *)pCore;
+	pEntry->linIdx = linIdx;
+	pEntry->pMap = pInit->pMap;
+	pEntry->opt = pInit->opt;
+}
+
+static
+bool matMapEntryCmp(
+	const PixuctHTableEntryCore *pEntry,
+	const void *pKeyData,
+	const void *pInitInfo
+) {
+	return !strncmp(((MatMapEntry *)pEntry)->pMap->pName, pKeyData, pixioPathMaxGet());
+}
+
+static
+void encodeBlendConfigOverride(
+	const StucAlloc *pAlloc,
+	ByteString *pCommonBuf,
+	const StucTypeDefault *pDefault,
+	const StucBlendConfig *pBlendConfig
+) {
+	UBitField8 flags =
+		(pBlendConfig->blend != pDefault->blendConfig.blend) |
+		(pBlendConfig->fMax != pDefault->blendConfig.fMax) << 1 |
+		(pBlendConfig->fMin != pDefault->blendConfig.fMin) << 2 |
+		(pBlendConfig->iMax != pDefault->blendConfig.iMax) << 3 |
+		(pBlendConfig->iMin != pDefault->blendConfig.iMin) << 4 |
+		(pBlendConfig->opacity != pDefault->blendConfig.opacity) << 5 |
+		(pBlendConfig->clamp != pDefault->blendConfig.clamp) << 6 |
+		(pBlendConfig->order != pDefault->blendConfig.order) << 7;
+	stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&flags, 8);
+	if (flags & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->blend, 8);
+	}
+	if (flags >> 1 & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->fMax, 64);
+	}
+	if (flags >> 2 & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->fMin, 64);
+	}
+	if (flags >> 3 & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->iMax, 64);
+	}
+	if (flags >> 4 & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->iMin, 64);
+	}
+	if (flags >> 5 & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->opacity, 32);
+	}
+	if (flags >> 6 & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->clamp, 1);
+	}
+	if (flags >> 7 & 0x1) {
+		stucEncodeValue(pAlloc, pCommonBuf, (U8 *)&pBlendConfig->order, 1);
+	}
+}
+
+static
+void encodeBlendOpts(
+	StucMapExport *pHandle,
+	const StucMesh *pMesh,
+	StucMapArrEntry *pMapArrEntry,
+	const MatMapEntry *pMatMapEntry,
+	ByteString *pBlendOptBuf,
+	bool blendOptOverride
+) {
+	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	for (StucDomain domain = STUC_DOMAIN_FACE; domain <= STUC_DOMAIN_VERT; ++domain) {
+		StucBlendOptArr *pArr = pMapArrEntry->blendOptArr + domain; 
+		const AttribArray *pAttribArr = stucGetAttribArrFromDomainConst(pMesh, domain);
+
+		I32 countBytePos = pBlendOptBuf->byteIdx;
+		stucEncodeValue(pAlloc, pBlendOptBuf, (U8[]){0, 0}, 16);
+		I32 count = 0;
+		for (I32 j = 0; j < pArr->count; ++j) {
+			const Attrib *pAttrib = pAttribArr->pArr + pArr->pArr[j].attrib;
+			const StucTypeDefault *pDefault = stucGetTypeDefaultConfig(
+				&pHandle->pCtx->typeDefaults,
+				pAttrib->core.type
+			);
+			BlendConfig *pBlendConfig = &pArr->pArr[j].blendConfig;
+			if (memcmp(
+				pBlendConfig,
+				&pDefault->blendConfig,
+				sizeof(BlendConfig))
+			) {
+				stucEncodeValue(pAlloc, pBlendOptBuf, (U8 *)&pArr->pArr[j].attrib, 16);
+				stucEncodeValue(pAlloc, pBlendOptBuf, (U8 *)&pAttrib->core.type, 8);
+				encodeBlendConfigOverride(pAlloc, pBlendOptBuf, pDefault, pBlendConfig);
+				++count;
+			}
+		}
+		if (count) {
+			blendOptOverride = true;
+		}
+		*(I16 *)&pBlendOptBuf->pString[countBytePos] = count;
+	}
+}
+
+static
+void optsFinalEncode(
+	StucMapExport *pHandle,
+	MatMapEntry *pMatMapEntry,
+	I32 matIdx,
+	ByteString *pBlendOpt,
+	bool blendOptOverride,
+	bool wScaleOverride,
+	bool receiveOverride
+) {
+	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	ByteString *pData = &pHandle->data;
+	UBitField8 header = !!blendOptOverride | wScaleOverride << 1 | receiveOverride << 2;
+	stucEncodeValue(pAlloc, pData, (U8 *)&matIdx, 16);
+	stucEncodeValue(pAlloc, pData, (U8 *)&header, 8);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMatMapEntry->linIdx, 16);
+	if (blendOptOverride) {
+		reallocByteStringIfNeeded(pAlloc, pData, (I64)pBlendOpt->byteIdx * 8);
+		memcpy(pData->pString, pBlendOpt->pString, pBlendOpt->byteIdx);
+		pData->byteIdx += pBlendOpt->byteIdx;
+	}
+	if (pBlendOpt->pString) {
+		pAlloc->fpFree(pBlendOpt->pString);
+	}
+	if (wScaleOverride) {
+		stucEncodeValue(pAlloc, pData, (U8 *)&pMatMapEntry->opt.wScale, 32);
+	}
+	if (receiveOverride) {
+		stucEncodeValue(pAlloc, pData, (U8 *)&pMatMapEntry->opt.receiveLen, 32);
+	}
+}
+
+static
+StucErr encodeMappingOpt(
+	StucMapExport *pHandle,
+	const StucMesh *pMesh,
+	const StucMapArr *pMapArr,
+	const AttribIndexedArr *pIdxAttribArr,
+	const StucIdxTableArr *pIdxTable,
+	F32 wScale,
+	F32 receiveLen,
+	I32 *pCount
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	ByteString *pData = &pHandle->data;
+
+	StucMesh meshCpy = *pMesh;
+	err = stucAttemptToSetMissingActiveDomains(&meshCpy);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	const Attrib *pAttrib =
+		stucGetActiveAttribConst(pHandle->pCtx, &meshCpy, STUC_ATTRIB_USE_IDX);
+	encodeDataTag(pAlloc, pData, TAG_MAP_OVERRIDES);
+	I32 countDataPos = pData->byteIdx;
+	stucEncodeValue(pAlloc, pData, (U8[]){0, 0}, 16);
+	I32 count = 0;
+	const AttribIndexed *pMats =
+		stucGetAttribIndexedInternConst(pIdxAttribArr, pAttrib->core.name);
+	intptr_t attribIdx = (intptr_t)pMats - (intptr_t)pIdxAttribArr->pArr;
+	for (I32 i = 0; i < pMapArr->count; ++i) {
+		I32 globMatIdx = pIdxTable->pArr[attribIdx].table.pArr[i];
+		if (globMatIdx == -2) {
+			continue;//mat is not use in mesh
+		}
+		++count;
+		MappingOpt mappingOpt = {
+			.wScale = wScale,
+			.receiveLen = receiveLen
+		};
+		MatMapEntry *pEntry = NULL;
+		pixuctHTableGet(
+			&pHandle->mapTable,
+			0,
+			pMapArr->pArr[i].map.ptr->pName,
+			(void **)&pEntry,
+			true,
+			&(MatMapEntryInit) {.pMap = pMapArr->pArr[i].map.ptr, .opt = mappingOpt},
+			stucKeyFromPath, NULL, matMapEntryInit, matMapEntryCmp
+		);
+		bool wScaleOverride = pEntry->opt.wScale != wScale;
+		bool receiveOverride = pEntry->opt.receiveLen != receiveLen;
+		bool blendOptOverride = false;
+		ByteString blendOptBuf = {0};
+		encodeBlendOpts(
+			pHandle,
+			&meshCpy,
+			pMapArr->pArr + i,
+			pEntry,
+			&blendOptBuf,
+			&blendOptOverride
+		);
+		optsFinalEncode(
+			pHandle,
+			pEntry,
+			pMapArr->pArr[i].matIdx,
+			&blendOptBuf,
+			blendOptOverride, wScaleOverride, receiveOverride
+		);
+	}
+	*(I16 *)&pData->pString[countDataPos] = count;
+	*pCount = count;
+	return err;
+}
+
+static
+void quantAttribAdd(
+	const StucMesh *pMesh,
+	MeshQuant *pQuant,
+	StucAttribUse use,
+	AttribType type,
+	I32 bits
+) {
+	const StucAttribActive *pActive = pMesh->activeAttribs + use;
+	if (!bits || !pActive->active) {
+		return;
+	}
+	const AttribArray *pArr = stucGetAttribArrFromDomainConst(pMesh, pActive->domain);
+	if (!pArr || pActive->idx < 0 || pActive->idx >= pArr->count) {
+		return;
+	}
+	const Attrib *pAttrib = pArr->pArr + pActive->idx;
+	if (pAttrib->core.type != type) {
+		return;//only F32 vectors are quantized
+	}
+	QuantAttrib *pQuantAttrib = pQuant->attribs + pQuant->count;
+	++pQuant->count;
+	*pQuantAttrib = (QuantAttrib){
+		.pAttrib = pAttrib,
+		.idx = pActive->idx,
+		.domain = pActive->domain,
+		.use = use,
+		.bits = bits,
+		.compCount = use == STUC_ATTRIB_USE_UV || use == STUC_ATTRIB_USE_NORMAL ? 2 : 3
+	};
+	if (use == STUC_ATTRIB_USE_NORMAL) {
+		for (I32 i = 0; i < pQuantAttrib->compCount; ++i) {
+			pQuantAttrib->min[i] = -1.0f;
+			pQuantAttrib->max[i] = 1.0f;
+		}
+		return;
+	}
+	I32 dataLen = stucDomainCountGetIntern(pMesh, pActive->domain);
+	for (I32 i = 0; i < pQuantAttrib->compCount; ++i) {
+		pQuantAttrib->min[i] = dataLen ? FLT_MAX : .0f;
+		pQuantAttrib->max[i] = dataLen ? -FLT_MAX : .0f;
+	}
+	for (I32 i = 0; i < dataLen; ++i) {
+		const F32 *pValue = stucAttribAsVoidConst(&pAttrib->core, i);
+		for (I32 j = 0; j < pQuantAttrib->compCount; ++j) {
+			pQuantAttrib->min[j] = PIXM_MIN(pQuantAttrib->min[j], pValue[j]);
+			pQuantAttrib->max[j] = PIXM_MAX(pQuantAttrib->max[j], pValue[j]);
+		}
+	}
+}
+
+static
+void getMeshQuant(const StucMapQuantize *pOpts, const StucMesh *pMesh, MeshQuant *pQuant) {
+	*pQuant = (MeshQuant){.deltaLists = pOpts->deltaLists};
+	quantAttribAdd(pMesh, pQuant, STUC_ATTRIB_USE_POS, STUC_ATTRIB_V3_F32, pOpts->posBits);
+	quantAttribAdd(pMesh, pQuant, STUC_ATTRIB_USE_UV, STUC_ATTRIB_V2_F32, pOpts->uvBits);
+	quantAttribAdd(
+		pMesh,
+		pQuant,
+		STUC_ATTRIB_USE_NORMAL,
+		STUC_ATTRIB_V3_F32,
+		pOpts->normalBits
+	);
+}
+
+static
+void encodeQuantizedAttribs(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	const StucMesh *pMesh,
+	const MeshQuant *pQuant
+) {
+	U8 flags = pQuant->deltaLists;
+	stucEncodeValue(pAlloc, pData, &flags, 8);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pQuant->count, 8);
+	for (I32 i = 0; i < pQuant->count; ++i) {
+		const QuantAttrib *pAttrib = pQuant->attribs + i;
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttrib->domain, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttrib->idx, 16);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttrib->use, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttrib->bits, 8);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pAttrib->compCount, 8);
+		for (I32 j = 0; j < pAttrib->compCount; ++j) {
+			stucEncodeValue(pAlloc, pData, (U8 *)&pAttrib->min[j], 32);
+			stucEncodeValue(pAlloc, pData, (U8 *)&pAttrib->max[j], 32);
+		}
+	}
+	for (I32 i = 0; i < pQuant->count; ++i) {
+		const QuantAttrib *pAttrib = pQuant->attribs + i;
+		I32 dataLen = stucDomainCountGetIntern(pMesh, pAttrib->domain);
+		for (I32 j = 0; j < dataLen; ++j) {
+			const F32 *pValue = stucAttribAsVoidConst(&pAttrib->pAttrib->core, j);
+			F32 comps[3] = {0};
+			if (pAttrib->use == STUC_ATTRIB_USE_NORMAL) {
+				octEncode(pValue, comps);
+			}
+			else {
+				memcpy(comps, pValue, pAttrib->compCount * sizeof(F32));
+			}
+			for (I32 k = 0; k < pAttrib->compCount; ++k) {
+				U32 value =
+					quantize(comps[k], pAttrib->min[k], pAttrib->max[k], pAttrib->bits);
+				stucEncodeValue(pAlloc, pData, (U8 *)&value, pAttrib->bits);
+			}
+		}
+	}
+}
+
+static
+void reorderAttribArr(
+	const StucAlloc *pAlloc,
+	const AttribArray *pSrc,
+	AttribArray *pDest,
+	const I32 *pMap,
+	I32 dataLen
+) {
+	if (!pSrc->count) {
+		pDest->pArr = NULL;
+		return;
+	}
+	pDest->pArr = pAlloc->fpMalloc(pSrc->count * sizeof(Attrib));
+	for (I32 i = 0; i < pSrc->count; ++i) {
+		Attrib *pAttrib = pDest->pArr + i;
+		*pAttrib = pSrc->pArr[i];
+		I32 size = stucGetAttribSizeIntern(pAttrib->core.type);
+		pAttrib->core.pData = dataLen ? pAlloc->fpMalloc((I64)size * dataLen) : NULL;
+		for (I32 j = 0; j < dataLen; ++j) {
+			stucCopyAttribCore(&pAttrib->core, pMap[j], &pSrc->pArr[i].core, j);
+		}
+	}
+}
+
+//renumbers verts and edges in the order corners first reference them,
+//so corner and edge deltas stay small, and verts are read in order on load.
+//Anything unreferenced keeps its relative order at the end
+static
+void reorderMesh(const StucAlloc *pAlloc, const StucMesh *pMesh, StucMesh *pOut) {
+	*pOut = *pMesh;
+	I32 *pVertMap = pAlloc->fpMalloc(pMesh->vertCount * sizeof(I32));
+	I32 *pEdgeMap = pAlloc->fpMalloc(pMesh->edgeCount * sizeof(I32));
+	memset(pVertMap, -1, pMesh->vertCount * sizeof(I32));
+	memset(pEdgeMap, -1, pMesh->edgeCount * sizeof(I32));
+	pOut->pCorners = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(I32));
+	pOut->pEdges = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(I32));
+	I32 vertCount = 0;
+	I32 edgeCount = 0;
+	for (I32 i = 0; i < pMesh->cornerCount; ++i) {
+		I32 vert = pMesh->pCorners[i];
+		if (pVertMap[vert] == -1) {
+			pVertMap[vert] = vertCount;
+			++vertCount;
+		}
+		pOut->pCorners[i] = pVertMap[vert];
+		I32 edge = pMesh->pEdges[i];
+		if (pEdgeMap[edge] == -1) {
+			pEdgeMap[edge] = edgeCount;
+			++edgeCount;
+		}
+		pOut->pEdges[i] = pEdgeMap[edge];
+	}
+	for (I32 i = 0; i < pMesh->vertCount; ++i) {
+		if (pVertMap[i] == -1) {
+			pVertMap[i] = vertCount;
+			++vertCount;
+		}
+	}
+	for (I32 i = 0; i < pMesh->edgeCount; ++i) {
+		if (pEdgeMap[i] == -1) {
+			pEdgeMap[i] = edgeCount;
+			++edgeCount;
+		}
+	}
+	reorderAttribArr(pAlloc, &pMesh->vertAttribs, &pOut->vertAttribs, pVertMap, pMesh->vertCount);
+	reorderAttribArr(pAlloc, &pMesh->edgeAttribs, &pOut->edgeAttribs, pEdgeMap, pMesh->edgeCount);
+	pAlloc->fpFree(pVertMap);
+	pAlloc->fpFree(pEdgeMap);
+}
+
+static
+void reorderAttribArrDestroy(const StucAlloc *pAlloc, AttribArray *pArr) {
+	for (I32 i = 0; i < pArr->count; ++i) {
+		if (pArr->pArr[i].core.pData) {
+			pAlloc->fpFree(pArr->pArr[i].core.pData);
+		}
+	}
+	if (pArr->pArr) {
+		pAlloc->fpFree(pArr->pArr);
+	}
+}
+
+static
+void reorderMeshDestroy(const StucAlloc *pAlloc, StucMesh *pMesh) {
+	pAlloc->fpFree(pMesh->pCorners);
+	pAlloc->fpFree(pMesh->pEdges);
+	reorderAttribArrDestroy(pAlloc, &pMesh->vertAttribs);
+	reorderAttribArrDestroy(pAlloc, &pMesh->edgeAttribs);
+}
+
+//same as reorderAttribArr, but each dest element is copied from pSrcIdx[i]
+static
+void gatherAttribArr(
+	const StucAlloc *pAlloc,
+	const AttribArray *pSrc,
+	AttribArray *pDest,
+	const I32 *pSrcIdx,
+	I32 dataLen
+) {
+	*pDest = *pSrc;
+	if (!pSrc->count) {
+		pDest->pArr = NULL;
+		return;
+	}
+	pDest->pArr = pAlloc->fpMalloc(pSrc->count * sizeof(Attrib));
+	for (I32 i = 0; i < pSrc->count; ++i) {
+		Attrib *pAttrib = pDest->pArr + i;
+		*pAttrib = pSrc->pArr[i];
+		I32 size = stucGetAttribSizeIntern(pAttrib->core.type);
+		pAttrib->core.pData = dataLen ? pAlloc->fpMalloc((I64)size * dataLen) : NULL;
+		for (I32 j = 0; j < dataLen; ++j) {
+			stucCopyAttribCore(&pAttrib->core, j, &pSrc->pArr[i].core, pSrcIdx[j]);
+		}
+	}
+}
+
+typedef struct DecimateKey {
+	U64 key;
+	I32 idx;
+} DecimateKey;
+
+static
+I32 decimateKeyCmp(const void *pA, const void *pB) {
+	const DecimateKey *pKeyA = pA;
+	const DecimateKey *pKeyB = pB;
+	if (pKeyA->key != pKeyB->key) {
+		return (pKeyA->key > pKeyB->key) - (pKeyA->key < pKeyB->key);
+	}
+	return (pKeyA->idx > pKeyB->idx) - (pKeyA->idx < pKeyB->idx);
+}
+
+//21 bits per axis. Cells far enough apart to wrap are merged,
+//which doesn't occur at the cell sizes lods are built with
+static
+U64 getDecimateCellKey(const V3_F32 *pPos, F32 cellSize) {
+	U64 key = 0;
+	for (I32 i = 0; i < 3; ++i) {
+		I64 cell = (I64)floorf(pPos->d[i] / cellSize);
+		key |= ((U64)cell & 0x1fffff) << i * 21;
+	}
+	return key;
+}
+
+static
+const Attrib *getDecimatePosAttrib(const StucMesh *pMesh) {
+	const StucAttribActive *pActive = pMesh->activeAttribs + STUC_ATTRIB_USE_POS;
+	if (!pActive->active ||
+		pActive->domain != STUC_DOMAIN_VERT ||
+		pActive->idx < 0 ||
+		pActive->idx >= pMesh->vertAttribs.count
+	) {
+		return NULL;
+	}
+	const Attrib *pAttrib = pMesh->vertAttribs.pArr + pActive->idx;
+	return pAttrib->core.type == STUC_ATTRIB_V3_F32 ? pAttrib : NULL;
+}
+
+static
+I32 decimateI32Cmp(const void *pA, const void *pB) {
+	I32 a = *(const I32 *)pA;
+	I32 b = *(const I32 *)pB;
+	return (a > b) - (a < b);
+}
+
+static
+bool decimateFaceHasRepeat(const I32 *pCells, I32 size) {
+	for (I32 i = 0; i < size; ++i) {
+		for (I32 j = i + 1; j < size; ++j) {
+			if (pCells[i] == pCells[j]) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//faces that collapsed onto the same set of cells as an earlier face are dropped
+static
+void decimateDropDupFaces(
+	const StucAlloc *pAlloc,
+	const StucMesh *pOut,
+	DecimateKey *pKeys,
+	bool *pDrop
+) {
+	I32 *pSorted = pAlloc->fpMalloc(PIXM_MAX(pOut->cornerCount, 1) * sizeof(I32));
+	memcpy(pSorted, pOut->pCorners, pOut->cornerCount * sizeof(I32));
+	for (I32 i = 0; i < pOut->faceCount; ++i) {
+		I32 start = pOut->pFaces[i];
+		I32 size = pOut->pFaces[i + 1] - start;
+		qsort(pSorted + start, size, sizeof(I32), decimateI32Cmp);
+		U64 hash = 14695981039346656037ull;
+		for (I32 j = 0; j < size; ++j) {
+			hash = (hash ^ (U64)(U32)pSorted[start + j]) * 1099511628211ull;
+		}
+		pKeys[i] = (DecimateKey){.key = hash, .idx = i};
+	}
+	qsort(pKeys, pOut->faceCount, sizeof(DecimateKey), decimateKeyCmp);
+	for (I32 i = 0, groupStart = 0; i < pOut->faceCount; ++i) {
+		if (pKeys[i].key != pKeys[groupStart].key) {
+			groupStart = i;
+		}
+		I32 face = pKeys[i].idx;
+		I32 size = pOut->pFaces[face + 1] - pOut->pFaces[face];
+		for (I32 j = groupStart; j < i; ++j) {
+			I32 other = pKeys[j].idx;
+			if (!pDrop[other] &&
+				pOut->pFaces[other + 1] - pOut->pFaces[other] == size &&
+				!memcmp(
+					pSorted + pOut->pFaces[face],
+					pSorted + pOut->pFaces[other],
+					size * sizeof(I32)
+				)
+			) {
+				pDrop[face] = true;
+				break;
+			}
+		}
+	}
+	pAlloc->fpFree(pSorted);
+}
+
+//clustering can fold separate surfaces together, leaving edges with more than
+//2 faces. Faces past the 2nd on any edge are dropped, keeping the output manifold
+static
+void decimateDropNonManifold(
+	const StucMesh *pOut,
+	const I32 *pCornerFace,
+	DecimateKey *pKeys,
+	bool *pDrop
+) {
+	I32 keyCount = 0;
+	for (I32 i = 0; i < pOut->faceCount; ++i) {
+		if (pDrop[i]) {
+			continue;
+		}
+		I32 start = pOut->pFaces[i];
+		I32 end = pOut->pFaces[i + 1];
+		for (I32 j = start; j < end; ++j) {
+			I32 a = pOut->pCorners[j];
+			I32 b = pOut->pCorners[j + 1 < end ? j + 1 : start];
+			pKeys[keyCount] = (DecimateKey){
+				.key = (U64)PIXM_MIN(a, b) << 32 | (U64)PIXM_MAX(a, b),
+				.idx = j
+			};
+			++keyCount;
+		}
+	}
+	qsort(pKeys, keyCount, sizeof(DecimateKey), decimateKeyCmp);
+	for (I32 i = 0, groupStart = 0, faces = 0; i < keyCount; ++i) {
+		if (pKeys[i].key != pKeys[groupStart].key) {
+			groupStart = i;
+			faces = 0;
+		}
+		I32 face = pCornerFace[pKeys[i].idx];
+		if (pDrop[face]) {
+			continue;
+		}
+		if (faces == 2) {
+			pDrop[face] = true;
+			continue;
+		}
+		++faces;
+	}
+}
+
+static
+void decimateCompactFaces(
+	StucMesh *pOut,
+	I32 *pFaceSrc,
+	I32 *pCornerSrc,
+	const bool *pDrop
+) {
+	I32 faceCount = 0;
+	I32 cornerCount = 0;
+	for (I32 i = 0; i < pOut->faceCount; ++i) {
+		if (pDrop[i]) {
+			continue;
+		}
+		I32 start = pOut->pFaces[i];
+		I32 size = pOut->pFaces[i + 1] - start;
+		memmove(pOut->pCorners + cornerCount, pOut->pCorners + start, size * sizeof(I32));
+		memmove(pCornerSrc + cornerCount, pCornerSrc + start, size * sizeof(I32));
+		pOut->pFaces[faceCount] = cornerCount;
+		pFaceSrc[faceCount] = pFaceSrc[i];
+		++faceCount;
+		cornerCount += size;
+	}
+	pOut->faceCount = faceCount;
+	pOut->cornerCount = cornerCount;
+	pOut->pFaces[faceCount] = cornerCount;
+}
+
+//vertex clustering. Verts are snapped to a grid of cellSize, verts in the same cell
+//are merged, and faces left with less than 3 corners, or with a repeated vert, are
+//removed, as are duplicate faces and faces that would make an edge non-manifold. Attribs are
+//copied from the first face, corner, edge, or vert mapping to each output element,
+//except for pos, which is the avg of the cell's verts.
+//Free with decimatedMeshDestroy
+static
+void decimateMesh(
+	const StucAlloc *pAlloc,
+	const StucMesh *pMesh,
+	const Attrib *pPos,
+	F32 cellSize,
+	StucMesh *pOut
+) {
+	*pOut = (StucMesh){.type = pMesh->type};
+	memcpy(pOut->activeAttribs, pMesh->activeAttribs, sizeof(pMesh->activeAttribs));
+	DecimateKey *pKeys = pAlloc->fpMalloc(
+		PIXM_MAX(pMesh->vertCount, pMesh->cornerCount) * sizeof(DecimateKey)
+	);
+	for (I32 i = 0; i < pMesh->vertCount; ++i) {
+		pKeys[i] = (DecimateKey){
+			.key = getDecimateCellKey(stucAttribAsVoidConst(&pPos->core, i), cellSize),
+			.idx = i
+		};
+	}
+	qsort(pKeys, pMesh->vertCount, sizeof(DecimateKey), decimateKeyCmp);
+	I32 *pVertCell = pAlloc->fpMalloc(pMesh->vertCount * sizeof(I32));
+	I32 cellCount = 0;
+	for (I32 i = 0; i < pMesh->vertCount; ++i) {
+		if (i && pKeys[i].key != pKeys[i - 1].key) {
+			++cellCount;
+		}
+		pVertCell[pKeys[i].idx] = cellCount;
+	}
+	cellCount += pMesh->vertCount > 0;
+	V3_F32 *pCellPos = pAlloc->fpCalloc(cellCount, sizeof(V3_F32));
+	I32 *pCellSize = pAlloc->fpCalloc(cellCount, sizeof(I32));
+	for (I32 i = 0; i < pMesh->vertCount; ++i) {
+		const V3_F32 *pVertPos = stucAttribAsVoidConst(&pPos->core, i);
+		pCellPos[pVertCell[i]] = _(pCellPos[pVertCell[i]] V3ADD *pVertPos);
+		++pCellSize[pVertCell[i]];
+	}
+
+	//corners are set to cells for now, and are replaced with verts below
+	pOut->pFaces = pAlloc->fpMalloc((pMesh->faceCount + 1) * sizeof(I32));
+	pOut->pCorners = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(I32));
+	pOut->pEdges = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(I32));
+	I32 *pFaceSrc = pAlloc->fpMalloc(pMesh->faceCount * sizeof(I32));
+	I32 *pCornerSrc = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(I32));
+	I32 *pCornerFace = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(I32));
+	for (I32 i = 0; i < pMesh->faceCount; ++i) {
+		FaceRange face = stucGetFaceRange(pMesh, i);
+		I32 start = pOut->cornerCount;
+		for (I32 j = 0; j < face.size; ++j) {
+			I32 cell = pVertCell[pMesh->pCorners[face.start + j]];
+			if (pOut->cornerCount > start && pOut->pCorners[pOut->cornerCount - 1] == cell) {
+				continue;
+			}
+			pOut->pCorners[pOut->cornerCount] = cell;
+			pCornerSrc[pOut->cornerCount] = face.start + j;
+			++pOut->cornerCount;
+		}
+		if (pOut->cornerCount - start > 1 &&
+			pOut->pCorners[pOut->cornerCount - 1] == pOut->pCorners[start]
+		) {
+			--pOut->cornerCount;
+		}
+		I32 size = pOut->cornerCount - start;
+		if (size < 3 || decimateFaceHasRepeat(pOut->pCorners + start, size)) {
+			pOut->cornerCount = start;
+			continue;
+		}
+		for (I32 j = start; j < pOut->cornerCount; ++j) {
+			pCornerFace[j] = pOut->faceCount;
+		}
+		pOut->pFaces[pOut->faceCount] = start;
+		pFaceSrc[pOut->faceCount] = i;
+		++pOut->faceCount;
+	}
+	pOut->pFaces[pOut->faceCount] = pOut->cornerCount;
+	bool *pDrop = pAlloc->fpCalloc(PIXM_MAX(pOut->faceCount, 1), sizeof(bool));
+	decimateDropDupFaces(pAlloc, pOut, pKeys, pDrop);
+	decimateDropNonManifold(pOut, pCornerFace, pKeys, pDrop);
+	decimateCompactFaces(pOut, pFaceSrc, pCornerSrc, pDrop);
+	pAlloc->fpFree(pDrop);
+	pAlloc->fpFree(pCornerFace);
+
+	//cells no face references are dropped
+	I32 *pCellVert = pAlloc->fpMalloc(cellCount * sizeof(I32));
+	memset(pCellVert, -1, cellCount * sizeof(I32));
+	I32 *pVertSrc = pAlloc->fpMalloc(cellCount * sizeof(I32));
+	for (I32 i = 0; i < pOut->cornerCount; ++i) {
+		I32 cell = pOut->pCorners[i];
+		if (pCellVert[cell] == -1) {
+			pCellVert[cell] = pOut->vertCount;
+			pVertSrc[pOut->vertCount] = pMesh->pCorners[pCornerSrc[i]];
+			++pOut->vertCount;
+		}
+		pOut->pCorners[i] = pCellVert[cell];
+	}
+
+	I32 keyCount = 0;
+	for (I32 i = 0; i < pOut->faceCount; ++i) {
+		I32 start = pOut->pFaces[i];
+		I32 end = pOut->pFaces[i + 1];
+		for (I32 j = start; j < end; ++j) {
+			I32 a = pOut->pCorners[j];
+			I32 b = pOut->pCorners[j + 1 < end ? j + 1 : start];
+			pKeys[keyCount] = (DecimateKey){
+				.key = (U64)PIXM_MIN(a, b) << 32 | (U64)PIXM_MAX(a, b),
+				.idx = j
+			};
+			++keyCount;
+		}
+	}
+	qsort(pKeys, keyCount, sizeof(DecimateKey), decimateKeyCmp);
+	I32 *pEdgeSrc = pAlloc->fpMalloc(PIXM_MAX(keyCount, 1) * sizeof(I32));
+	for (I32 i = 0; i < keyCount; ++i) {
+		if (!i || pKeys[i].key != pKeys[i - 1].key) {
+			pEdgeSrc[pOut->edgeCount] = pMesh->pEdges[pCornerSrc[pKeys[i].idx]];
+			++pOut->edgeCount;
+		}
+		pOut->pEdges[pKeys[i].idx] = pOut->edgeCount - 1;
+	}
+
+	gatherAttribArr(pAlloc, &pMesh->meshAttribs, &pOut->meshAttribs, (I32[1]){0}, 1);
+	gatherAttribArr(pAlloc, &pMesh->faceAttribs, &pOut->faceAttribs, pFaceSrc, pOut->faceCount);
+	gatherAttribArr(
+		pAlloc,
+		&pMesh->cornerAttribs,
+		&pOut->cornerAttribs,
+		pCornerSrc,
+		pOut->cornerCount
+	);
+	gatherAttribArr(pAlloc, &pMesh->edgeAttribs, &pOut->edgeAttribs, pEdgeSrc, pOut->edgeCount);
+	gatherAttribArr(pAlloc, &pMesh->vertAttribs, &pOut->vertAttribs, pVertSrc, pOut->vertCount);
+	AttribCore *pOutPos =
+		&pOut->vertAttribs.pArr[pMesh->activeAttribs[STUC_ATTRIB_USE_POS].idx].core;
+	for (I32 i = 0; i < cellCount; ++i) {
+		if (pCellVert[i] != -1) {
+			*stucAttribAsV3(pOutPos, pCellVert[i]) =
+				_(pCellPos[i] V3DIVS (F32)pCellSize[i]);
+		}
+	}
+	pAlloc->fpFree(pKeys);
+	pAlloc->fpFree(pVertCell);
+	pAlloc->fpFree(pCellPos);
+	pAlloc->fpFree(pCellSize);
+	pAlloc->fpFree(pFaceSrc);
+	pAlloc->fpFree(pCornerSrc);
+	pAlloc->fpFree(pCellVert);
+	pAlloc->fpFree(pVertSrc);
+	pAlloc->fpFree(pEdgeSrc);
+}
+
+static
+void decimatedMeshDestroy(const StucAlloc *pAlloc, StucMesh *pMesh) {
+	pAlloc->fpFree(pMesh->pFaces);
+	pAlloc->fpFree(pMesh->pCorners);
+	pAlloc->fpFree(pMesh->pEdges);
+	reorderAttribArrDestroy(pAlloc, &pMesh->meshAttribs);
+	reorderAttribArrDestroy(pAlloc, &pMesh->faceAttribs);
+	reorderAttribArrDestroy(pAlloc, &pMesh->cornerAttribs);
+	reorderAttribArrDestroy(pAlloc, &pMesh->edgeAttribs);
+	reorderAttribArrDestroy(pAlloc, &pMesh->vertAttribs);
+	*pMesh = (StucMesh){0};
+}
+
+//mesh data is encoded in sections, each starting with a byte aligned data tag,
+//so they can be encoded into separate buffers in parallel and then joined
+typedef enum MeshSection {
+	MESH_SECTION_FACES,
+	MESH_SECTION_FACE_ATTRIBS,
+	MESH_SECTION_CORNERS,
+	MESH_SECTION_CORNER_ATTRIBS,
+	MESH_SECTION_EDGE_ATTRIBS,
+	MESH_SECTION_VERT_ATTRIBS,
+	MESH_SECTION_COUNT
+} MeshSection;
+
+typedef struct MeshEncodeShared {
+	StucMesh *pMesh;
+	const MeshQuant *pQuant;
+	ByteString *pSections;
+} MeshEncodeShared;
+
+typedef struct MeshEncodeJobArgs {
+	JobArgs core;
+} MeshEncodeJobArgs;
+
+static
+I64 getAttribArrEncodedSize(const AttribArray *pAttribs, I32 dataLen, const MeshQuant *pQuant) {
+	I64 size = 0;
+	for (I32 i = 0; i < pAttribs->count; ++i) {
+		const Attrib *pAttrib = pAttribs->pArr + i;
+		if (pAttrib->core.type == STUC_ATTRIB_STRING || isAttribQuantized(pQuant, pAttrib)) {
+			continue;//strings are variable length, and grow the buffer as needed
+		}
+		size += (I64)stucGetAttribSizeIntern(pAttrib->core.type) * dataLen;
+	}
+	return size;
+}
+
+//exact unless the section has string attribs or delta coded lists,
+//which grow the buffer as they're encoded
+static
+I64 getMeshSectionSize(const StucMesh *pMesh, const MeshQuant *pQuant, MeshSection section) {
+	I64 size = 2; //data tag
+	switch (section) {
+		case MESH_SECTION_FACES:
+			size += 2;
+			size += getAttribArrEncodedSize(&pMesh->meshAttribs, 1, pQuant);
+			size += pQuant->deltaLists ? 0 : (I64)pMesh->faceCount * 4;
+			break;
+		case MESH_SECTION_FACE_ATTRIBS:
+			size += getAttribArrEncodedSize(&pMesh->faceAttribs, pMesh->faceCount, pQuant);
+			break;
+		case MESH_SECTION_CORNERS:
+			size += pQuant->deltaLists ? 0 : (I64)pMesh->cornerCount * 8;
+			break;
+		case MESH_SECTION_CORNER_ATTRIBS:
+			size +=
+				getAttribArrEncodedSize(&pMesh->cornerAttribs, pMesh->cornerCount, pQuant);
+			break;
+		case MESH_SECTION_EDGE_ATTRIBS:
+			size += getAttribArrEncodedSize(&pMesh->edgeAttribs, pMesh->edgeCount, pQuant);
+			break;
+		case MESH_SECTION_VERT_ATTRIBS:
+			size += getAttribArrEncodedSize(&pMesh->vertAttribs, pMesh->vertCount, pQuant);
+			break;
+		default:
+			PIX_ERR_ASSERT("invalid section", false);
+	}
+	return size;
+}
+
+static
+void encodeMeshSection(
+	const StucAlloc *pAlloc,
+	ByteString *pData,
+	StucMesh *pMesh,
+	const MeshQuant *pQuant,
+	MeshSection section
+) {
+	byteStringReserve(pAlloc, pData, getMeshSectionSize(pMesh, pQuant, section));
+	switch (section) {
+		case MESH_SECTION_FACES:
+			encodeDataTag(pAlloc, pData, TAG_MESH_ATTRIBS);
+			encodeAttribs(pAlloc, pData, &pMesh->meshAttribs, 1, pQuant);
+			encodeDataTag(pAlloc, pData, TAG_FACE_LIST);
+			for (I32 i = 0; i < pMesh->faceCount; ++i) {
+				PIX_ERR_ASSERT("",
+					pMesh->pFaces[i] >= 0 &&
+					pMesh->pFaces[i] < pMesh->cornerCount
+				);
+			}
+			if (pQuant->deltaLists) {
+				encodeDeltaList(pAlloc, pData, pMesh->pFaces, pMesh->faceCount);
+			}
+			else {
+				//data tags are byte aligned, so lists can be copied as is
+				encodeBytes(pAlloc, pData, pMesh->pFaces, (I64)pMesh->faceCount * 4);
+			}
+			break;
+		case MESH_SECTION_FACE_ATTRIBS:
+			encodeDataTag(pAlloc, pData, TAG_FACE_ATTRIBS);
+			encodeAttribs(pAlloc, pData, &pMesh->faceAttribs, pMesh->faceCount, pQuant);
+			break;
+		case MESH_SECTION_CORNERS:
+			encodeDataTag(pAlloc, pData, TAG_CORNER_AND_EDGE_LISTS);
+			for (I32 i = 0; i < pMesh->cornerCount; ++i) {
+				PIX_ERR_ASSERT("",
+					pMesh->pCorners[i] >= 0 &&
+					pMesh->pCorners[i] < pMesh->vertCount
+				);
+				PIX_ERR_ASSERT("",
+					pMesh->pEdges[i] >= 0 &&
+					pMesh->pEdges[i] < pMesh->edgeCount
+				);
+				if (!pQuant->deltaLists) {
+					encodeBytes(pAlloc, pData, pMesh->pCorners + i, 4);
+					encodeBytes(pAlloc, pData, pMesh->pEdges + i, 4);
+				}
+			}
+			if (pQuant->deltaLists) {
+				//corners and edges aren't interleaved here, as each list's deltas are
+				//relative to the previous entry in the same list
+				encodeDeltaList(pAlloc, pData, pMesh->pCorners, pMesh->cornerCount);
+				encodeDeltaList(pAlloc, pData, pMesh->pEdges, pMesh->cornerCount);
+			}
+			break;
+		case MESH_SECTION_CORNER_ATTRIBS:
+			encodeDataTag(pAlloc, pData, TAG_CORNER_ATTRIBS);
+			encodeAttribs(pAlloc, pData, &pMesh->cornerAttribs, pMesh->cornerCount, pQuant);
+			break;
+		case MESH_SECTION_EDGE_ATTRIBS:
+			encodeDataTag(pAlloc, pData, TAG_EDGE_ATTRIBS);
+			encodeAttribs(pAlloc, pData, &pMesh->edgeAttribs, pMesh->edgeCount, pQuant);
+			break;
+		case MESH_SECTION_VERT_ATTRIBS:
+			encodeDataTag(pAlloc, pData, TAG_VERT_ATTRIBS);
+			encodeAttribs(pAlloc, pData, &pMesh->vertAttribs, pMesh->vertCount, pQuant);
+			break;
+		default:
+			PIX_ERR_ASSERT("invalid section", false);
+	}
+}
+
+static
+I32 meshEncodeJobsGetRange(StucContext pCtx, const void *pShared, void *pInitInfo) {
+	return MESH_SECTION_COUNT;
+}
+
+static
+StucErr meshEncodeJob(void *pArgsVoid) {
+	MeshEncodeJobArgs *pArgs = pArgsVoid;
+	const MeshEncodeShared *pShared = pArgs->core.pShared;
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		encodeMeshSection(
+			&pArgs->core.pCtx->alloc,
+			pShared->pSections + i,
+			pShared->pMesh,
+			pShared->pQuant,
+			i
+		);
+	}
+	return PIX_ERR_SUCCESS;
+}
+
+//sections are joined in order. Each begins byte aligned, so the output matches
+//encoding them serially into pData. Only the last section's trailing bits are
+//left open, as later values may be packed into its last byte
+static
+StucErr encodeMeshSections(
+	StucContext pCtx,
+	ByteString *pData,
+	StucMesh *pMesh,
+	const MeshQuant *pQuant
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	const StucAlloc *pAlloc = &pCtx->alloc;
+	ByteString sections[MESH_SECTION_COUNT] = {0};
+	MeshEncodeShared shared = {.pMesh = pMesh, .pQuant = pQuant, .pSections = sections};
+	I32 jobCount = PIXM_MIN(MESH_SECTION_COUNT, PIX_THREAD_MAX_SUB_MAPPING_JOBS);
+	MeshEncodeJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+	stucMakeJobArgs(
+		pCtx,
+		&shared,
+		&jobCount, jobArgs, sizeof(MeshEncodeJobArgs),
+		NULL,
+		meshEncodeJobsGetRange, NULL
+	);
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, jobArgs, sizeof(MeshEncodeJobArgs),
+		meshEncodeJob
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	if (pData->nextBitIdx) {
+		pData->nextBitIdx = 0;
+		pData->byteIdx++;
+	}
+	I64 size = 0;
+	for (I32 i = 0; i < MESH_SECTION_COUNT; ++i) {
+		size += sections[i].byteIdx + (sections[i].nextBitIdx > 0);
+	}
+	byteStringReserve(pAlloc, pData, size);
+	for (I32 i = 0; i < MESH_SECTION_COUNT; ++i) {
+		const ByteString *pSection = sections + i;
+		I64 sectionSize = pSection->byteIdx + (pSection->nextBitIdx > 0);
+		if (sectionSize) {
+			memcpy(pData->pString + pData->byteIdx, pSection->pString, sectionSize);
+		}
+		bool last = i == MESH_SECTION_COUNT - 1;
+		pData->byteIdx += last ? pSection->byteIdx : sectionSize;
+		pData->nextBitIdx = last ? pSection->nextBitIdx : 0;
+	}
+	PIX_ERR_CATCH(0, err, ;);
+	for (I32 i = 0; i < MESH_SECTION_COUNT; ++i) {
+		if (sections[i].pString) {
+			pAlloc->fpFree(sections[i].pString);
+		}
+	}
+	return err;
+}
+
+static
+StucErr encodeObj(
+	StucMapExport *pHandle,
+	const StucObject *pObj,
+	const StucIdxTableArr *pIdxTable,
+	bool mappingOpt,
+	const StucMapArr *pMapArr,
+	const AttribIndexedArr *pIdxAttribArr,
 	F32 wScale,
-	F32 receiveLen
+	F32 receiveLen,
+	bool checkPosOnly
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	ByteString *pData = &pHandle->data;
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		pObj->pData && pObj->pData->type == STUC_OBJECT_DATA_MESH,
+		"invalid mesh"
+	);
+	StucMesh *pMesh = (StucMesh *)pObj->pData;
+	err = stucValidateMesh(&pHandle->pCtx->alloc, pMesh, false, checkPosOnly);
+	PIX_ERR_RETURN_IFNOT(err, "mesh validation failed");
+	//encode obj header
+	encodeDataTag(pAlloc, pData, TAG_OBJECT);
+	if (pIdxTable && pIdxTable->count) {
+		encodeRedirectTable(pAlloc, pData, pIdxTable);
+	}
+	err = encodeActiveAttribs(pAlloc, pData, pMesh);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	encodeDataTag(pAlloc, pData, TAG_XFORM);
+	for (I32 i = 0; i < 16; ++i) {
+		I32 x = i % 4;
+		I32 y = i / 4;
+		stucEncodeValue(pAlloc, pData, (U8 *)&pObj->transform.d[y][x], 32);
+	}
+	encodeDataTag(pAlloc, pData, TAG_OBJECT_TYPE);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pObj->pData->type, 8);
+	if (!stucCheckIfMesh(*pObj->pData)) {
+		return err;
+	}
+	StucMesh reordered = {0};
+	if (pHandle->quantize.reorder) {
+		reorderMesh(pAlloc, pMesh, &reordered);
+		pMesh = &reordered;
+	}
+	MeshQuant quant = {0};
+	getMeshQuant(&pHandle->quantize, pMesh, &quant);
+	encodeDataTag(pAlloc, pData, TAG_MESH_HEADER);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->meshAttribs.count, 32);
+	encodeAttribMeta(pAlloc, pData, &pMesh->meshAttribs);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->faceAttribs.count, 32);
+	encodeAttribMeta(pAlloc, pData, &pMesh->faceAttribs);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->cornerAttribs.count, 32);
+	encodeAttribMeta(pAlloc, pData, &pMesh->cornerAttribs);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->edgeAttribs.count, 32);
+	encodeAttribMeta(pAlloc, pData, &pMesh->edgeAttribs);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->vertAttribs.count, 32);
+	encodeAttribMeta(pAlloc, pData, &pMesh->vertAttribs);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->faceCount, 32);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->cornerCount, 32);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->edgeCount, 32);
+	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->vertCount, 32);
+	if (quant.count || quant.deltaLists) {
+		encodeDataTag(pAlloc, pData, TAG_QUANTIZE);
+		encodeQuantizedAttribs(pAlloc, pData, pMesh, &quant);
+	}
+	err = encodeMeshSections(pHandle->pCtx, pData, pMesh, &quant);
+	if (pMesh == &reordered) {
+		reorderMeshDestroy(pAlloc, &reordered);
+	}
+	return err;
+}
+
+//the deps a target was mapped with, that're also deps of the file.
+//Maps that aren't in the map table aren't used by any mat in the target mesh
+static
+I32 getBakedTargetDeps(
+	StucMapExport *pHandle,
+	const StucMapArr *pMapArr,
+	BakedTargetDep *pDeps
+) {
+	I32 count = 0;
+	for (I32 i = 0; i < pMapArr->count; ++i) {
+		MatMapEntry *pEntry = NULL;
+		SearchResult result = pixuctHTableGet(
+			&pHandle->mapTable,
+			0,
+			pMapArr->pArr[i].map.ptr->pName,
+			(void **)&pEntry,
+			false,
+			NULL,
+			stucKeyFromPath, NULL, NULL, matMapEntryCmp
+		);
+		if (result != PIX_SEARCH_FOUND) {
+			continue;
+		}
+		pDeps[count] = (BakedTargetDep){
+			.depTreeHash = pMapArr->pArr[i].map.ptr->depTreeHash,
+			.map = pEntry->linIdx
+		};
+		++count;
+	}
+	return count;
+}
+
+static
+StucErr encodeBakedTarget(
+	StucMapExport *pHandle,
+	const StucObject *pObj,
+	const StucMapArr *pMapArr,
+	const AttribIndexedArr *pIdxAttribArr
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucContext pCtx = pHandle->pCtx;
+	const StucAlloc *pAlloc = &pCtx->alloc;
+	ByteString *pData = &pHandle->data;
+	StucMesh meshOut = {0};
+	AttribIndexedArr outIdxAttribArr = {0};
+	BakedTargetDep *pDeps = pAlloc->fpMalloc(pMapArr->count * sizeof(BakedTargetDep));
+	I32 depCount = getBakedTargetDeps(pHandle, pMapArr, pDeps);
+	for (I32 i = 0; i < depCount; ++i) {
+		PIX_ERR_THROW_IFNOT_COND(
+			err,
+			pDeps[i].depTreeHash,
+			"can't bake target, a map or map dep was loaded without a timestamp",
+			0
+		);
+	}
+	//mapped with the same args as when re-mapping on load (see stucMapFileLoadIntern)
+	err = stucMapToMesh(
+		pCtx,
+		pMapArr,
+		(const StucMesh *)pObj->pData,
+		pIdxAttribArr,
+		&meshOut,
+		&outIdxAttribArr,
+		1.0f,
+		-1.0f,
+		false,
+		false,
+		NULL,
+		NULL
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	encodeDataTag(pAlloc, pData, TAG_BAKED_TARGET);
+	stucEncodeValue(pAlloc, pData, (U8 *)&depCount, 16);
+	for (I32 i = 0; i < depCount; ++i) {
+		stucEncodeValue(pAlloc, pData, (U8 *)&pDeps[i].map, 16);
+		stucEncodeValue(pAlloc, pData, (U8 *)&pDeps[i].depTreeHash, 64);
+	}
+	stucEncodeValue(pAlloc, pData, (U8 *)&outIdxAttribArr.count, 32);
+	encodeIndexedAttribMeta(pAlloc, pData, &outIdxAttribArr);
+	encodeIndexedAttribs(pAlloc, pData, &outIdxAttribArr);
+	err = encodeObj(
+		pHandle,
+		&(StucObject){.pData = (StucObjectData *)&meshOut, .transform = pObj->transform},
+		NULL,
+		false,
+		NULL,
+		NULL,
+		.0f,
+		.0f,
+		false
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	PIX_ERR_CATCH(0, err, ;);
+	pAlloc->fpFree(pDeps);
+	stucMeshDestroy(pCtx, &meshOut);
+	stucAttribIndexedArrDestroy(pCtx, &outIdxAttribArr);
+	return err;
+}
+
+static
+bool isTocEntryObj(const MapTocEntry *pEntry) {
+	return pEntry->type == TAG_TYPE_TARGET || pEntry->type == TAG_TYPE_OBJECT;
+}
+
+//a record spans up to the start of the next, which includes any trailing
+//records that belong to it (baked targets)
+static
+I64 getTocRecordEnd(const StucHeader *pHeader, I32 idx) {
+	return idx + 1 < pHeader->toc.count ?
+		pHeader->toc.pArr[idx + 1].offset : pHeader->dataSize;
+}
+
+//the header's stored after its size, and is followed by the data
+static
+I64 getMapDataStart(const StucHeader *pHeader) {
+	return 4 + (I64)pHeader->headerCapacity;
+}
+
+static
+bool isTocEntryUsg(const MapTocEntry *pEntry) {
+	return pEntry->type == TAG_TYPE_USG;
+}
+
+static
+bool isTocEntryCutoff(const MapTocEntry *pEntry) {
+	return pEntry->type == TAG_TYPE_USG_FLAT_CUTOFF;
+}
+
+//call before encoding the tag of a top-level record
+static
+void tocEntryAdd(StucMapExport *pHandle, DataTag type) {
+	I32 newIdx = 0;
+	PIXALC_DYN_ARR_ADD(MapTocEntry, &pHandle->pCtx->alloc, &pHandle->toc, newIdx);
+	//data tags are byte aligned, so the record starts at the next whole byte
+	pHandle->toc.pArr[newIdx] = (MapTocEntry){
+		.offset = pHandle->data.byteIdx + (pHandle->data.nextBitIdx > 0),
+		.type = type,
+		.codec = pHandle->codec
+	};
+}
+
+static
+void destroyMapToc(const StucAlloc *pAlloc, MapToc *pToc) {
+	if (pToc->pArr) {
+		pAlloc->fpFree(pToc->pArr);
+	}
+	*pToc = (MapToc){0};
+}
+
+static
+void destroyMapExport(StucMapExport *pHandle) {
+	StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	pAlloc->fpFree(pHandle->pPath);
+	pAlloc->fpFree(pHandle->data.pString);
+	if (pHandle->toc.pArr) {
+		pAlloc->fpFree(pHandle->toc.pArr);
+	}
+	pixuctHTableDestroy(&pHandle->mapTable);
+	stucAttribIndexedArrDestroy(pHandle->pCtx, &pHandle->idxAttribs);
+	MapExportSrc *pSrc = pHandle->pSrc;
+	if (pSrc) {
+		if (pSrc->ppChunks) {
+			for (I32 i = 0; i < pSrc->header.toc.count; ++i) {
+				if (pSrc->ppChunks[i]) {
+					pAlloc->fpFree(pSrc->ppChunks[i]);
+				}
+			}
+			pAlloc->fpFree(pSrc->ppChunks);
+		}
+		if (pSrc->pReplacedBy) {
+			pAlloc->fpFree(pSrc->pReplacedBy);
+		}
+		if (pSrc->pPath) {
+			pAlloc->fpFree(pSrc->pPath);
+		}
+		destroyMapToc(pAlloc, &pSrc->header.toc);
+		stucMapDepsDestroy(pAlloc, &pSrc->deps);
+		pAlloc->fpFree(pSrc);
+	}
+	*pHandle = (StucMapExport){0};
+}
+
+StucErr stucMapExportInit(
+	StucContext pCtx,
+	StucMapExport **ppHandle,
+	const char *pPath,
+	bool compress
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
-	StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	StucAlloc *pAlloc = &pCtx->alloc;
+	PIX_ERR_RETURN_IFNOT_COND(err, pPath[0], "path is empty");
+	I32 pathLen = strnlen(pPath, pixioPathMaxGet());
+	PIX_ERR_RETURN_IFNOT_COND(err, pathLen != pixioPathMaxGet(), "path is too long");
+	++pathLen;
+	StucMapExport *pHandle = pAlloc->fpCalloc(1, sizeof(StucMapExport));
+	pHandle->pCtx = pCtx;
+	pHandle->pPath = pAlloc->fpCalloc(pathLen, 1);
+	memcpy(pHandle->pPath, pPath, pathLen);
 	ByteString *pData = &pHandle->data;
+	pData->size = 1024;
+	pData->pString = pAlloc->fpCalloc(pData->size, 1);
+	pHandle->cutoffIdxMax = -1;
+	pixuctHTableInit(
+		pAlloc,
+		&pHandle->mapTable,
+		16,
+		(I32Arr){.pArr = (I32[1]){sizeof(MatMapEntry)}, .count = 1},
+		NULL,
+		pHandle,
+		true
+	);
+	pHandle->codec = compress ? STUC_CODEC_DEFLATE : STUC_CODEC_STORE;
+	*ppHandle = pHandle;
+	return err;
+}
 
-	StucMesh meshCpy = *pMesh;
-	err = stucAttemptToSetMissingActiveDomains(&meshCpy);
+StucErr stucMapExportCodecSet(StucMapExport *pHandle, I32 codec) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pHandle, "invalid handle");
+	const StucCodec *pCodec = NULL;
+	err = codecGet(pHandle->pCtx, codec, &pCodec);
 	PIX_ERR_RETURN_IFNOT(err, "");
-	const Attrib *pAttrib =
-		stucGetActiveAttribConst(pHandle->pCtx, &meshCpy, STUC_ATTRIB_USE_IDX);
-	encodeDataTag(pAlloc, pData, TAG_MAP_OVERRIDES);
-	I32 countDataPos = pData->byteIdx;
-	stucEncodeValue(pAlloc, pData, (U8[]){0, 0}, 16);
-	I32 count = 0;
-	const AttribIndexed *pMats =
-		stucGetAttribIndexedInternConst(pIdxAttribArr, pAttrib->core.name);
-	intptr_t attribIdx = (intptr_t)pMats - (intptr_t)pIdxAttribArr->pArr;
-	for (I32 i = 0; i < pMapArr->count; ++i) {
-		I32 globMatIdx = pIdxTable->pArr[attribIdx].table.pArr[i];
-		if (globMatIdx == -2) {
-			continue;//mat is not use in mesh
-		}
-		++count;
-		MappingOpt mappingOpt = {
-			.wScale = wScale,
-			.receiveLen = receiveLen
-		};
-		MatMapEntry *pEntry = NULL;
-		pixuctHTableGet(
-			&pHandle->mapTable,
-			0,
-			pMapArr->pArr[i].map.ptr->pName,
-			(void **)&pEntry,
-			true,
-			&(MatMapEntryInit) {.pMap = pMapArr->pArr[i].map.ptr, .opt = mappingOpt},
-			stucKeyFromPath, NULL, matMapEntryInit, matMapEntryCmp
+	pHandle->codec = codec;
+	return err;
+}
+
+StucErr stucMapExportQuantizeSet(StucMapExport *pHandle, const StucMapQuantize *pOpts) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pHandle, "invalid handle");
+	if (!pOpts) {
+		pHandle->quantize = (StucMapQuantize){0};
+		return err;
+	}
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		pOpts->posBits >= 0 && pOpts->posBits <= 24 &&
+		pOpts->uvBits >= 0 && pOpts->uvBits <= 24 &&
+		pOpts->normalBits >= 0 && pOpts->normalBits <= 24,
+		"quantize bit counts must be between 0 and 24"
+	);
+	pHandle->quantize = *pOpts;
+	return err;
+}
+
+StucErr stucMapExportLodsSet(StucMapExport *pHandle, I32 levelCount) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pHandle, "invalid handle");
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		levelCount >= 0 && levelCount <= STUC_MAP_LOD_MAX,
+		"lod level count must be between 0 and STUC_MAP_LOD_MAX"
+	);
+	pHandle->lodCount = levelCount;
+	return err;
+}
+
+typedef struct ChunkCompressShared {
+	StucMapExport *pHandle;
+	U8 **ppChunks;
+	I64 dataSize;
+} ChunkCompressShared;
+
+typedef struct ChunkCompressJobArgs {
+	JobArgs core;
+} ChunkCompressJobArgs;
+
+static
+I32 chunkCompressJobsGetRange(StucContext pCtx, const void *pShared, void *pInitInfo) {
+	return ((const ChunkCompressShared *)pShared)->pHandle->toc.count;
+}
+
+static
+StucErr chunkCompressJob(void *pArgsVoid) {
+	StucErr err = PIX_ERR_SUCCESS;
+	ChunkCompressJobArgs *pArgs = pArgsVoid;
+	const ChunkCompressShared *pShared = pArgs->core.pShared;
+	StucMapExport *pHandle = pShared->pHandle;
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		MapTocEntry *pEntry = pHandle->toc.pArr + i;
+		I64 end = i + 1 < pHandle->toc.count ? pEntry[1].offset : pShared->dataSize;
+		const StucCodec *pCodec = NULL;
+		err = codecGet(pHandle->pCtx, pEntry->codec, &pCodec);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		err = pCodec->fpCompress(
+			&pHandle->pCtx->alloc,
+			pHandle->data.pString + pEntry->offset,
+			end - pEntry->offset,
+			pShared->ppChunks + i,
+			&pEntry->sizeCompressed
 		);
-		bool wScaleOverride = pEntry->opt.wScale != wScale;
-		bool receiveOverride = pEntry->opt.receiveLen != receiveLen;
-		bool blendOptOverride = false;
-		ByteString blendOptBuf = {0};
-		encodeBlendOpts(
-			pHandle,
-			&meshCpy,
-			pMapArr->pArr + i,
+		PIX_ERR_RETURN_IFNOT(err, "");
+	}
+	return err;
+}
+
+static
+void outRecordAdd(
+	MapToc *pOut,
+	U8 **ppOutChunks,
+	const MapTocEntry *pEntry,
+	I64 size,
+	U8 *pChunk,
+	I64 pos,
+	I64 *pOffset
+) {
+	I32 idx = pOut->count;
+	++pOut->count;
+	pOut->pArr[idx] = *pEntry;
+	pOut->pArr[idx].offset = *pOffset;
+	pOut->pArr[idx].pos = pos;
+	ppOutChunks[idx] = pChunk;
+	*pOffset += size;
+}
+
+//the file being updated's records are written in their original order,
+//with replaced records swapped for their new ones. Added records follow.
+//Chunks are borrowed from the source and from ppChunks. Kept records keep their
+//file pos, new records are given a pos of -1
+static
+void getUpdateOutRecords(
+	StucMapExport *pHandle,
+	U8 **ppChunks,
+	I64 dataSize,
+	MapToc *pOut,
+	U8 ***pppOutChunks,
+	I64 *pOutDataSize
+) {
+	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	const MapExportSrc *pSrc = pHandle->pSrc;
+	pOut->size = pSrc->header.toc.count + pHandle->toc.count;
+	pOut->pArr = pAlloc->fpCalloc(pOut->size, sizeof(MapTocEntry));
+	*pppOutChunks = pAlloc->fpCalloc(pOut->size, sizeof(U8 *));
+	bool *pIsPlaced = pAlloc->fpCalloc(pHandle->toc.count, sizeof(bool));
+	I64 offset = 0;
+	for (I32 i = 0; i < pSrc->header.toc.count; ++i) {
+		const MapTocEntry *pEntry = pSrc->header.toc.pArr + i;
+		if (pEntry->type == TAG_IDX_ATTRIBS) {
+			continue;//re-encoded with any new idx attribs appended
+		}
+		I32 newIdx = pSrc->pReplacedBy[i];
+		if (newIdx == -1) {
+			I64 size = getTocRecordEnd(&pSrc->header, i) - pEntry->offset;
+			U8 *pChunk = pSrc->ppChunks ? pSrc->ppChunks[i] : NULL;
+			outRecordAdd(pOut, *pppOutChunks, pEntry, size, pChunk, pEntry->pos, &offset);
+			continue;
+		}
+		pEntry = pHandle->toc.pArr + newIdx;
+		I64 end = newIdx + 1 < pHandle->toc.count ? pEntry[1].offset : dataSize;
+		outRecordAdd(
+			pOut,
+			*pppOutChunks,
 			pEntry,
-			&blendOptBuf,
-			&blendOptOverride
+			end - pEntry->offset,
+			ppChunks[newIdx],
+			-1,
+			&offset
 		);
-		optsFinalEncode(
-			pHandle,
+		pIsPlaced[newIdx] = true;
+	}
+	for (I32 i = 0; i < pHandle->toc.count; ++i) {
+		if (pIsPlaced[i]) {
+			continue;
+		}
+		const MapTocEntry *pEntry = pHandle->toc.pArr + i;
+		I64 end = i + 1 < pHandle->toc.count ? pEntry[1].offset : dataSize;
+		outRecordAdd(
+			pOut,
+			*pppOutChunks,
 			pEntry,
-			pMapArr->pArr[i].matIdx,
-			&blendOptBuf,
-			blendOptOverride, wScaleOverride, receiveOverride
+			end - pEntry->offset,
+			ppChunks[i],
+			-1,
+			&offset
 		);
 	}
-	*(I16 *)&pData->pString[countDataPos] = count;
-	return err;
+	pAlloc->fpFree(pIsPlaced);
+	*pOutDataSize = offset;
 }
 
+//chunks are written in toc order, with no gaps
 static
-StucErr encodeObj(
+void tocPosSetContiguous(MapToc *pToc) {
+	I64 pos = 0;
+	for (I32 i = 0; i < pToc->count; ++i) {
+		pToc->pArr[i].pos = pos;
+		pos += pToc->pArr[i].sizeCompressed;
+	}
+}
+
+//new records are appended after every chunk the file currently references,
+//so the file stays valid until its header is rewritten
+static
+void tocPosSetAppended(MapToc *pToc, const StucHeader *pSrcHeader) {
+	I64 pos = 0;
+	for (I32 i = 0; i < pSrcHeader->toc.count; ++i) {
+		const MapTocEntry *pEntry = pSrcHeader->toc.pArr + i;
+		pos = PIXM_MAX(pos, pEntry->pos + pEntry->sizeCompressed);
+	}
+	for (I32 i = 0; i < pToc->count; ++i) {
+		if (pToc->pArr[i].pos != -1) {
+			continue;
+		}
+		pToc->pArr[i].pos = pos;
+		pos += pToc->pArr[i].sizeCompressed;
+	}
+}
+
+static
+I32 getHeaderLen(const ByteString *pHeader) {
+	return (I32)(pHeader->byteIdx + !!pHeader->nextBitIdx);
+}
+
+//the header is padded, so an in place update can rewrite it as long as it still fits
+static
+I32 getHeaderCapacity(I64 headerLen) {
+	return (I32)(headerLen + headerLen / 2 + 256);
+}
+
+static
+void encodeMapHeader(
 	StucMapExport *pHandle,
-	const StucObject *pObj,
-	const StucIdxTableArr *pIdxTable,
-	bool mappingOpt,
-	const StucMapArr *pMapArr,
-	const AttribIndexedArr *pIdxAttribArr,
-	F32 wScale,
-	F32 receiveLen,
-	bool checkPosOnly
+	const MapToc *pToc,
+	I64 dataSize,
+	ByteString *pHeader
 ) {
-	StucErr err = PIX_ERR_SUCCESS;
 	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
-	ByteString *pData = &pHandle->data;
-	PIX_ERR_RETURN_IFNOT_COND(
-		err,
-		pObj->pData && pObj->pData->type == STUC_OBJECT_DATA_MESH,
-		"invalid mesh"
-	);
-	StucMesh *pMesh = (StucMesh *)pObj->pData;
-	err = stucValidateMesh(&pHandle->pCtx->alloc, pMesh, false, checkPosOnly);
-	PIX_ERR_RETURN_IFNOT(err, "mesh validation failed");
-	//encode obj header
-	encodeDataTag(pAlloc, pData, TAG_OBJECT);
-	if (pIdxTable && pIdxTable->count) {
-		encodeRedirectTable(pAlloc, pData, pIdxTable);
+	I64 compressedSize = 0;
+	for (I32 i = 0; i < pToc->count; ++i) {
+		compressedSize += pToc->pArr[i].sizeCompressed;
 	}
-	err = encodeActiveAttribs(pAlloc, pData, pMesh);
+	const char *format = MAP_FORMAT_NAME;
+	pHeader->size = 64;
+	pHeader->pString = pAlloc->fpCalloc(pHeader->size, 1);
+	stucEncodeString(pAlloc, pHeader, format);
+	I32 version = STUC_MAP_VERSION;
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&version, 16);
+	I64 lenPos = pHeader->byteIdx;
+	stucEncodeValue(pAlloc, pHeader, (U8[4]){0}, 32);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&compressedSize, 64);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&dataSize, 64);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&pHandle->idxAttribs.count, 32);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&pHandle->header.objCount, 32);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&pHandle->header.usgCount, 32);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&pHandle->header.cutoffCount, 32);
+
+	encodeDataTag(pAlloc, pHeader, TAG_DEP);
+	PixalcLinAlloc *pTableAlloc = pixuctHTableAllocGet(&pHandle->mapTable, 0);
+	//targets can't be added in an update, so the file's deps are kept as they are
+	const PixtyStrArr *pSrcDeps = pHandle->pSrc ? &pHandle->pSrc->deps.maps : NULL;
+	I32 depCount = pTableAlloc->linIdx + (pSrcDeps ? pSrcDeps->count : 0);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&depCount, 32);
+	for (I32 i = 0; pSrcDeps && i < pSrcDeps->count; ++i) {
+		encodeDataTag(pAlloc, pHeader, TAG_DEP_TYPE_MAP);
+		stucEncodeString(pAlloc, pHeader, pSrcDeps->pArr[i].pStr);
+	}
+	PixalcLinAllocIter iter = {0};
+	pixalcLinAllocIterInit(pTableAlloc, (PixtyRange){.start=0, .end=INT32_MAX}, &iter);
+	for (; !pixalcLinAllocIterAtEnd(&iter); pixalcLinAllocIterInc(&iter)) {
+		encodeDataTag(pAlloc, pHeader, TAG_DEP_TYPE_MAP);
+		MatMapEntry *pEntry = pixalcLinAllocGetItem(&iter);
+		stucEncodeString(pAlloc, pHeader, pEntry->pMap->pName);
+	}
+
+	encodeDataTag(pAlloc, pHeader, TAG_TOC);
+	stucEncodeValue(pAlloc, pHeader, (U8 *)&pToc->count, 32);
+	for (I32 i = 0; i < pToc->count; ++i) {
+		const MapTocEntry *pEntry = pToc->pArr + i;
+		stucEncodeValue(pAlloc, pHeader, (U8 *)&pEntry->type, 8);
+		stucEncodeValue(pAlloc, pHeader, (U8 *)&pEntry->offset, 64);
+	}
+	encodeDataTag(pAlloc, pHeader, TAG_CHUNKS);
+	for (I32 i = 0; i < pToc->count; ++i) {
+		const MapTocEntry *pEntry = pToc->pArr + i;
+		stucEncodeValue(pAlloc, pHeader, (U8 *)&pEntry->codec, 8);
+		stucEncodeValue(pAlloc, pHeader, (U8 *)&pEntry->pos, 64);
+		stucEncodeValue(pAlloc, pHeader, (U8 *)&pEntry->sizeCompressed, 64);
+	}
+	I32 headerLen = getHeaderLen(pHeader);
+	memcpy(pHeader->pString + lenPos, &headerLen, 4);
+}
+
+//writes the header padded to capacity, at the current file pos
+static
+StucErr writeMapHeader(
+	StucContext pCtx,
+	void *pFile,
+	ByteString *pHeader,
+	I32 capacity
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_ASSERT("", getHeaderLen(pHeader) <= capacity);
+	byteStringReserve(&pCtx->alloc, pHeader, capacity);
+	err = pCtx->io.fpWrite(pFile, pHeader->pString, capacity);
 	PIX_ERR_RETURN_IFNOT(err, "");
-	encodeDataTag(pAlloc, pData, TAG_XFORM);
-	for (I32 i = 0; i < 16; ++i) {
-		I32 x = i % 4;
-		I32 y = i / 4;
-		stucEncodeValue(pAlloc, pData, (U8 *)&pObj->transform.d[y][x], 32);
+	return err;
+}
+
+static
+StucErr writeMapFile(
+	StucMapExport *pHandle,
+	ByteString *pHeader,
+	const MapToc *pToc,
+	U8 **ppChunks
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucContext pCtx = pHandle->pCtx;
+	void *pFile = NULL;
+	I32 capacity = getHeaderCapacity(getHeaderLen(pHeader));
+	err = pCtx->io.fpOpen(&pFile, pHandle->pPath, STUC_FILE_OPEN_WRITE, &pCtx->alloc);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	err = pCtx->io.fpWrite(pFile, (U8 *)&capacity, 4);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	err = writeMapHeader(pCtx, pFile, pHeader, capacity);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	for (I32 i = 0; i < pToc->count; ++i) {
+		err = pCtx->io.fpWrite(pFile, ppChunks[i], (I32)pToc->pArr[i].sizeCompressed);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
 	}
-	encodeDataTag(pAlloc, pData, TAG_OBJECT_TYPE);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pObj->pData->type, 8);
-	if (!stucCheckIfMesh(*pObj->pData)) {
-		return err;
+	PIX_ERR_CATCH(0, err, ;);
+	if (pFile) {
+		StucErr closeErr = pCtx->io.fpClose(pFile);
+		err = err == PIX_ERR_SUCCESS ? closeErr : err;
 	}
-	encodeDataTag(pAlloc, pData, TAG_MESH_HEADER);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->meshAttribs.count, 32);
-	encodeAttribMeta(pAlloc, pData, &pMesh->meshAttribs);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->faceAttribs.count, 32);
-	encodeAttribMeta(pAlloc, pData, &pMesh->faceAttribs);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->cornerAttribs.count, 32);
-	encodeAttribMeta(pAlloc, pData, &pMesh->cornerAttribs);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->edgeAttribs.count, 32);
-	encodeAttribMeta(pAlloc, pData, &pMesh->edgeAttribs);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->vertAttribs.count, 32);
-	encodeAttribMeta(pAlloc, pData, &pMesh->vertAttribs);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->faceCount, 32);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->cornerCount, 32);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->edgeCount, 32);
-	stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->vertCount, 32);
-	//encode data
-	encodeDataTag(pAlloc, pData, TAG_MESH_ATTRIBS);
-	encodeAttribs(pAlloc, pData, &pMesh->meshAttribs, 1);
-	encodeDataTag(pAlloc, pData, TAG_FACE_LIST);
-	for (I32 i = 0; i < pMesh->faceCount; ++i) {
-		PIX_ERR_ASSERT("",
-			pMesh->pFaces[i] >= 0 &&
-			pMesh->pFaces[i] < pMesh->cornerCount
-		);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->pFaces[i], 32);
+	return err;
+}
+
+//only new records are written, followed by the header. Kept records aren't touched
+static
+StucErr updateMapFileInPlace(
+	StucMapExport *pHandle,
+	ByteString *pHeader,
+	const MapToc *pToc,
+	U8 **ppChunks
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucContext pCtx = pHandle->pCtx;
+	const StucHeader *pSrcHeader = &pHandle->pSrc->header;
+	void *pFile = NULL;
+	err = pCtx->io.fpOpen(&pFile, pHandle->pPath, STUC_FILE_OPEN_UPDATE, &pCtx->alloc);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	I64 dataStart = getMapDataStart(pSrcHeader);
+	for (I32 i = 0; i < pToc->count; ++i) {
+		if (!ppChunks[i]) {
+			continue;//kept record
+		}
+		err = pCtx->io.fpSeek(pFile, dataStart + pToc->pArr[i].pos);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+		err = pCtx->io.fpWrite(pFile, ppChunks[i], (I32)pToc->pArr[i].sizeCompressed);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
 	}
-	encodeDataTag(pAlloc, pData, TAG_FACE_ATTRIBS);
-	encodeAttribs(pAlloc, pData, &pMesh->faceAttribs, pMesh->faceCount);
-	encodeDataTag(pAlloc, pData, TAG_CORNER_AND_EDGE_LISTS);
-	for (I32 i = 0; i < pMesh->cornerCount; ++i) {
-		PIX_ERR_ASSERT("",
-			pMesh->pCorners[i] >= 0 &&
-			pMesh->pCorners[i] < pMesh->vertCount
-		);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->pCorners[i], 32);
-		PIX_ERR_ASSERT("",
-			pMesh->pEdges[i] >= 0 &&
-			pMesh->pEdges[i] < pMesh->edgeCount
-		);
-		stucEncodeValue(pAlloc, pData, (U8 *)&pMesh->pEdges[i], 32);
+	//header's written last, so the file's left valid if a chunk write fails
+	err = pCtx->io.fpSeek(pFile, 4);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	err = writeMapHeader(pCtx, pFile, pHeader, pSrcHeader->headerCapacity);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	PIX_ERR_CATCH(0, err, ;);
+	if (pFile) {
+		StucErr closeErr = pCtx->io.fpClose(pFile);
+		err = err == PIX_ERR_SUCCESS ? closeErr : err;
 	}
-	encodeDataTag(pAlloc, pData, TAG_CORNER_ATTRIBS);
-	encodeAttribs(pAlloc, pData, &pMesh->cornerAttribs, pMesh->cornerCount);
-	encodeDataTag(pAlloc, pData, TAG_EDGE_ATTRIBS);
-	encodeAttribs(pAlloc, pData, &pMesh->edgeAttribs, pMesh->edgeCount);
-	encodeDataTag(pAlloc, pData, TAG_VERT_ATTRIBS);
-	encodeAttribs(pAlloc, pData, &pMesh->vertAttribs, pMesh->vertCount);
 	return err;
 }
 
+//reads the kept records of the file being updated, for when it's rewritten
 static
-void destroyMapExport(StucMapExport *pHandle) {
-	StucAlloc *pAlloc = &pHandle->pCtx->alloc;
-	pAlloc->fpFree(pHandle->pPath);
-	pAlloc->fpFree(pHandle->data.pString);
-	pixuctHTableDestroy(&pHandle->mapTable);
-	stucAttribIndexedArrDestroy(pHandle->pCtx, &pHandle->idxAttribs);
-	*pHandle = (StucMapExport){0};
-}
-
-StucErr stucMapExportInit(
-	StucContext pCtx,
-	StucMapExport **ppHandle,
-	const char *pPath,
-	bool compress
-) {
+StucErr readUpdateSrcChunks(StucMapExport *pHandle) {
 	StucErr err = PIX_ERR_SUCCESS;
-	StucAlloc *pAlloc = &pCtx->alloc;
-	PIX_ERR_RETURN_IFNOT_COND(err, pPath[0], "path is empty");
-	I32 pathLen = strnlen(pPath, pixioPathMaxGet());
-	PIX_ERR_RETURN_IFNOT_COND(err, pathLen != pixioPathMaxGet(), "path is too long");
-	++pathLen;
-	StucMapExport *pHandle = pAlloc->fpCalloc(1, sizeof(StucMapExport));
-	pHandle->pCtx = pCtx;
-	pHandle->pPath = pAlloc->fpCalloc(pathLen, 1);
-	memcpy(pHandle->pPath, pPath, pathLen);
-	ByteString *pData = &pHandle->data;
-	pData->size = 1024;
-	pData->pString = pAlloc->fpCalloc(pData->size, 1);
-	pHandle->cutoffIdxMax = -1;
-	pixuctHTableInit(
-		pAlloc,
-		&pHandle->mapTable,
-		16,
-		(I32Arr){.pArr = (I32[1]){sizeof(MatMapEntry)}, .count = 1},
-		NULL,
-		pHandle,
-		true
-	);
-	pHandle->compress = compress;
-	*ppHandle = pHandle;
+	StucContext pCtx = pHandle->pCtx;
+	MapExportSrc *pSrc = pHandle->pSrc;
+	void *pFile = NULL;
+	I32 recordCount = pSrc->header.toc.count;
+	pSrc->ppChunks = pCtx->alloc.fpCalloc(recordCount, sizeof(U8 *));
+	err = pCtx->io.fpOpen(&pFile, pSrc->pPath, STUC_FILE_OPEN_READ, &pCtx->alloc);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	I64 filePos = 0;
+	I64 dataStart = getMapDataStart(&pSrc->header);
+	for (I32 i = 0; i < recordCount; ++i) {
+		const MapTocEntry *pEntry = pSrc->header.toc.pArr + i;
+		if (pEntry->type == TAG_IDX_ATTRIBS || pSrc->pReplacedBy[i] != -1) {
+			continue;
+		}
+		err = ioSeekTo(pCtx, pFile, &filePos, dataStart + pEntry->pos);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+		pSrc->ppChunks[i] = pCtx->alloc.fpMalloc(PIXM_MAX(pEntry->sizeCompressed, 1));
+		err = pCtx->io.fpRead(pFile, pSrc->ppChunks[i], (I32)pEntry->sizeCompressed);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+		filePos += pEntry->sizeCompressed;
+	}
+	PIX_ERR_CATCH(0, err, ;);
+	if (pFile) {
+		pCtx->io.fpClose(pFile);
+	}
 	return err;
 }
 
@@ -871,8 +3055,9 @@ StucErr stucMapExportEnd(StucMapExport **ppHandle) {
 	StucAlloc *pAlloc = &pHandle->pCtx->alloc;
 
 	ByteString header = {0};
-	U8 *pCompressed = NULL;
-	void *pFile = NULL;
+	ChunkCompressShared shared = {0};
+	MapToc outToc = {0};
+	U8 **ppOutChunks = NULL;
 
 	PIX_ERR_THROW_IFNOT_COND(
 		err,
@@ -892,85 +3077,103 @@ StucErr stucMapExportEnd(StucMapExport **ppHandle) {
 		"no supplied flat-cutoffs are referenced by a USG"
 	);
 
+	tocEntryAdd(pHandle, TAG_IDX_ATTRIBS);
 	encodeDataTag(&pHandle->pCtx->alloc, &pHandle->data, TAG_IDX_ATTRIBS);
 	encodeIndexedAttribMeta(pAlloc, &pHandle->data, &pHandle->idxAttribs);
 	encodeIndexedAttribs(pAlloc, &pHandle->data, &pHandle->idxAttribs);
 
-	//compress data
+	//records are compressed separately, so each can use its own codec,
+	//so filtered loads can skip them without decompressing,
+	//and so they can be compressed in parallel
 	I64 dataSize = pHandle->data.byteIdx + (pHandle->data.nextBitIdx > 0);
-	z_stream zStream = {
-		.zalloc = mallocZlibWrap,
-		.zfree = freeZlibWrap,
-		.opaque = (void *)pAlloc 
+	shared = (ChunkCompressShared){
+		.pHandle = pHandle,
+		.dataSize = dataSize,
+		.ppChunks = pAlloc->fpCalloc(pHandle->toc.count, sizeof(U8 *))
 	};
-	//using gzip with crc32
-	err = checkZlibErr(
-		Z_OK,
-		deflateInit2(
-			&zStream,
-			pHandle->compress ? Z_DEFAULT_COMPRESSION : Z_NO_COMPRESSION,
-			Z_DEFLATED,
-			STUC_WINDOW_BITS,
-			8,
-			Z_DEFAULT_STRATEGY
-		)
+	I32 jobCount = PIXM_MIN(pHandle->toc.count, PIX_THREAD_MAX_SUB_MAPPING_JOBS);
+	ChunkCompressJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+	stucMakeJobArgs(
+		pHandle->pCtx,
+		&shared,
+		&jobCount, jobArgs, sizeof(ChunkCompressJobArgs),
+		NULL,
+		chunkCompressJobsGetRange, NULL
+	);
+	err = stucDoJobInParallel(
+		pHandle->pCtx,
+		jobCount, jobArgs, sizeof(ChunkCompressJobArgs),
+		chunkCompressJob
 	);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
-	zStream.avail_out = deflateBound(&zStream, dataSize);
-	pCompressed = pAlloc->fpMalloc(zStream.avail_out);
-	zStream.next_out = pCompressed;
-	zStream.avail_in = dataSize;
-	zStream.next_in = pHandle->data.pString;
-	err = checkZlibErr(Z_STREAM_END, deflate(&zStream, Z_FINISH));
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-	err = checkZlibErr(Z_OK, deflateEnd(&zStream));
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-
-	//encode header
-	const char *format = MAP_FORMAT_NAME;
-	header.size = 64;
-	header.pString = pAlloc->fpCalloc(header.size, 1);
-	stucEncodeString(pAlloc, &header, format);
-	I32 version = STUC_MAP_VERSION;
-	stucEncodeValue(pAlloc, &header, (U8 *)&version, 16);
-	stucEncodeValue(pAlloc, &header, (U8 *)&zStream.total_out, 64);
-	stucEncodeValue(pAlloc, &header, (U8 *)&dataSize, 64);
-	stucEncodeValue(pAlloc, &header, (U8 *)&pHandle->idxAttribs.count, 32);
-	stucEncodeValue(pAlloc, &header, (U8 *)&pHandle->header.objCount, 32);
-	stucEncodeValue(pAlloc, &header, (U8 *)&pHandle->header.usgCount, 32);
-	stucEncodeValue(pAlloc, &header, (U8 *)&pHandle->header.cutoffCount, 32);
-
-	encodeDataTag(pAlloc, &header, TAG_DEP);
-	PixalcLinAlloc *pTableAlloc = pixuctHTableAllocGet(&pHandle->mapTable, 0);
-	stucEncodeValue(pAlloc, &header, (U8 *)&pTableAlloc->linIdx, 32);
-	PixalcLinAllocIter iter = {0};
-	pixalcLinAllocIterInit(pTableAlloc, (PixtyRange){.start=0, .end=INT32_MAX}, &iter);
-	for (; !pixalcLinAllocIterAtEnd(&iter); pixalcLinAllocIterInc(&iter)) {
-		encodeDataTag(pAlloc, &header, TAG_DEP_TYPE_MAP);
-		MatMapEntry *pEntry = pixalcLinAllocGetItem(&iter);
-		stucEncodeString(pAlloc, &header, pEntry->pMap->pName);
+	MapExportSrc *pSrc = pHandle->pSrc;
+	bool inPlace = pSrc && pSrc->inPlace;
+	I64 outDataSize = dataSize;
+	if (inPlace) {
+		getUpdateOutRecords(
+			pHandle,
+			shared.ppChunks,
+			dataSize,
+			&outToc,
+			&ppOutChunks,
+			&outDataSize
+		);
+		tocPosSetAppended(&outToc, &pSrc->header);
+		encodeMapHeader(pHandle, &outToc, outDataSize, &header);
+		if (getHeaderLen(&header) > pSrc->header.headerCapacity) {
+			//the header's outgrown its space, so the file's rewritten
+			inPlace = false;
+			pAlloc->fpFree(header.pString);
+			header = (ByteString){0};
+			destroyMapToc(pAlloc, &outToc);
+			pAlloc->fpFree(ppOutChunks);
+			ppOutChunks = NULL;
+		}
+	}
+	if (!inPlace) {
+		if (!pSrc) {
+			outToc = pHandle->toc;
+			ppOutChunks = shared.ppChunks;
+		}
+		else {
+			err = readUpdateSrcChunks(pHandle);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+			getUpdateOutRecords(
+				pHandle,
+				shared.ppChunks,
+				dataSize,
+				&outToc,
+				&ppOutChunks,
+				&outDataSize
+			);
+		}
+		tocPosSetContiguous(&outToc);
+		encodeMapHeader(pHandle, &outToc, outDataSize, &header);
+		err = writeMapFile(pHandle, &header, &outToc, ppOutChunks);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	else {
+		err = updateMapFileInPlace(pHandle, &header, &outToc, ppOutChunks);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
 	}
-
-	header.size = header.byteIdx + !!header.nextBitIdx;
-
-	err = pHandle->pCtx->io.fpOpen(&pFile, pHandle->pPath, 0, pAlloc);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-	err = pHandle->pCtx->io.fpWrite(pFile, (U8 *)&header.size, 4);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-	err = pHandle->pCtx->io.fpWrite(pFile, header.pString, header.size);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-	err = pHandle->pCtx->io.fpWrite(pFile, pCompressed, (I32)zStream.total_out);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
 
 	PIX_ERR_CATCH(0, err, ;);
-	if (pFile) {
-		err = pHandle->pCtx->io.fpClose(pFile);
-	}
 	if (header.pString) {
 		pAlloc->fpFree(header.pString);
 	}
-	if (pCompressed) {
-		pAlloc->fpFree(pCompressed);
+	if (shared.ppChunks) {
+		for (I32 i = 0; i < pHandle->toc.count; ++i) {
+			if (shared.ppChunks[i]) {
+				pAlloc->fpFree(shared.ppChunks[i]);
+			}
+		}
+		pAlloc->fpFree(shared.ppChunks);
+	}
+	if (pHandle->pSrc) {
+		destroyMapToc(pAlloc, &outToc);
+		if (ppOutChunks) {
+			pAlloc->fpFree(ppOutChunks);
+		}
 	}
 	destroyMapExport(pHandle);
 	printf("Finished STUC export\n");
@@ -1133,6 +3336,57 @@ StucErr makeIdxAttribRedirects(
 	return err;
 }
 
+//each level's cell size is double the last, starting at the avg edge len.
+//Levels are always decimated from the full res mesh
+static
+StucErr encodeObjLods(StucMapExport *pHandle, const StucObject *pObj) {
+	StucErr err = PIX_ERR_SUCCESS;
+	const StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	const StucMesh *pMesh = (StucMesh *)pObj->pData;
+	const Attrib *pPos = getDecimatePosAttrib(pMesh);
+	if (!pPos) {
+		return err;//lods are optional, meshes without a vert pos attrib don't get any
+	}
+	F32 cellSize = stucGetEdgeLenAvg(pMesh, (const V3_F32 *)pPos->core.pData, false);
+	if (!(cellSize > .0f) || !isfinite(cellSize)) {
+		return err;//degenerate mesh, every vert would land in the same cell (or none)
+	}
+	I32 prevVertCount = pMesh->vertCount;
+	for (I8 i = 1; i <= pHandle->lodCount; ++i) {
+		cellSize *= 2.0f;
+		StucMesh lod = {0};
+		decimateMesh(pAlloc, pMesh, pPos, cellSize, &lod);
+		if (!lod.faceCount) {
+			decimatedMeshDestroy(pAlloc, &lod);
+			break;
+		}
+		if (lod.vertCount >= prevVertCount ||
+			stucValidateMesh(pAlloc, &lod, false, false) != PIX_ERR_SUCCESS
+		) {
+			decimatedMeshDestroy(pAlloc, &lod);
+			continue;
+		}
+		prevVertCount = lod.vertCount;
+		encodeDataTag(pAlloc, &pHandle->data, TAG_LOD);
+		stucEncodeValue(pAlloc, &pHandle->data, (U8 *)&i, 8);
+		//idx attribs keep the object's local indices, so no redirect table is needed
+		err = encodeObj(
+			pHandle,
+			&(StucObject){.pData = (StucObjectData *)&lod, .transform = pObj->transform},
+			NULL,
+			false,
+			NULL,
+			NULL,
+			.0f,
+			.0f,
+			false
+		);
+		decimatedMeshDestroy(pAlloc, &lod);
+		PIX_ERR_RETURN_IFNOT(err, "");
+	}
+	return err;
+}
+
 static
 StucErr mapExportObjAdd(
 	StucMapExport *pHandle,
@@ -1141,10 +3395,12 @@ StucErr mapExportObjAdd(
 	bool isTarget,
 	const StucMapArr *pMapArr,
 	F32 wScale,
-	F32 receiveLen
+	F32 receiveLen,
+	bool bake
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	StucIdxTableArr idxTable = {0};
+	I32 overrideCount = 0;
 	err = makeIdxAttribRedirects(pHandle, pObj, pIndexedAttribs, &idxTable);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 	if (isTarget) {
@@ -1155,7 +3411,8 @@ StucErr mapExportObjAdd(
 			pIndexedAttribs,
 			&idxTable,
 			wScale,
-			receiveLen
+			receiveLen,
+			&overrideCount
 		);
 		PIX_ERR_THROW_IFNOT(err, "", 0);
 	}
@@ -1174,6 +3431,16 @@ StucErr mapExportObjAdd(
 		false
 	);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
+	if (bake && overrideCount) {
+		//targets without overrides aren't mapped on load, so there's nothing to bake
+		err = encodeBakedTarget(pHandle, pObj, pMapArr, pIndexedAttribs);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	if (!isTarget && pHandle->lodCount) {
+		//written into the object's record, so they're replaced along with it
+		err = encodeObjLods(pHandle, pObj);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
 	++pHandle->header.objCount;
 	PIX_ERR_CATCH(0, err, destroyMapExport(pHandle););
 	destroyIdxTableArr(&pHandle->pCtx->alloc, &idxTable);
@@ -1186,11 +3453,29 @@ StucErr stucMapExportTargetAdd(
 	const StucObject *pObj,
 	const StucAttribIndexedArr *pIndexedAttribs,
 	F32 wScale,
-	F32 receiveLen
+	F32 receiveLen,
+	bool bake
 ) {
+	StucErr err = PIX_ERR_SUCCESS;
+	//target records reference the file's deps, which are only known by name
+	//in an update, and can't be merged with the new target's maps
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		!pHandle->pSrc,
+		"targets can't be added when updating a map file"
+	);
+	tocEntryAdd(pHandle, TAG_TYPE_TARGET);
 	encodeDataTag(&pHandle->pCtx->alloc, &pHandle->data, TAG_TYPE_TARGET);
-	return
-		mapExportObjAdd(pHandle, pObj, pIndexedAttribs, true, pMapArr, wScale, receiveLen);
+	return mapExportObjAdd(
+		pHandle,
+		pObj,
+		pIndexedAttribs,
+		true,
+		pMapArr,
+		wScale,
+		receiveLen,
+		bake
+	);
 }
 
 StucErr stucMapExportObjAdd(
@@ -1198,8 +3483,9 @@ StucErr stucMapExportObjAdd(
 	const StucObject *pObj,
 	const StucAttribIndexedArr *pIndexedAttribs
 ) {
+	tocEntryAdd(pHandle, TAG_TYPE_OBJECT);
 	encodeDataTag(&pHandle->pCtx->alloc, &pHandle->data, TAG_TYPE_OBJECT);
-	return mapExportObjAdd(pHandle, pObj, pIndexedAttribs, false, NULL, .0f, .0f);
+	return mapExportObjAdd(pHandle, pObj, pIndexedAttribs, false, NULL, .0f, .0f, false);
 }
 
 StucErr stucMapExportUsgAdd(
@@ -1208,6 +3494,7 @@ StucErr stucMapExportUsgAdd(
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	tocEntryAdd(pHandle, TAG_TYPE_USG);
 	encodeDataTag(pAlloc, &pHandle->data, TAG_TYPE_USG);
 	err = encodeObj(pHandle, &pUsg->obj, NULL, false, NULL, NULL, .0f, .0f, true);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
@@ -1232,6 +3519,7 @@ StucErr stucMapExportUsgAdd(
 StucErr stucMapExportUsgCutoffAdd(StucMapExport *pHandle, StucObject *pFlatCutoff) {
 	StucErr err = PIX_ERR_SUCCESS;
 	StucAlloc *pAlloc = &pHandle->pCtx->alloc;
+	tocEntryAdd(pHandle, TAG_TYPE_USG_FLAT_CUTOFF);
 	encodeDataTag(pAlloc, &pHandle->data, TAG_TYPE_USG_FLAT_CUTOFF);
 	err = encodeObj(pHandle, pFlatCutoff, NULL, false, NULL, NULL, .0f, .0f, true);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
@@ -1288,6 +3576,9 @@ void decodeAttribs(
 ) {
 	for (I32 i = 0; i < pAttribs->count; ++i) {
 		Attrib* pAttrib = pAttribs->pArr + i;
+		if (pAttrib->core.pData) {
+			continue;//already decoded with the quantized attribs
+		}
 		I32 attribSize = stucGetAttribSizeIntern(pAttrib->core.type);
 		pAttrib->core.pData = dataLen ?
 			pCtx->alloc.fpCalloc(dataLen, attribSize) : NULL;
@@ -1336,8 +3627,32 @@ StucErr decodeStucHeader(
 	StucMapDeps *pDeps
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
+	char *pBuf = NULL;
 	stucDecodeString(pByteString, pHeader->format, MAP_FORMAT_NAME_MAX_LEN);
 	stucDecodeValue(pByteString, (U8 *)&pHeader->version, 16);
+	//checked here, as older headers don't have a len
+	PIX_ERR_THROW_IFNOT_COND(
+		err,
+		!strncmp(pHeader->format, MAP_FORMAT_NAME, MAP_FORMAT_NAME_MAX_LEN),
+		"map file is corrupt",
+		0
+	);
+	PIX_ERR_THROW_IFNOT_COND(
+		err, 
+		pHeader->version == STUC_MAP_VERSION,
+		"map file version not supported",
+		0
+	);
+	//the rest of the buffer is padding
+	I32 headerLen = 0;
+	stucDecodeValue(pByteString, (U8 *)&headerLen, 32);
+	PIX_ERR_THROW_IFNOT_COND(
+		err,
+		headerLen >= pByteString->byteIdx && headerLen <= pByteString->size,
+		"map file header is corrupt",
+		0
+	);
+	pByteString->size = headerLen;
 	stucDecodeValue(pByteString, (U8 *)&pHeader->dataSizeCompressed, 64);;
 	stucDecodeValue(pByteString, (U8 *)&pHeader->dataSize, 64);
 	stucDecodeValue(pByteString, (U8 *)&pHeader->idxAttribCount, 32);
@@ -1349,11 +3664,8 @@ StucErr decodeStucHeader(
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 	I32 depCount = 0;
 	stucDecodeValue(pByteString, (U8 *)&depCount, 32);
-	if (!depCount) {
-		return err;
-	}
 	I32 pathMax = pixioPathMaxGet();
-	char *pBuf = pCtx->alloc.fpMalloc(pathMax);
+	pBuf = depCount ? pCtx->alloc.fpMalloc(pathMax) : NULL;
 	for (I32 i = 0; i < depCount; ++i) {
 		DataTag type = decodeDataTag(pByteString, NULL);
 		switch (type) {
@@ -1370,7 +3682,57 @@ StucErr decodeStucHeader(
 			}
 		}
 	}
-	PIX_ERR_CATCH(0, err, stucMapDepsDestroy(&pCtx->alloc, pDeps););
+	err = isDataTagInvalid(pByteString, TAG_TOC);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	MapToc *pToc = &pHeader->toc;
+	stucDecodeValue(pByteString, (U8 *)&pToc->count, 32);
+	PIX_ERR_THROW_IFNOT_COND(err, pToc->count > 0, "invalid toc", 0);
+	pToc->size = pToc->count;
+	pToc->pArr = pCtx->alloc.fpCalloc(pToc->size, sizeof(MapTocEntry));
+	for (I32 i = 0; i < pToc->count; ++i) {
+		MapTocEntry *pEntry = pToc->pArr + i;
+		stucDecodeValue(pByteString, (U8 *)&pEntry->type, 8);
+		stucDecodeValue(pByteString, (U8 *)&pEntry->offset, 64);
+		PIX_ERR_THROW_IFNOT_COND(
+			err,
+			pEntry->offset >= (i ? pEntry[-1].offset : 0) &&
+			pEntry->offset < pHeader->dataSize,
+			"toc entry offset is out of bounds",
+			0
+		);
+	}
+	err = isDataTagInvalid(pByteString, TAG_CHUNKS);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	PIX_ERR_THROW_IFNOT_COND(
+		err,
+		!pToc->pArr[0].offset,
+		"map chunk table has no matching toc",
+		0
+	);
+	I64 compressedSum = 0;
+	for (I32 i = 0; i < pToc->count; ++i) {
+		MapTocEntry *pEntry = pToc->pArr + i;
+		stucDecodeValue(pByteString, (U8 *)&pEntry->codec, 8);
+		stucDecodeValue(pByteString, (U8 *)&pEntry->pos, 64);
+		stucDecodeValue(pByteString, (U8 *)&pEntry->sizeCompressed, 64);
+		PIX_ERR_THROW_IFNOT_COND(
+			err,
+			pEntry->pos >= 0 && pEntry->sizeCompressed >= 0,
+			"map chunk table is corrupt",
+			0
+		);
+		compressedSum += pEntry->sizeCompressed;
+	}
+	PIX_ERR_THROW_IFNOT_COND(
+		err,
+		compressedSum == pHeader->dataSizeCompressed,
+		"map chunk table is corrupt",
+		0
+	);
+	PIX_ERR_CATCH(0, err,
+		stucMapDepsDestroy(&pCtx->alloc, pDeps);
+		destroyMapToc(&pCtx->alloc, &pHeader->toc);
+	);
 	if (pBuf) {
 		pCtx->alloc.fpFree(pBuf);
 	}
@@ -1425,6 +3787,90 @@ StucErr loadIdxRedirects(
 	return err;
 }
 
+static
+StucErr loadQuantizedAttribs(
+	StucContext pCtx,
+	ByteString *pData,
+	StucMesh *pMesh,
+	MeshQuant *pQuant
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	U8 flags = 0;
+	stucDecodeValue(pData, &flags, 8);
+	pQuant->deltaLists = flags & 0x1;
+	stucDecodeValue(pData, (U8 *)&pQuant->count, 8);
+	PIX_ERR_RETURN_IFNOT_COND(err, pQuant->count <= 3, "invalid quantized attrib count");
+	for (I32 i = 0; i < pQuant->count; ++i) {
+		QuantAttrib *pAttrib = pQuant->attribs + i;
+		stucDecodeValue(pData, (U8 *)&pAttrib->domain, 8);
+		stucDecodeValue(pData, (U8 *)&pAttrib->idx, 16);
+		stucDecodeValue(pData, (U8 *)&pAttrib->use, 8);
+		stucDecodeValue(pData, (U8 *)&pAttrib->bits, 8);
+		stucDecodeValue(pData, (U8 *)&pAttrib->compCount, 8);
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			pAttrib->bits > 0 && pAttrib->bits <= 24 &&
+			pAttrib->compCount > 0 && pAttrib->compCount <= 3,
+			"invalid quantized attrib"
+		);
+		for (I32 j = 0; j < pAttrib->compCount; ++j) {
+			stucDecodeValue(pData, (U8 *)&pAttrib->min[j], 32);
+			stucDecodeValue(pData, (U8 *)&pAttrib->max[j], 32);
+		}
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			pAttrib->domain >= STUC_DOMAIN_FACE && pAttrib->domain <= STUC_DOMAIN_VERT,
+			"invalid quantized attrib domain"
+		);
+		AttribArray *pArr = stucGetAttribArrFromDomain(pMesh, pAttrib->domain);
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			pAttrib->idx >= 0 && pAttrib->idx < pArr->count,
+			"quantized attrib idx is out of bounds"
+		);
+		Attrib *pMeshAttrib = pArr->pArr + pAttrib->idx;
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			!pMeshAttrib->core.pData &&
+			stucGetAttribSizeIntern(pMeshAttrib->core.type) ==
+				(pAttrib->use == STUC_ATTRIB_USE_NORMAL ? 3 : pAttrib->compCount) *
+				(I32)sizeof(F32),
+			"quantized attrib doesn't match mesh attrib"
+		);
+		pAttrib->pAttrib = pMeshAttrib;
+	}
+	for (I32 i = 0; i < pQuant->count; ++i) {
+		const QuantAttrib *pAttrib = pQuant->attribs + i;
+		Attrib *pMeshAttrib = (Attrib *)pAttrib->pAttrib;
+		I32 dataLen = stucDomainCountGetIntern(pMesh, pAttrib->domain);
+		pMeshAttrib->core.pData = dataLen ?
+			pCtx->alloc.fpCalloc(dataLen, stucGetAttribSizeIntern(pMeshAttrib->core.type)) :
+			NULL;
+		U32 mask = (1u << pAttrib->bits) - 1;
+		for (I32 j = 0; j < dataLen; ++j) {
+			F32 comps[3] = {0};
+			for (I32 k = 0; k < pAttrib->compCount; ++k) {
+				U32 value = 0;
+				stucDecodeValue(pData, (U8 *)&value, pAttrib->bits);
+				comps[k] = dequantize(
+					value & mask,
+					pAttrib->min[k],
+					pAttrib->max[k],
+					pAttrib->bits
+				);
+			}
+			F32 *pValue = stucAttribAsVoid(&pMeshAttrib->core, j);
+			if (pAttrib->use == STUC_ATTRIB_USE_NORMAL) {
+				octDecode(comps, pValue);
+			}
+			else {
+				memcpy(pValue, comps, pAttrib->compCount * sizeof(F32));
+			}
+		}
+	}
+	return err;
+}
+
 static
 StucErr loadObj(
 	StucContext pCtx,
@@ -1499,14 +3945,25 @@ StucErr loadObj(
 	stucDecodeValue(pData, (U8 *)&pMesh->edgeCount, 32);
 	stucDecodeValue(pData, (U8 *)&pMesh->vertCount, 32);
 
-	err = isDataTagInvalid(pData, TAG_MESH_ATTRIBS);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
+	MeshQuant quant = {0};
+	tag = decodeDataTag(pData, NULL);
+	if (tag == TAG_QUANTIZE) {
+		err = loadQuantizedAttribs(pCtx, pData, pMesh, &quant);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+		tag = decodeDataTag(pData, NULL);
+	}
+	PIX_ERR_THROW_IFNOT_COND(err, tag == TAG_MESH_ATTRIBS, "", 0);
 	decodeAttribs(pCtx, pData, &pMesh->meshAttribs, 1);
 	err = isDataTagInvalid(pData, TAG_FACE_LIST);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 	pMesh->pFaces = pCtx->alloc.fpCalloc(pMesh->faceCount + 1, sizeof(I32));
+	if (quant.deltaLists) {
+		decodeDeltaList(pData, pMesh->pFaces, pMesh->faceCount);
+	}
 	for (I32 i = 0; i < pMesh->faceCount; ++i) {
-		stucDecodeValue(pData, (U8 *)&pMesh->pFaces[i], 32);
+		if (!quant.deltaLists) {
+			stucDecodeValue(pData, (U8 *)&pMesh->pFaces[i], 32);
+		}
 		PIX_ERR_ASSERT("",
 			pMesh->pFaces[i] >= 0 &&
 			pMesh->pFaces[i] < pMesh->cornerCount
@@ -1521,13 +3978,19 @@ StucErr loadObj(
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 	pMesh->pCorners = pCtx->alloc.fpCalloc(pMesh->cornerCount, sizeof(I32));
 	pMesh->pEdges = pCtx->alloc.fpCalloc(pMesh->cornerCount, sizeof(I32));
+	if (quant.deltaLists) {
+		decodeDeltaList(pData, pMesh->pCorners, pMesh->cornerCount);
+		decodeDeltaList(pData, pMesh->pEdges, pMesh->cornerCount);
+	}
 	for (I32 i = 0; i < pMesh->cornerCount; ++i) {
-		stucDecodeValue(pData, (U8 *)&pMesh->pCorners[i], 32);
+		if (!quant.deltaLists) {
+			stucDecodeValue(pData, (U8 *)&pMesh->pCorners[i], 32);
+			stucDecodeValue(pData, (U8 *)&pMesh->pEdges[i], 32);
+		}
 		PIX_ERR_ASSERT("",
 			pMesh->pCorners[i] >= 0 &&
 			pMesh->pCorners[i] < pMesh->vertCount
 		);
-		stucDecodeValue(pData, (U8 *)&pMesh->pEdges[i], 32);
 		PIX_ERR_ASSERT("",
 			pMesh->pEdges[i] >= 0 &&
 			pMesh->pEdges[i] < pMesh->edgeCount
@@ -1651,6 +4114,76 @@ StucErr loadMapOverrides(
 	return err;
 }
 
+static
+StucErr loadBakedTarget(StucContext pCtx, ByteString *pData, BakedTarget *pBaked) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, !pBaked->obj.pData, "target was baked twice");
+	stucDecodeValue(pData, (U8 *)&pBaked->depCount, 16);
+	pBaked->pDeps = pBaked->depCount ?
+		pCtx->alloc.fpCalloc(pBaked->depCount, sizeof(BakedTargetDep)) : NULL;
+	for (I32 i = 0; i < pBaked->depCount; ++i) {
+		stucDecodeValue(pData, (U8 *)&pBaked->pDeps[i].map, 16);
+		stucDecodeValue(pData, (U8 *)&pBaked->pDeps[i].depTreeHash, 64);
+	}
+	StucAttribIndexedArr *pIdxAttribs = &pBaked->idxAttribs;
+	stucDecodeValue(pData, (U8 *)&pIdxAttribs->count, 32);
+	PIX_ERR_RETURN_IFNOT_COND(err, pIdxAttribs->count >= 0, "");
+	if (pIdxAttribs->count) {
+		pIdxAttribs->size = pIdxAttribs->count;
+		pIdxAttribs->pArr = pCtx->alloc.fpCalloc(pIdxAttribs->size, sizeof(AttribIndexed));
+		err = decodeIndexedAttribMeta(pData, pIdxAttribs);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		decodeIndexedAttribs(pCtx, pData, pIdxAttribs);
+	}
+	err = loadObj(pCtx, &pBaked->obj, pData, false, NULL);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	return err;
+}
+
+void stucMapLodArrDestroy(StucContext pCtx, MapLodArr *pArr) {
+	for (I32 i = 0; i < pArr->count; ++i) {
+		if (pArr->pArr[i].obj.pData) {
+			StucMesh *pMesh = (StucMesh *)pArr->pArr[i].obj.pData;
+			stucMeshDestroy(pCtx, pMesh);
+			pCtx->alloc.fpFree(pMesh);
+		}
+	}
+	if (pArr->pArr) {
+		pCtx->alloc.fpFree(pArr->pArr);
+	}
+	*pArr = (MapLodArr){0};
+}
+
+static
+StucErr loadLod(StucContext pCtx, ByteString *pData, I32 objIdx, MapLodArr *pLodArr) {
+	StucErr err = PIX_ERR_SUCCESS;
+	I32 level = 0;
+	stucDecodeValue(pData, (U8 *)&level, 8);
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		level > 0 && level <= STUC_MAP_LOD_MAX,
+		"lod level is out of range"
+	);
+	if (!pLodArr) {
+		//caller doesn't use lods, the object's decoded only to move past it
+		StucObject obj = {0};
+		err = loadObj(pCtx, &obj, pData, false, NULL);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		stucMeshDestroy(pCtx, (StucMesh *)obj.pData);
+		pCtx->alloc.fpFree(obj.pData);
+		return err;
+	}
+	I32 newIdx = 0;
+	PIXALC_DYN_ARR_ADD(MapLod, &pCtx->alloc, pLodArr, newIdx);
+	pLodArr->pArr[newIdx] = (MapLod){.objIdx = objIdx, .level = level};
+	err = loadObj(pCtx, &pLodArr->pArr[newIdx].obj, pData, false, NULL);
+	if (err != PIX_ERR_SUCCESS) {
+		--pLodArr->count;//the mesh is freed by loadObj on failure
+	}
+	PIX_ERR_RETURN_IFNOT(err, "");
+	return err;
+}
+
 static
 void destroyUsgArrTemp(const StucContext pCtx, StucUsgArr *pArr) {
 	for (I32 i = 0; i < pArr->count; ++i) {
@@ -1673,6 +4206,7 @@ StucErr loadDataByTag(
 	ObjMapOptsArr *pMapOptsArr,
 	StucUsgArr *pUsgArr,
 	StucObjArr *pCutoffArr,
+	MapLodArr *pLodArr,
 	StucIdxTableArr *pIdxTableArrs,
 	AttribIndexedArr *pIndexedAttribs
 ) {
@@ -1690,6 +4224,25 @@ StucErr loadDataByTag(
 			PIX_ERR_RETURN_IFNOT(err, "");
 			break;
 		}
+		case TAG_BAKED_TARGET: {
+			//always directly follows the target it belongs to
+			PIX_ERR_RETURN_IFNOT_COND(
+				err,
+				pMapOptsArr->count &&
+					pMapOptsArr->pArr[pMapOptsArr->count - 1].obj == pObjArr->count - 1,
+				"baked target has no matching target"
+			);
+			ObjMapOpts *pOpts = pMapOptsArr->pArr + pMapOptsArr->count - 1;
+			err = loadBakedTarget(pCtx, pData, &pOpts->baked);
+			PIX_ERR_RETURN_IFNOT(err, "");
+			break;
+		}
+		case TAG_LOD:
+			//always follows the object it belongs to, in the same record
+			PIX_ERR_RETURN_IFNOT_COND(err, pObjArr->count, "lod has no matching object");
+			err = loadLod(pCtx, pData, pObjArr->count - 1, pLodArr);
+			PIX_ERR_RETURN_IFNOT(err, "");
+			break;
 		case TAG_TYPE_USG: {
 			PIX_ERR_RETURN_IFNOT_COND(err, pUsgArr->count < pHeader->usgCount, "");
 			StucUsg *pUsg = pUsgArr->pArr + pUsgArr->count;
@@ -1780,6 +4333,96 @@ StucErr correctIdxAttribsOnLoad(
 	return err;
 }
 
+static
+bool isObjInFilter(const StucMapLoadFilter *pFilter, I32 objIdx) {
+	if (!pFilter->pObjIdxArr) {
+		return true;
+	}
+	for (I32 i = 0; i < pFilter->objIdxCount; ++i) {
+		if (pFilter->pObjIdxArr[i] == objIdx) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static
+bool isTocEntryInFilter(
+	const StucMapLoadFilter *pFilter,
+	const MapTocEntry *pEntry,
+	I32 objIdx
+) {
+	switch (pEntry->type) {
+		case TAG_TYPE_TARGET:
+		case TAG_TYPE_OBJECT:
+			return isObjInFilter(pFilter, objIdx);
+		case TAG_TYPE_USG:
+			return !pFilter->skipUsgs;
+		case TAG_TYPE_USG_FLAT_CUTOFF:
+			return !pFilter->skipFlatCutoffs;
+		case TAG_IDX_ATTRIBS:
+			//decoded objects need these to correct their idx attribs
+			return !pFilter->skipIdxAttribs ||
+				!pFilter->pObjIdxArr ||
+				pFilter->objIdxCount > 0;
+		default:
+			return false;
+	}
+}
+
+static
+StucErr decodeFilteredRecords(
+	StucContext pCtx,
+	StucHeader *pHeader,
+	ByteString *pData,
+	StucObjArr *pObjArr,
+	ObjMapOptsArr *pMapOptsArr,
+	StucUsgArr *pUsgArr,
+	StucObjArr *pCutoffArr,
+	MapLodArr *pLodArr,
+	StucIdxTableArr *pIdxTableArrs,
+	AttribIndexedArr *pIndexedAttribs,
+	const StucMapLoadFilter *pFilter
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	I32 objIdx = 0;
+	for (I32 i = 0; i < pHeader->toc.count; ++i) {
+		const MapTocEntry *pEntry = pHeader->toc.pArr + i;
+		bool inFilter = isTocEntryInFilter(pFilter, pEntry, objIdx);
+		if (isTocEntryObj(pEntry)) {
+			//objects are decoded into their file-order slot, so indices match
+			//a full load. Skipped slots are left with a NULL pData
+			pObjArr->count = objIdx;
+			++objIdx;
+		}
+		if (!inFilter) {
+			continue;
+		}
+		I64 end = getTocRecordEnd(pHeader, i);
+		PIX_ERR_RETURN_IFNOT_COND(err, end <= pData->size, "toc record is out of bounds");
+		pData->byteIdx = pEntry->offset;
+		pData->nextBitIdx = 0;
+		do {
+			err = loadDataByTag(
+				pCtx,
+				pHeader,
+				pData,
+				pObjArr,
+				pMapOptsArr,
+				pUsgArr,
+				pCutoffArr,
+				pLodArr,
+				pIdxTableArrs,
+				pIndexedAttribs
+			);
+			err = streamErrGet(pData, err);
+			PIX_ERR_RETURN_IFNOT(err, "");
+		} while(pData->byteIdx + (pData->nextBitIdx > 0) < end);
+	}
+	pObjArr->count = objIdx;
+	return err;
+}
+
 static
 StucErr decodeStucData(
 	StucContext pCtx,
@@ -1789,9 +4432,11 @@ StucErr decodeStucData(
 	ObjMapOptsArr *pMapOptsArr,
 	StucUsgArr *pUsgArr,
 	StucObjArr *pCutoffArr,
+	MapLodArr *pLodArr,
 	StucIdxTableArr **ppIdxTableArrs,
 	AttribIndexedArr *pIndexedAttribs,
-	bool correctIdxAttribs
+	bool correctIdxAttribs,
+	const StucMapLoadFilter *pFilter
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	PIX_ERR_RETURN_IFNOT_COND(err, pHeader->objCount, "no objects in stuc file");
@@ -1807,9 +4452,8 @@ StucErr decodeStucData(
 	}
 	StucIdxTableArr *pIdxTableArrs =
 		pCtx->alloc.fpCalloc(pHeader->objCount, sizeof(StucIdxTableArr));
-	do {
-		PIX_ERR_THROW_IFNOT_COND(err, pData->byteIdx < pData->size, "", 0);
-		err = loadDataByTag(
+	if (pFilter) {
+		err = decodeFilteredRecords(
 			pCtx,
 			pHeader,
 			pData,
@@ -1817,14 +4461,42 @@ StucErr decodeStucData(
 			pMapOptsArr,
 			pUsgArr,
 			pCutoffArr,
+			pLodArr,
 			pIdxTableArrs,
-			pIndexedAttribs
+			pIndexedAttribs,
+			pFilter
 		);
 		PIX_ERR_THROW_IFNOT(err, "", 0);
-	} while(pData->byteIdx != pData->size);
+	}
+	else {
+		do {
+			PIX_ERR_THROW_IFNOT_COND(err, pData->byteIdx < pData->size, "", 0);
+			err = loadDataByTag(
+				pCtx,
+				pHeader,
+				pData,
+				pObjArr,
+				pMapOptsArr,
+				pUsgArr,
+				pCutoffArr,
+				pLodArr,
+				pIdxTableArrs,
+				pIndexedAttribs
+			);
+			err = streamErrGet(pData, err);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+		} while(pData->byteIdx != pData->size);
+		if (pData->pStream) {
+			err = streamEndCheck(pData->pStream, pData);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+		}
+	}
 	if (correctIdxAttribs) {
 		for (I32 i = 0; i < pObjArr->count; ++i) {
 			StucMesh *pMesh = (StucMesh *)pObjArr->pArr[i].pData;
+			if (!pMesh) {
+				continue;//skipped by the filter
+			}
 			err = correctIdxAttribsOnLoad(
 				pCtx,
 				pIndexedAttribs,
@@ -1833,6 +4505,17 @@ StucErr decodeStucData(
 			);
 			PIX_ERR_THROW_IFNOT(err, "", 0);
 		}
+		//lods are copies of their object, so they share its idx table
+		for (I32 i = 0; pLodArr && i < pLodArr->count; ++i) {
+			MapLod *pLod = pLodArr->pArr + i;
+			err = correctIdxAttribsOnLoad(
+				pCtx,
+				pIndexedAttribs,
+				pIdxTableArrs + pLod->objIdx,
+				(StucMesh *)pLod->obj.pData
+			);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+		}
 		destroyIdxTableArrs(&pCtx->alloc, &pIdxTableArrs, pObjArr->count);
 	}
 	else {
@@ -1849,6 +4532,9 @@ StucErr decodeStucData(
 		stucObjArrDestroy(pCtx, pObjArr);
 		destroyUsgArrTemp(pCtx, pUsgArr);
 		stucObjArrDestroy(pCtx, pCutoffArr);
+		if (pLodArr) {
+			stucMapLodArrDestroy(pCtx, pLodArr);
+		}
 	);
 	return err;
 }
@@ -1857,7 +4543,7 @@ static
 StucErr openMapFile(StucContext pCtx, const char *pFilepath, void **ppFile) {
 	StucErr err = PIX_ERR_SUCCESS;
 	printf("Loading STUC file: %s\n", pFilepath);
-	err = pCtx->io.fpOpen(ppFile, pFilepath, 1, &pCtx->alloc);
+	err = pCtx->io.fpOpen(ppFile, pFilepath, STUC_FILE_OPEN_READ, &pCtx->alloc);
 	PIX_ERR_RETURN_IFNOT(err, "");
 	return err;
 }
@@ -1877,20 +4563,10 @@ StucErr importMapHeader(
 	headerByteString.pString = pCtx->alloc.fpMalloc(headerSize);
 	err = pCtx->io.fpRead(pFile, headerByteString.pString, headerSize);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
+	headerByteString.size = headerSize;
 	err = decodeStucHeader(pCtx, &headerByteString, pHeader, pDeps);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
-	PIX_ERR_THROW_IFNOT_COND(
-		err,
-		!strncmp(pHeader->format, MAP_FORMAT_NAME, MAP_FORMAT_NAME_MAX_LEN),
-		"map file is corrupt",
-		0
-	);
-	PIX_ERR_THROW_IFNOT_COND(
-		err, 
-		pHeader->version == STUC_MAP_VERSION,
-		"map file version not supported",
-		0
-	);
+	pHeader->headerCapacity = headerSize;
 	PIX_ERR_CATCH(0, err, ;);
 	if (headerByteString.pString) {
 		pCtx->alloc.fpFree(headerByteString.pString);
@@ -1913,12 +4589,35 @@ StucErr stucMapImportGetDep(
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 
 	PIX_ERR_CATCH(0, err, stucMapDepsDestroy(&pCtx->alloc, pDeps););
+	destroyMapToc(&pCtx->alloc, &header.toc);
 	if (pFile) {
 		pCtx->io.fpClose(pFile);
 	}
 	return err;
 }
 
+static
+void streamChunksInit(MapDataStream *pStream, const StucHeader *pHeader) {
+	const StucAlloc *pAlloc = &pStream->pCtx->alloc;
+	pStream->chunkCount = pHeader->toc.count;
+	pStream->pChunks = pAlloc->fpCalloc(pStream->chunkCount, sizeof(MapChunk));
+	pStream->contiguous = true;
+	I64 pos = 0;
+	for (I32 i = 0; i < pStream->chunkCount; ++i) {
+		const MapTocEntry *pEntry = pHeader->toc.pArr + i;
+		pStream->pChunks[i] = (MapChunk){
+			.size = getTocRecordEnd(pHeader, i) - pEntry->offset,
+			.pos = pEntry->pos,
+			.sizeCompressed = pEntry->sizeCompressed,
+			.codec = pEntry->codec
+		};
+		pStream->contiguous &= pEntry->pos == pos;
+		pos += pEntry->sizeCompressed;
+	}
+	//steps over any empty leading chunks
+	streamReadCursorAdvance(pStream, 0);
+}
+
 StucErr stucMapImport(
 	StucContext pCtx,
 	const char *filePath,
@@ -1926,48 +4625,38 @@ StucErr stucMapImport(
 	ObjMapOptsArr *pMapOptsArr,
 	StucUsgArr *pUsgArr,
 	StucObjArr *pCutoffArr,
+	MapLodArr *pLodArr,
 	StucIdxTableArr **ppIdxTableArrs,
 	StucAttribIndexedArr *pIndexedAttribs,
-	bool correctIdxAttribs
+	bool correctIdxAttribs,
+	const StucMapLoadFilter *pFilter,
+	bool inPoolJob
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	void *pFile = NULL;
-	U8 *pDataRaw = NULL;
 	ByteString dataByteString = {0};
 	StucHeader header = {0};
 	StucMapDeps deps = {0};
+	MapDataStream stream = {.pCtx = pCtx, .err = PIX_ERR_SUCCESS, .inPoolJob = inPoolJob};
 
 	err = openMapFile(pCtx, filePath, &pFile);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 	err = importMapHeader(pCtx, pFile, &header, &deps);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 
-	//decompress data
-	z_stream zStream = {
-		.zalloc = mallocZlibWrap,
-		.zfree = freeZlibWrap,
-		.opaque = (void *)&pCtx->alloc
-	};
-	pDataRaw = pCtx->alloc.fpMalloc((I32)header.dataSizeCompressed);
-	err = pCtx->io.fpRead(pFile, pDataRaw, (I32)header.dataSizeCompressed);
+	//data is decompressed as it's decoded. With a filter, the stream stops
+	//after the last record that's needed
+	stream.pFile = pFile;
+	stream.compressedLeft = header.dataSizeCompressed;
+	stream.dataStart = getMapDataStart(&header);
+	stream.filePos = stream.dataStart;
+	streamChunksInit(&stream, &header);
+	stream.pRead[0] = pCtx->alloc.fpMalloc(STUC_STREAM_READ_SIZE);
+	stream.pRead[1] = pCtx->alloc.fpMalloc(STUC_STREAM_READ_SIZE);
+	err = streamReadSubmit(&stream);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
-	zStream.next_in = pDataRaw;
-	err = checkZlibErr(Z_OK, inflateInit2(&zStream, STUC_WINDOW_BITS));
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-	zStream.avail_in = header.dataSizeCompressed;
-	dataByteString.pString = pCtx->alloc.fpMalloc(header.dataSize);
-	zStream.next_out = dataByteString.pString;
-	zStream.avail_out = header.dataSize;
-	err = checkZlibErr(Z_STREAM_END, inflate(&zStream, Z_FINISH));
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-	err = checkZlibErr(Z_OK, inflateEnd(&zStream));
-	PIX_ERR_THROW_IFNOT(err, "", 0);
-	PIX_ERR_THROW_IFNOT_COND(
-		err,
-		zStream.total_out == header.dataSize,
-		"Failed to load STUC file. decompressed data len is wrong\n",
-		0
-	);
+	dataByteString.pString = pCtx->alloc.fpMalloc(STUC_STREAM_WINDOW_SIZE);
+	dataByteString.pStream = &stream;
 	dataByteString.size = header.dataSize;
 
 	printf("Decoding data\n");
@@ -1979,38 +4668,492 @@ StucErr stucMapImport(
 		pMapOptsArr,
 		pUsgArr,
 		pCutoffArr,
+		pLodArr,
 		ppIdxTableArrs,
 		pIndexedAttribs,
-		correctIdxAttribs
+		correctIdxAttribs,
+		pFilter
 	);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 	PIX_ERR_CATCH(0, err, ;);
+	if (stream.readPending) {
+		//filtered loads, or loads that failed, can stop with a read in flight
+		streamReadWait(&stream);
+	}
+	streamCodecStateDestroy(&stream);
+	if (stream.pChunks) {
+		pCtx->alloc.fpFree(stream.pChunks);
+	}
+	for (I32 i = 0; i < 2; ++i) {
+		if (stream.pRead[i]) {
+			pCtx->alloc.fpFree(stream.pRead[i]);
+		}
+	}
 	stucMapDepsDestroy(&pCtx->alloc, &deps);
+	destroyMapToc(&pCtx->alloc, &header.toc);
 	if (pFile) {
 		pCtx->io.fpClose(pFile);
 	}
-	if (pDataRaw) {
-		pCtx->alloc.fpFree(pDataRaw);
-	}
 	if (dataByteString.pString) {
 		pCtx->alloc.fpFree(dataByteString.pString);
 	}
 	return err;
 }
 
+//objects already in the file reference its idx attribs by position,
+//so the handle starts with them, and new entries are appended
+static
+StucErr loadUpdateSrcIdxAttribs(StucMapExport *pHandle, const char *pSrcPath) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucContext pCtx = pHandle->pCtx;
+	StucObjArr objArr = {0};
+	StucUsgArr usgArr = {0};
+	StucObjArr cutoffArr = {0};
+	ObjMapOptsArr mapOptsArr = {0};
+	StucMapLoadFilter filter = {
+		.pObjIdxArr = (I32[1]){0},
+		.objIdxCount = 0,
+		.skipUsgs = true,
+		.skipFlatCutoffs = true
+	};
+	err = stucMapImport(
+		pCtx, pSrcPath,
+		&objArr,
+		&mapOptsArr,
+		&usgArr,
+		&cutoffArr,
+		NULL,
+		NULL,
+		&pHandle->idxAttribs,
+		true,
+		&filter,
+		false
+	);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	//objects keep their slots, but none are decoded
+	PIX_ERR_ASSERT("", !usgArr.count && !cutoffArr.count);
+	for (I32 i = 0; i < objArr.count; ++i) {
+		PIX_ERR_ASSERT("", !objArr.pArr[i].pData);
+	}
+	PIX_ERR_ASSERT("", !mapOptsArr.count && !mapOptsArr.pArr);
+	stucObjArrDestroy(pCtx, &objArr);
+	destroyUsgArrTemp(pCtx, &usgArr);
+	stucObjArrDestroy(pCtx, &cutoffArr);
+	for (I32 i = 0; i < pHandle->idxAttribs.count; ++i) {
+		AttribIndexed *pAttrib = pHandle->idxAttribs.pArr + i;
+		pAttrib->size = pAttrib->count;
+	}
+	return err;
+}
+
+StucErr stucMapExportUpdateInit(
+	StucContext pCtx,
+	StucMapExport **ppHandle,
+	const char *pSrcPath,
+	const char *pPath,
+	bool compress
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pCtx && ppHandle && pSrcPath, "invalid args");
+	StucAlloc *pAlloc = &pCtx->alloc;
+	StucMapExport *pHandle = NULL;
+	void *pFile = NULL;
+	err = stucMapExportInit(pCtx, &pHandle, pPath, compress);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	MapExportSrc *pSrc = pAlloc->fpCalloc(1, sizeof(MapExportSrc));
+	pHandle->pSrc = pSrc;
+
+	err = openMapFile(pCtx, pSrcPath, &pFile);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	err = importMapHeader(pCtx, pFile, &pSrc->header, &pSrc->deps);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	//records aren't read here. If pPath is the src file, new records are appended
+	//in place. Otherwise, kept records are read when the handle's ended
+	I32 recordCount = pSrc->header.toc.count;
+	pSrc->pReplacedBy = pAlloc->fpMalloc(recordCount * sizeof(I32));
+	for (I32 i = 0; i < recordCount; ++i) {
+		pSrc->pReplacedBy[i] = -1;
+	}
+	I32 srcPathLen = strnlen(pSrcPath, pixioPathMaxGet()) + 1;
+	pSrc->pPath = pAlloc->fpCalloc(srcPathLen, 1);
+	memcpy(pSrc->pPath, pSrcPath, srcPathLen - 1);
+	pSrc->inPlace = pCtx->io.fpSeek && !strcmp(pHandle->pPath, pSrc->pPath);
+	err = pCtx->io.fpClose(pFile);
+	pFile = NULL;
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+
+	err = loadUpdateSrcIdxAttribs(pHandle, pSrcPath);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	pHandle->header.objCount = pSrc->header.objCount;
+	pHandle->header.usgCount = pSrc->header.usgCount;
+	pHandle->header.cutoffCount = pSrc->header.cutoffCount;
+	*ppHandle = pHandle;
+	PIX_ERR_CATCH(0, err,
+		destroyMapExport(pHandle);
+		pAlloc->fpFree(pHandle);
+	);
+	if (pFile) {
+		pCtx->io.fpClose(pFile);
+	}
+	return err;
+}
+
+//marks the idx'th record of a type in the file being updated as replaced
+//by the next record added to the handle
+static
+StucErr updateSrcRecordReplace(
+	StucMapExport *pHandle,
+	bool (* fpIsType)(const MapTocEntry *),
+	I32 idx
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pHandle, "invalid handle");
+	MapExportSrc *pSrc = pHandle->pSrc;
+	PIX_ERR_RETURN_IFNOT_COND(err, pSrc, "handle isn't updating a map file");
+	PIX_ERR_RETURN_IFNOT_COND(err, idx >= 0, "invalid idx");
+	for (I32 i = 0; i < pSrc->header.toc.count; ++i) {
+		if (!fpIsType(pSrc->header.toc.pArr + i)) {
+			continue;
+		}
+		if (idx) {
+			--idx;
+			continue;
+		}
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			pSrc->pReplacedBy[i] == -1,
+			"record has already been replaced"
+		);
+		pSrc->pReplacedBy[i] = pHandle->toc.count;
+		return err;
+	}
+	PIX_ERR_RETURN(err, "idx is out of bounds");
+}
+
+StucErr stucMapExportObjReplace(
+	StucMapExport *pHandle,
+	I32 objIdx,
+	const StucObject *pObj,
+	const StucAttribIndexedArr *pIndexedAttribs
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	err = updateSrcRecordReplace(pHandle, isTocEntryObj, objIdx);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	err = stucMapExportObjAdd(pHandle, pObj, pIndexedAttribs);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	--pHandle->header.objCount;
+	return err;
+}
+
+StucErr stucMapExportUsgReplace(StucMapExport *pHandle, I32 usgIdx, StucUsg *pUsg) {
+	StucErr err = PIX_ERR_SUCCESS;
+	err = updateSrcRecordReplace(pHandle, isTocEntryUsg, usgIdx);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	err = stucMapExportUsgAdd(pHandle, pUsg);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	--pHandle->header.usgCount;
+	return err;
+}
+
+StucErr stucMapExportUsgCutoffReplace(
+	StucMapExport *pHandle,
+	I32 cutoffIdx,
+	StucObject *pFlatCutoff
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	err = updateSrcRecordReplace(pHandle, isTocEntryCutoff, cutoffIdx);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	err = stucMapExportUsgCutoffAdd(pHandle, pFlatCutoff);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	--pHandle->header.cutoffCount;
+	return err;
+}
+
 void stucIoSetCustom(StucContext pCtx, StucIo *pIo) {
 	if (!pIo->fpOpen || !pIo->fpClose || !pIo->fpWrite || !pIo->fpRead) {
 		printf("Failed to set custom IO. One or more functions were NULL");
 		abort();
 	}
+	if (!pIo->fpReadSubmit != !pIo->fpReadPoll) {
+		printf("Failed to set custom IO. Async read funcs must both be set, or both be NULL");
+		abort();
+	}
 	pCtx->io = *pIo;
 }
 
+//Default io uses stdio directly, as updating map files in place needs
+//a file opened for both reading and writing, and a seek.
+//Async reads are run on an io thread owned by the file, started on the first
+//submit, so read-ahead never occupies a pool worker.
+//Only one async read can be in flight per file
+typedef struct IoThread {
+#ifdef _WIN32
+	HANDLE thread;
+	CRITICAL_SECTION mutex;
+	CONDITION_VARIABLE cond;
+#else
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+#endif
+	U8 *pBuf;
+	I32 size;
+	StucErr err;
+	bool pending;
+	bool done;
+	bool stop;
+} IoThread;
+
+typedef struct IoFile {
+	FILE *pFile;
+	const StucAlloc *pAlloc;
+	IoThread *pThread;
+} IoFile;
+
+#ifdef _WIN32
+#define IO_THREAD_LOCK(pThread) EnterCriticalSection(&(pThread)->mutex)
+#define IO_THREAD_UNLOCK(pThread) LeaveCriticalSection(&(pThread)->mutex)
+#define IO_THREAD_WAIT(pThread) \
+	SleepConditionVariableCS(&(pThread)->cond, &(pThread)->mutex, INFINITE)
+#define IO_THREAD_WAKE(pThread) WakeAllConditionVariable(&(pThread)->cond)
+#else
+#define IO_THREAD_LOCK(pThread) pthread_mutex_lock(&(pThread)->mutex)
+#define IO_THREAD_UNLOCK(pThread) pthread_mutex_unlock(&(pThread)->mutex)
+#define IO_THREAD_WAIT(pThread) pthread_cond_wait(&(pThread)->cond, &(pThread)->mutex)
+#define IO_THREAD_WAKE(pThread) pthread_cond_broadcast(&(pThread)->cond)
+#endif
+
+static
+StucErr ioFileReadIntern(FILE *pFile, U8 *pData, I32 bytesToRead) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, bytesToRead >= 0, "invalid size");
+	size_t read = fread(pData, 1, bytesToRead, pFile);
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		read == (size_t)bytesToRead,
+		"failed to read file, or reached end of file"
+	);
+	return err;
+}
+
+static
+#ifdef _WIN32
+DWORD WINAPI ioThreadMain(void *pArgs) {
+#else
+void *ioThreadMain(void *pArgs) {
+#endif
+	IoFile *pIoFile = pArgs;
+	IoThread *pThread = pIoFile->pThread;
+	IO_THREAD_LOCK(pThread);
+	do {
+		while (!pThread->pending && !pThread->stop) {
+			IO_THREAD_WAIT(pThread);
+		}
+		if (!pThread->pending) {
+			break;//stopped
+		}
+		U8 *pBuf = pThread->pBuf;
+		I32 size = pThread->size;
+		IO_THREAD_UNLOCK(pThread);
+		StucErr err = ioFileReadIntern(pIoFile->pFile, pBuf, size);
+		IO_THREAD_LOCK(pThread);
+		pThread->err = err;
+		pThread->pending = false;
+		pThread->done = true;
+		IO_THREAD_WAKE(pThread);
+	} while (true);
+	IO_THREAD_UNLOCK(pThread);
+	return 0;
+}
+
+static
+StucErr ioThreadStart(IoFile *pIoFile) {
+	StucErr err = PIX_ERR_SUCCESS;
+	IoThread *pThread = pIoFile->pAlloc->fpCalloc(1, sizeof(IoThread));
+	pIoFile->pThread = pThread;
+#ifdef _WIN32
+	InitializeCriticalSection(&pThread->mutex);
+	InitializeConditionVariable(&pThread->cond);
+	pThread->thread = CreateThread(NULL, 0, ioThreadMain, pIoFile, 0, NULL);
+	bool started = pThread->thread != NULL;
+#else
+	pthread_mutex_init(&pThread->mutex, NULL);
+	pthread_cond_init(&pThread->cond, NULL);
+	bool started = !pthread_create(&pThread->thread, NULL, ioThreadMain, pIoFile);
+#endif
+	if (!started) {
+#ifdef _WIN32
+		DeleteCriticalSection(&pThread->mutex);
+#else
+		pthread_cond_destroy(&pThread->cond);
+		pthread_mutex_destroy(&pThread->mutex);
+#endif
+		pIoFile->pAlloc->fpFree(pThread);
+		pIoFile->pThread = NULL;
+	}
+	PIX_ERR_RETURN_IFNOT_COND(err, started, "failed to start io thread");
+	return err;
+}
+
+//waits for any in-flight read, then joins the thread
+static
+void ioThreadStop(IoFile *pIoFile) {
+	IoThread *pThread = pIoFile->pThread;
+	IO_THREAD_LOCK(pThread);
+	pThread->stop = true;
+	IO_THREAD_WAKE(pThread);
+	IO_THREAD_UNLOCK(pThread);
+#ifdef _WIN32
+	WaitForSingleObject(pThread->thread, INFINITE);
+	CloseHandle(pThread->thread);
+	DeleteCriticalSection(&pThread->mutex);
+#else
+	pthread_join(pThread->thread, NULL);
+	pthread_cond_destroy(&pThread->cond);
+	pthread_mutex_destroy(&pThread->mutex);
+#endif
+	pIoFile->pAlloc->fpFree(pThread);
+	pIoFile->pThread = NULL;
+}
+
+static
+StucErr ioFileOpen(
+	void **ppFile,
+	const char *pPath,
+	StucFileOpenType type,
+	const StucAlloc *pAlloc
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	const char *pMode = NULL;
+	switch (type) {
+		case STUC_FILE_OPEN_WRITE:
+			pMode = "wb";
+			break;
+		case STUC_FILE_OPEN_READ:
+			pMode = "rb";
+			break;
+		case STUC_FILE_OPEN_UPDATE:
+			pMode = "r+b";
+			break;
+		default:
+			PIX_ERR_RETURN(err, "invalid file open type");
+	}
+	FILE *pFile = fopen(pPath, pMode);
+	PIX_ERR_RETURN_IFNOT_COND(err, pFile, "failed to open file");
+	IoFile *pIoFile = pAlloc->fpCalloc(1, sizeof(IoFile));
+	*pIoFile = (IoFile){.pFile = pFile, .pAlloc = pAlloc};
+	*ppFile = pIoFile;
+	return err;
+}
+
+static
+StucErr ioFileClose(void *pFile) {
+	StucErr err = PIX_ERR_SUCCESS;
+	IoFile *pIoFile = pFile;
+	if (pIoFile->pThread) {
+		ioThreadStop(pIoFile);
+	}
+	bool closed = !fclose(pIoFile->pFile);
+	pIoFile->pAlloc->fpFree(pIoFile);
+	PIX_ERR_RETURN_IFNOT_COND(err, closed, "failed to close file");
+	return err;
+}
+
+static
+StucErr ioFileWrite(void *pFile, const unsigned char *pData, int32_t dataSize) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, dataSize >= 0, "invalid size");
+	size_t written = fwrite(pData, 1, dataSize, ((IoFile *)pFile)->pFile);
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		written == (size_t)dataSize,
+		"failed to write to file"
+	);
+	return err;
+}
+
+static
+StucErr ioFileRead(void *pFile, unsigned char *pData, int32_t bytesToRead) {
+	IoFile *pIoFile = pFile;
+	PIX_ERR_ASSERT(
+		"sync read while an async read is in flight",
+		!pIoFile->pThread || !pIoFile->pThread->pending
+	);
+	return ioFileReadIntern(pIoFile->pFile, pData, bytesToRead);
+}
+
+//the request handle is the file itself, as only one read can be in flight
+static
+StucErr ioFileReadSubmit(
+	void *pFile,
+	unsigned char *pData,
+	int32_t bytesToRead,
+	void **ppReq
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	IoFile *pIoFile = pFile;
+	if (!pIoFile->pThread) {
+		err = ioThreadStart(pIoFile);
+		PIX_ERR_RETURN_IFNOT(err, "");
+	}
+	IoThread *pThread = pIoFile->pThread;
+	IO_THREAD_LOCK(pThread);
+	bool idle = !pThread->pending && !pThread->done;
+	if (idle) {
+		pThread->pBuf = pData;
+		pThread->size = bytesToRead;
+		pThread->pending = true;
+		IO_THREAD_WAKE(pThread);
+	}
+	IO_THREAD_UNLOCK(pThread);
+	PIX_ERR_RETURN_IFNOT_COND(err, idle, "file already has a read in flight");
+	*ppReq = pIoFile;
+	return err;
+}
+
+static
+StucErr ioFileReadPoll(void *pReq, bool wait, bool *pDone) {
+	StucErr err = PIX_ERR_SUCCESS;
+	IoThread *pThread = ((IoFile *)pReq)->pThread;
+	IO_THREAD_LOCK(pThread);
+	while (wait && !pThread->done) {
+		IO_THREAD_WAIT(pThread);
+	}
+	*pDone = pThread->done;
+	if (pThread->done) {
+		err = pThread->err;
+		pThread->done = false;
+	}
+	IO_THREAD_UNLOCK(pThread);
+	return err;
+}
+
+static
+StucErr ioFileSeek(void *pFile, int64_t pos) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pos >= 0, "invalid file position");
+	IoFile *pIoFile = pFile;
+	PIX_ERR_ASSERT(
+		"seek while an async read is in flight",
+		!pIoFile->pThread || !pIoFile->pThread->pending
+	);
+#ifdef _WIN32
+	int result = _fseeki64(pIoFile->pFile, pos, SEEK_SET);
+#else
+	int result = fseeko(pIoFile->pFile, (off_t)pos, SEEK_SET);
+#endif
+	PIX_ERR_RETURN_IFNOT_COND(err, !result, "failed to seek file");
+	return err;
+}
+
 void stucIoSetDefault(StucContext pCtx) {
-	pCtx->io.fpOpen = pixioFileOpen;
-	pCtx->io.fpClose = pixioFileClose;
-	pCtx->io.fpWrite = pixioFileWrite;
-	pCtx->io.fpRead = pixioFileRead;
+	pCtx->io.fpOpen = ioFileOpen;
+	pCtx->io.fpClose = ioFileClose;
+	pCtx->io.fpWrite = ioFileWrite;
+	pCtx->io.fpRead = ioFileRead;
+	pCtx->io.fpReadSubmit = ioFileReadSubmit;
+	pCtx->io.fpReadPoll = ioFileReadPoll;
+	pCtx->io.fpSeek = ioFileSeek;
 }
 
 const char *stucGetBasename(const char *pStr, I32 *pNameLen, I32 *pPathLen) {
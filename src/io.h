@@ -12,13 +12,36 @@ SPDX-License-Identifier: Apache-2.0
 #include <types.h>
 #include <pixenals_structs.h>
 
+typedef struct MapDataStream MapDataStream;
+
 typedef struct ByteString {
 	unsigned char *pString;
+	//if set, pString is a window into the stream, and byteIdx is relative to
+	//the start of the stream rather than pString
+	MapDataStream *pStream;
 	I64 size;
 	I64 nextBitIdx;
 	I64 byteIdx;
 } ByteString;
 
+typedef struct MapTocEntry {
+	I64 offset; //byte offset into the uncompressed data
+	//file offset of the record's compressed chunk, relative to the start of the data.
+	//Chunks are only in toc order, with no gaps, until the file is updated in place
+	I64 pos;
+	I64 sizeCompressed;
+	I32 type; //data tag of the top-level record
+	I32 codec;
+} MapTocEntry;
+
+//table of contents of the top-level records in a map file's data,
+//used to decode only a subset of the file
+typedef struct MapToc {
+	MapTocEntry *pArr;
+	I32 size;
+	I32 count;
+} MapToc;
+
 typedef struct StucHeader {
 	char format[MAP_FORMAT_NAME_MAX_LEN];
 	I64 dataSize;
@@ -28,12 +51,29 @@ typedef struct StucHeader {
 	I32 objCount;
 	I32 usgCount;
 	I32 cutoffCount;
+	MapToc toc;
+	//reserved size of the header. Headers are padded, so they can be rewritten
+	//in place when records are added
+	I32 headerCapacity;
 } StucHeader;
 
 typedef struct StucMapDeps {
 	PixtyStrArr maps;
 } StucMapDeps;
 
+//an existing map file that's being updated.
+//Its records are kept compressed, and are written back as is unless replaced.
+//If updating in place, kept records aren't read at all
+typedef struct MapExportSrc {
+	StucHeader header;
+	StucMapDeps deps;
+	char *pPath;
+	U8 **ppChunks; //only read if the file's rewritten
+	bool inPlace;
+	//toc idx of the new record replacing each of the file's records, or -1 if kept
+	I32 *pReplacedBy;
+} MapExportSrc;
+
 typedef struct StucMapExportIntern {
 	StucContext pCtx;
 	char *pPath;
@@ -43,7 +83,11 @@ typedef struct StucMapExportIntern {
 	PixuctHTable mapTable;
 	StucAttribIndexedArr idxAttribs;
 	I8Arr matMapTable;
-	bool compress;
+	MapToc toc;
+	I32 codec;
+	StucMapQuantize quantize;
+	I32 lodCount;
+	MapExportSrc *pSrc; //NULL unless updating an existing file
 } StucMapExportIntern;
 
 typedef struct StucIdxTable {
@@ -58,8 +102,23 @@ typedef struct StucIdxTableArr {
 	bool hasRedirect;
 } StucIdxTableArr;
 
+typedef struct BakedTargetDep {
+	U64 depTreeHash; //see MapFile.depTreeHash
+	I32 map; //idx into the file's deps
+} BakedTargetDep;
+
+//pre-mapped result of a target, stored at export.
+//Only used on load if the dep trees of the maps it was mapped with still match
+typedef struct BakedTarget {
+	StucObject obj;
+	StucAttribIndexedArr idxAttribs;
+	BakedTargetDep *pDeps;
+	I32 depCount;
+} BakedTarget;
+
 typedef struct ObjMapOpts {
 	StucMapArr arr;
+	BakedTarget baked;
 	I32 obj;
 } ObjMapOpts;
 
@@ -69,6 +128,19 @@ typedef struct ObjMapOptsArr {
 	I32 count;
 } ObjMapOptsArr;
 
+//decimated copy of an object. Idx attribs are corrected with the object's table
+typedef struct MapLod {
+	StucObject obj;
+	I32 objIdx;
+	I32 level;
+} MapLod;
+
+typedef struct MapLodArr {
+	MapLod *pArr;
+	I32 size;
+	I32 count;
+} MapLodArr;
+
 StucErr stucMapImportGetDep(
 	StucContext pCtx,
 	const char *filePath,
@@ -82,13 +154,18 @@ StucErr stucMapImport(
 	ObjMapOptsArr *pMapOptsArr,
 	StucUsgArr *pUsgArr,
 	StucObjArr *pCutoffArr,
+	MapLodArr *pLodArr,
 	StucIdxTableArr **ppIdxTableArrs,
 	StucAttribIndexedArr *pIndexedAttribs,
-	bool correctIdxAttribs
+	bool correctIdxAttribs,
+	const StucMapLoadFilter *pFilter,
+	bool inPoolJob //if set, read-ahead only uses the io's fpReadSubmit
 );
+void stucMapLodArrDestroy(StucContext pCtx, MapLodArr *pArr);
 
 void stucIoSetCustom(StucContext pCtx, StucIo *pIo);
 void stucIoSetDefault(StucContext pCtx);
+void stucCodecsSetDefault(StucContext pCtx);
 void stucEncodeValue(
 	const StucAlloc *pAlloc,
 	ByteString *byteString,
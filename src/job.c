@@ -3,6 +3,8 @@ SPDX-FileCopyrightText: 2025 Caleb Dawson
 SPDX-License-Identifier: Apache-2.0
 */
 
+#include <time.h>
+
 #include <pixenals_thread_utils.h>
 
 #include <job.h>
@@ -58,3 +60,68 @@ void stucMakeJobArgs(
 		}
 	}
 }
+
+static
+U64 getTimeUsec() {
+	struct timespec time = {0};
+	timespec_get(&time, TIME_UTC);
+	return (U64)time.tv_sec * 1000000 + (U64)time.tv_nsec / 1000;
+}
+
+void stucJobCancelInit(JobCancel *pCancel, StucCancelToken *pToken) {
+	*pCancel = (JobCancel) {.pToken = pToken};
+	if (pToken && pToken->deadlineMs > 0) {
+		pCancel->deadline = getTimeUsec() + (U64)pToken->deadlineMs * 1000;
+	}
+}
+
+StucErr stucJobCancelCheck(const JobCancel *pCancel) {
+	StucErr err = PIX_ERR_SUCCESS;
+	if (!pCancel || !pCancel->pToken) {
+		return err;
+	}
+	if (!stucCancelTokenIsCancelled(pCancel->pToken) &&
+		pCancel->deadline && getTimeUsec() >= pCancel->deadline
+	) {
+		stucCancelTokenCancel(pCancel->pToken);
+	}
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		!stucCancelTokenIsCancelled(pCancel->pToken),
+		"job cancelled"
+	);
+	return err;
+}
+
+StucErr stucCancelTokenCreate(
+	StucContext pCtx,
+	StucCancelToken **ppToken,
+	int64_t deadlineMs
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pCtx && ppToken, "invalid args");
+	PIX_ERR_RETURN_IFNOT_COND(err, deadlineMs >= 0, "deadline can't be negative");
+	*ppToken = pCtx->alloc.fpMalloc(sizeof(StucCancelToken));
+	atomic_init(&(*ppToken)->cancelled, false);
+	(*ppToken)->deadlineMs = deadlineMs;
+	return err;
+}
+
+//relaxed, as the flag doesn't publish any other data
+void stucCancelTokenCancel(StucCancelToken *pToken) {
+	atomic_store_explicit(&pToken->cancelled, true, memory_order_relaxed);
+}
+
+bool stucCancelTokenIsCancelled(const StucCancelToken *pToken) {
+	return atomic_load_explicit(
+		&((StucCancelToken *)pToken)->cancelled,
+		memory_order_relaxed
+	);
+}
+
+StucErr stucCancelTokenDestroy(StucContext pCtx, StucCancelToken *pToken) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pCtx && pToken, "invalid args");
+	pCtx->alloc.fpFree(pToken);
+	return err;
+}
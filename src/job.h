@@ -4,10 +4,15 @@ SPDX-License-Identifier: Apache-2.0
 */
 
 #pragma once
+#include <stdatomic.h>
+
 #include <types.h>
 
 struct MapToMeshBasic;
 
+//sub-jobs check for cancellation once every this many items
+#define STUC_CANCEL_CHECK_INTERVAL 64
+
 typedef struct JobArgs {
 	const void *pShared;
 	StucContext pCtx;
@@ -23,3 +28,26 @@ void stucMakeJobArgs(
 	I32 (* fpGetArrCount)(StucContext, const void *, void *),
 	void (* fpInitArgEntry)(StucContext, void *, void *, void *)
 );
+
+//set from any thread, so cancelled is atomic
+struct StucCancelTokenIntern {
+	atomic_bool cancelled;
+	I64 deadlineMs;
+};
+
+typedef struct JobCancel {
+	StucCancelToken *pToken;
+	U64 deadline; //usec, 0 if none
+} JobCancel;
+
+void stucJobCancelInit(JobCancel *pCancel, StucCancelToken *pToken);
+StucErr stucJobCancelCheck(const JobCancel *pCancel);
+
+//for use in per-item loops within sub-jobs
+static inline
+StucErr stucJobCancelCheckAt(const JobCancel *pCancel, I32 idx, Range range) {
+	if ((idx - range.start) % STUC_CANCEL_CHECK_INTERVAL) {
+		return PIX_ERR_SUCCESS;
+	}
+	return stucJobCancelCheck(pCancel);
+}
@@ -27,4 +27,13 @@ typedef struct StucMapInternal {
 	V2_F32 zBounds;
 	char *pName;
 	char *pPath;
+	F64 timestamp;
+	//hash of this map's timestamp, and of its deps' dep tree hashes.
+	//0 if any map in the tree has no timestamp
+	U64 depTreeHash;
+	//coarser copies of the map, from finest to coarsest.
+	//Share the base map's name and idx attribs
+	struct StucMapInternal *pLods;
+	I32 lodCount;
+	F32 edgeLenAvg;
 } MapFile;
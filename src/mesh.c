@@ -647,6 +647,45 @@ bool checkForNgonsInMesh(const StucMesh *pMesh) {
 	return false;
 }
 
+I32 stucGetUniformFaceSize(const StucMesh *pMesh) {
+	if (!pMesh->faceCount) {
+		return 0;
+	}
+	I32 size = pMesh->pFaces[1] - pMesh->pFaces[0];
+	if (size != 3 && size != 4) {
+		return 0;
+	}
+	for (I32 i = 1; i < pMesh->faceCount; ++i) {
+		if (pMesh->pFaces[i + 1] - pMesh->pFaces[i] != size) {
+			return 0;
+		}
+	}
+	return size;
+}
+
+//avg len of the mesh's edges. Edges shared by 2 faces are counted twice.
+//If xyOnly, z is ignored (for meshes in uv space)
+F32 stucGetEdgeLenAvg(const StucMesh *pMesh, const V3_F32 *pPos, bool xyOnly) {
+	if (!pMesh->cornerCount) {
+		return .0f;
+	}
+	F64 sum = .0;
+	for (I32 i = 0; i < pMesh->faceCount; ++i) {
+		FaceRange face = stucGetFaceRange(pMesh, i);
+		for (I32 j = 0; j < face.size; ++j) {
+			I32 next = stucGetCornerNext(j, &face);
+			V3_F32 diff =
+				_(pPos[pMesh->pCorners[face.start + next]] V3SUB
+				pPos[pMesh->pCorners[face.start + j]]);
+			if (xyOnly) {
+				diff.d[2] = .0f;
+			}
+			sum += pixmV3F32Len(diff);
+		}
+	}
+	return (F32)(sum / pMesh->cornerCount);
+}
+
 bool stucQuickCmpMesh(StucContext pCtx, const StucMesh *pA, const StucMesh *pB) {
 	if (pA->vertCount != pB->vertCount ||
 		memcmp(
@@ -677,3 +716,349 @@ bool stucQuickCmpObj(StucContext pCtx, const StucObject *pA, const StucObject *p
 	const StucMesh *pBMesh = (StucMesh *)pB->pData;
 	return stucQuickCmpMesh(pCtx, pAMesh, pBMesh);
 }
+
+//topology derived sp attribs, which are kept by the in-mesh cache
+static const StucAttribUse inMeshCacheSpAttribs[] = {
+	STUC_ATTRIB_USE_SEAM_EDGE,
+	STUC_ATTRIB_USE_SEAM_VERT,
+	STUC_ATTRIB_USE_NUM_ADJ_PRESERVE,
+	STUC_ATTRIB_USE_EDGE_FACES,
+	STUC_ATTRIB_USE_EDGE_CORNERS
+};
+#define IN_MESH_CACHE_SP_ATTRIB_COUNT\
+	(sizeof(inMeshCacheSpAttribs) / sizeof(StucAttribUse))
+
+//attribs the cached tables are derived from, alongside topology
+static const StucAttribUse inMeshCacheKeyAttribs[IN_MESH_CACHE_KEY_ATTRIB_COUNT] = {
+	STUC_ATTRIB_USE_UV,
+	STUC_ATTRIB_USE_PRESERVE_EDGE,
+	STUC_ATTRIB_USE_PRESERVE_VERT
+};
+
+UBitField32 stucInMeshCacheSpAttribFlags() {
+	return stucAttribUseField(inMeshCacheSpAttribs, IN_MESH_CACHE_SP_ATTRIB_COUNT);
+}
+
+static
+void inMeshCacheEntryDestroy(StucContext pCtx, InMeshCacheEntry *pEntry) {
+	I32 *pArrs[] = {pEntry->pFaces, pEntry->pCorners, pEntry->pInEdges, pEntry->pEdges};
+	for (I32 i = 0; i < sizeof(pArrs) / sizeof(I32 *); ++i) {
+		if (pArrs[i]) {
+			pCtx->alloc.fpFree(pArrs[i]);
+		}
+	}
+	for (I32 i = 0; i < IN_MESH_CACHE_KEY_ATTRIB_COUNT; ++i) {
+		if (pEntry->pKeyAttribs[i]) {
+			pCtx->alloc.fpFree(pEntry->pKeyAttribs[i]);
+		}
+	}
+	for (I32 i = 0; i < STUC_ATTRIB_USE_SP_ENUM_COUNT; ++i) {
+		if (pEntry->pSpData[i]) {
+			pCtx->alloc.fpFree(pEntry->pSpData[i]);
+		}
+	}
+	pCtx->alloc.fpFree(pEntry);
+}
+
+//drops a ref, the entry is freed once the last is released
+static
+void inMeshCacheEntryUnref(StucContext pCtx, InMeshCacheEntry *pEntry) {
+	InMeshCache *pCache = pCtx->pInMeshCache;
+	pCtx->threadPool.fpMutexLock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	PIX_ERR_ASSERT("", pEntry->refs > 0);
+	bool destroy = !--pEntry->refs;
+	pCtx->threadPool.fpMutexUnlock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	if (destroy) {
+		inMeshCacheEntryDestroy(pCtx, pEntry);
+	}
+}
+
+void stucInMeshCacheInit(StucContext pCtx) {
+	PIX_ERR_ASSERT("", !pCtx->pInMeshCache);
+	pCtx->pInMeshCache = pCtx->alloc.fpCalloc(1, sizeof(InMeshCache));
+	pCtx->threadPool.fpMutexGet(pCtx->pThreadPoolHandle, &pCtx->pInMeshCache->pMutex);
+}
+
+void stucInMeshCacheDestroy(StucContext pCtx) {
+	InMeshCache *pCache = pCtx->pInMeshCache;
+	if (!pCache) {
+		return;
+	}
+	if (pCache->pEntry) {
+		PIX_ERR_ASSERT("cache destroyed while in use", pCache->pEntry->refs == 1);
+		inMeshCacheEntryDestroy(pCtx, pCache->pEntry);
+		pCache->pEntry = NULL;
+	}
+	pCtx->threadPool.fpMutexDestroy(pCtx->pThreadPoolHandle, pCache->pMutex);
+	pCtx->alloc.fpFree(pCache);
+	pCtx->pInMeshCache = NULL;
+}
+
+//fnv-1a, a word at a time. Start with STUC_HASH_SEED
+U64 stucHashData(U64 hash, const void *pData, I64 size) {
+	const U8 *pBytes = pData;
+	I64 wordCount = size / sizeof(U32);
+	for (I64 i = 0; i < wordCount; ++i) {
+		U32 word = 0;
+		memcpy(&word, pBytes + i * sizeof(U32), sizeof(U32));
+		hash = (hash ^ word) * 0x100000001b3ull;
+	}
+	for (I64 i = wordCount * sizeof(U32); i < size; ++i) {
+		hash = (hash ^ pBytes[i]) * 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static
+const void *getKeyAttrib(StucContext pCtx, const StucMesh *pMesh, I32 idx, I64 *pSize) {
+	StucAttribUse use = inMeshCacheKeyAttribs[idx];
+	const Attrib *pAttrib = stucGetActiveAttribConst(pCtx, pMesh, use);
+	if (!pAttrib || !pAttrib->core.pData) {
+		*pSize = 0;
+		return NULL;
+	}
+	StucDomain domain = pMesh->activeAttribs[use].domain;
+	*pSize = (I64)stucDomainCountGetIntern(pMesh, domain) *
+		stucGetAttribSizeIntern(pAttrib->core.type);
+	return pAttrib->core.pData;
+}
+
+//hashes everything the cached tables are derived from, topology, uvs (seams),
+//and preserve attribs
+U64 stucInMeshHash(StucContext pCtx, const StucMesh *pMesh) {
+	U64 hash = STUC_HASH_SEED;
+	I32 counts[] = {pMesh->faceCount, pMesh->cornerCount, pMesh->edgeCount, pMesh->vertCount};
+	hash = stucHashData(hash, counts, sizeof(counts));
+	hash = stucHashData(hash, pMesh->pFaces, sizeof(I32) * (pMesh->faceCount + 1));
+	hash = stucHashData(hash, pMesh->pCorners, sizeof(I32) * pMesh->cornerCount);
+	if (pMesh->pEdges) {
+		hash = stucHashData(hash, pMesh->pEdges, sizeof(I32) * pMesh->cornerCount);
+	}
+	for (I32 i = 0; i < IN_MESH_CACHE_KEY_ATTRIB_COUNT; ++i) {
+		I64 size = 0;
+		const void *pData = getKeyAttrib(pCtx, pMesh, i, &size);
+		if (!pData) {
+			hash = stucHashData(hash, &(I32){-1}, sizeof(I32));
+			continue;
+		}
+		hash = stucHashData(hash, pData, size);
+	}
+	return hash;
+}
+
+//a matching hash isn't enough to use the entry, the data it was built from is
+//compared in full
+static
+bool inMeshCacheEntryCmp(StucContext pCtx, const InMeshCacheEntry *pEntry, const StucMesh *pMesh) {
+	I32 counts[] = {pMesh->faceCount, pMesh->cornerCount, pMesh->edgeCount, pMesh->vertCount};
+	if (memcmp(pEntry->counts, counts, sizeof(counts)) ||
+		!pEntry->pInEdges != !pMesh->pEdges ||
+		memcmp(pEntry->pFaces, pMesh->pFaces, sizeof(I32) * (pMesh->faceCount + 1)) ||
+		memcmp(pEntry->pCorners, pMesh->pCorners, sizeof(I32) * pMesh->cornerCount)
+	) {
+		return false;
+	}
+	if (pMesh->pEdges &&
+		memcmp(pEntry->pInEdges, pMesh->pEdges, sizeof(I32) * pMesh->cornerCount)
+	) {
+		return false;
+	}
+	for (I32 i = 0; i < IN_MESH_CACHE_KEY_ATTRIB_COUNT; ++i) {
+		I64 size = 0;
+		const void *pData = getKeyAttrib(pCtx, pMesh, i, &size);
+		if (!pData != !pEntry->pKeyAttribs[i] ||
+			size != pEntry->keyAttribSizes[i] ||
+			(pData && memcmp(pData, pEntry->pKeyAttribs[i], size))
+		) {
+			return false;
+		}
+	}
+	return true;
+}
+
+InMeshCacheEntry *stucInMeshCacheAcquire(StucContext pCtx, U64 hash, const StucMesh *pMesh) {
+	InMeshCache *pCache = pCtx->pInMeshCache;
+	pCtx->threadPool.fpMutexLock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	InMeshCacheEntry *pEntry = pCache->pEntry;
+	if (pEntry && pEntry->hash == hash) {
+		pEntry->refs++;
+	}
+	else {
+		pEntry = NULL;
+	}
+	pCtx->threadPool.fpMutexUnlock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	//entries aren't modified once stored, so this is done outside the lock
+	if (pEntry && !inMeshCacheEntryCmp(pCtx, pEntry, pMesh)) {
+		inMeshCacheEntryUnref(pCtx, pEntry);
+		pEntry = NULL;
+	}
+	return pEntry;
+}
+
+//appends the cached sp attribs to the wrap, aliasing the cached buffers
+void stucInMeshCacheAppendSpAttribs(
+	StucContext pCtx,
+	Mesh *pMesh,
+	const InMeshCacheEntry *pEntry
+) {
+	for (I32 i = 0; i < IN_MESH_CACHE_SP_ATTRIB_COUNT; ++i) {
+		StucAttribUse use = inMeshCacheSpAttribs[i];
+		StucDomain domain = pCtx->spAttribDomains[use];
+		AttribArray *pArr = stucGetAttribArrFromDomain(&pMesh->core, domain);
+		PIX_ERR_ASSERT("", pArr && pEntry->pSpData[use]);
+		Attrib *pAttrib = NULL;
+		stucAppendAttrib(
+			&pCtx->alloc,
+			pArr,
+			&pAttrib,
+			pCtx->spAttribNames[use],
+			0,
+			false,
+			STUC_ATTRIB_ORIGIN_MESH_IN,
+			STUC_ATTRIB_DONT_COPY,
+			pCtx->spAttribTypes[use],
+			use
+		);
+		pAttrib->core.pData = pEntry->pSpData[use];
+		stucSetAttribIdxActive(&pMesh->core, pArr->count - 1, use, domain);
+	}
+}
+
+//detaches cached buffers from the mesh, so they aren't freed with it
+static
+void inMeshCacheDetach(StucContext pCtx, StucMesh *pMesh, bool builtEdges) {
+	if (builtEdges) {
+		pMesh->pEdges = NULL;
+	}
+	for (I32 i = 0; i < IN_MESH_CACHE_SP_ATTRIB_COUNT; ++i) {
+		Attrib *pAttrib = stucGetActiveAttrib(pCtx, pMesh, inMeshCacheSpAttribs[i]);
+		if (pAttrib) {
+			pAttrib->core.pData = NULL;
+		}
+	}
+}
+
+void stucInMeshCacheRelease(
+	StucContext pCtx,
+	InMeshCacheEntry *pEntry,
+	StucMesh *pMesh,
+	bool builtEdges
+) {
+	inMeshCacheDetach(pCtx, pMesh, builtEdges);
+	inMeshCacheEntryUnref(pCtx, pEntry);
+}
+
+static
+I32 *copyI32Arr(StucContext pCtx, const I32 *pSrc, I32 count) {
+	I32 *pDest = pCtx->alloc.fpMalloc(PIXM_MAX(count, 1) * sizeof(I32));
+	memcpy(pDest, pSrc, count * sizeof(I32));
+	return pDest;
+}
+
+//takes ownership of the mesh's derived tables, replacing the current entry.
+//pKeyMesh is the in-mesh the tables were built from. The previous entry is freed
+//once calls still using it release it
+void stucInMeshCacheStore(
+	StucContext pCtx,
+	U64 hash,
+	const StucMesh *pKeyMesh,
+	StucMesh *pMesh,
+	bool builtEdges
+) {
+	InMeshCache *pCache = pCtx->pInMeshCache;
+	InMeshCacheEntry *pEntry = pCtx->alloc.fpCalloc(1, sizeof(InMeshCacheEntry));
+	pEntry->hash = hash;
+	pEntry->refs = 1; //held by the cache
+	pEntry->counts[0] = pKeyMesh->faceCount;
+	pEntry->counts[1] = pKeyMesh->cornerCount;
+	pEntry->counts[2] = pKeyMesh->edgeCount;
+	pEntry->counts[3] = pKeyMesh->vertCount;
+	pEntry->pFaces = copyI32Arr(pCtx, pKeyMesh->pFaces, pKeyMesh->faceCount + 1);
+	pEntry->pCorners = copyI32Arr(pCtx, pKeyMesh->pCorners, pKeyMesh->cornerCount);
+	if (pKeyMesh->pEdges) {
+		pEntry->pInEdges = copyI32Arr(pCtx, pKeyMesh->pEdges, pKeyMesh->cornerCount);
+	}
+	for (I32 i = 0; i < IN_MESH_CACHE_KEY_ATTRIB_COUNT; ++i) {
+		I64 size = 0;
+		const void *pData = getKeyAttrib(pCtx, pKeyMesh, i, &size);
+		if (pData) {
+			pEntry->pKeyAttribs[i] = pCtx->alloc.fpMalloc(PIXM_MAX(size, 1));
+			memcpy(pEntry->pKeyAttribs[i], pData, size);
+			pEntry->keyAttribSizes[i] = size;
+		}
+	}
+	pEntry->edgeCount = pMesh->edgeCount;
+	pEntry->pEdges = builtEdges ? pMesh->pEdges : NULL;
+	for (I32 i = 0; i < IN_MESH_CACHE_SP_ATTRIB_COUNT; ++i) {
+		StucAttribUse use = inMeshCacheSpAttribs[i];
+		Attrib *pAttrib = stucGetActiveAttrib(pCtx, pMesh, use);
+		PIX_ERR_ASSERT("", pAttrib);
+		pEntry->pSpData[use] = pAttrib->core.pData;
+	}
+	inMeshCacheDetach(pCtx, pMesh, builtEdges);
+
+	pCtx->threadPool.fpMutexLock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	InMeshCacheEntry *pOld = pCache->pEntry;
+	pCache->pEntry = pEntry;
+	pCtx->threadPool.fpMutexUnlock(pCtx->pThreadPoolHandle, pCache->pMutex);
+	if (pOld) {
+		inMeshCacheEntryUnref(pCtx, pOld);
+	}
+}
+
+void stucMeshViewInit(
+	StucContext pCtx,
+	Mesh *pView,
+	const StucMesh *pSrc,
+	UBitField32 scratchAttribs,
+	StucAttribOrigin scratchOrigin
+) {
+	I32 scratchCounts[STUC_DOMAIN_MESH + 1] = {0};
+	for (I32 i = 1; i < STUC_ATTRIB_USE_SP_ENUM_COUNT; ++i) {
+		if (scratchAttribs >> i & 0x1) {
+			scratchCounts[pCtx->spAttribDomains[i]]++;
+		}
+	}
+	for (I32 i = STUC_DOMAIN_FACE; i <= STUC_DOMAIN_VERT; ++i) {
+		const AttribArray *pSrcArr = stucGetAttribArrFromDomainConst(pSrc, i);
+		AttribArray *pDestArr = stucGetAttribArrFromDomain(&pView->core, i);
+		*pDestArr = (AttribArray) {.size = pSrcArr->count + scratchCounts[i]};
+		if (!pDestArr->size) {
+			continue;
+		}
+		pDestArr->pArr = pCtx->alloc.fpMalloc(pDestArr->size * sizeof(Attrib));
+		if (pSrcArr->count) {
+			memcpy(pDestArr->pArr, pSrcArr->pArr, pSrcArr->count * sizeof(Attrib));
+			pDestArr->count = pSrcArr->count;
+		}
+	}
+	for (I32 i = 1; i < STUC_ATTRIB_USE_ENUM_COUNT; ++i) {
+		StucDomain domain = pSrc->activeAttribs[i].domain;
+		if (domain >= STUC_DOMAIN_FACE && domain <= STUC_DOMAIN_VERT) {
+			pView->core.activeAttribs[i] = pSrc->activeAttribs[i];
+		}
+	}
+	//arrays are already sized to fit these, so this won't realloc
+	stucAppendSpAttribsToMesh(pCtx, pView, scratchAttribs, scratchOrigin);
+}
+
+void stucMeshViewDestroy(StucContext pCtx, Mesh *pView, UBitField32 scratchAttribs) {
+	StucMesh *pCore = &pView->core;
+	for (I32 i = 1; i < STUC_ATTRIB_USE_SP_ENUM_COUNT; ++i) {
+		if (!(scratchAttribs >> i & 0x1)) {
+			continue;
+		}
+		Attrib *pAttrib = stucGetActiveAttrib(pCtx, pCore, i);
+		if (pAttrib && pAttrib->core.pData) {
+			pCtx->alloc.fpFree(pAttrib->core.pData);
+			pAttrib->core.pData = NULL;
+		}
+	}
+	for (I32 i = STUC_DOMAIN_FACE; i <= STUC_DOMAIN_VERT; ++i) {
+		AttribArray *pArr = stucGetAttribArrFromDomain(pCore, i);
+		if (pArr->pArr) {
+			pCtx->alloc.fpFree(pArr->pArr);
+		}
+		*pArr = (AttribArray) {0};
+	}
+}
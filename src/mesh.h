@@ -46,12 +46,47 @@ typedef struct Mesh {
 	Stuc_V2_I32 *pEdgeFaces;
 	Stuc_V2_I8 *pEdgeCorners;
 	Stuc_V3_F32 *pVertNormals;
+	//1 bit per face, NULL if all faces are in the region of interest
+	U8 *pRoiMask;
 	I32 faceBufSize;
 	I32 cornerBufSize;
 	I32 edgeBufSize;
 	I32 vertBufSize;
+	//3 or 4 if all faces are tris or quads, 0 otherwise.
+	//Used to dispatch to fixed size variants of hot funcs
+	I32 uniformFaceSize;
 } Mesh;
 
+static inline
+bool stucIsFaceInRoi(const Mesh *pMesh, I32 face) {
+	return !pMesh->pRoiMask || pMesh->pRoiMask[face >> 3] >> (face & 7) & 1;
+}
+
+#define IN_MESH_CACHE_KEY_ATTRIB_COUNT 3
+
+//derived in-mesh tables, shared by calls which map the same in-mesh.
+//Entries aren't modified once stored, and are freed once the last ref is dropped
+typedef struct InMeshCacheEntry {
+	//copy of the data the tables were derived from, compared in full on a hit
+	I32 counts[4];
+	I32 *pFaces;
+	I32 *pCorners;
+	I32 *pInEdges; //NULL if the in-mesh had no edge list
+	void *pKeyAttribs[IN_MESH_CACHE_KEY_ATTRIB_COUNT];
+	I64 keyAttribSizes[IN_MESH_CACHE_KEY_ATTRIB_COUNT];
+	U64 hash;
+	I32 refs;
+	I32 edgeCount;
+	I32 *pEdges; //NULL if the in-mesh had it's own edge list
+	void *pSpData[STUC_ATTRIB_USE_SP_ENUM_COUNT];
+} InMeshCacheEntry;
+
+//derived in-mesh tables kept between stucMapToMesh calls, see stucContextInMeshCacheSet
+typedef struct InMeshCache {
+	void *pMutex;
+	InMeshCacheEntry *pEntry;
+} InMeshCache;
+
 typedef struct MeshCounts {
 	I32 faces;
 	I32 corners;
@@ -190,5 +225,43 @@ V3_F32 stucGetUvPosAsV3(const Mesh *pMesh, const FaceRange *pFace, I32 corner) {
 I32 stucGetMeshVert(const StucMesh *pMesh, FaceCorner corner);
 I32 stucGetMeshEdge(const StucMesh *pMesh, FaceCorner corner);
 bool checkForNgonsInMesh(const StucMesh *pMesh);
+I32 stucGetUniformFaceSize(const StucMesh *pMesh);
+F32 stucGetEdgeLenAvg(const StucMesh *pMesh, const V3_F32 *pPos, bool xyOnly);
+//read-only view of a caller's mesh. Attrib headers are copied into arrays owned by
+//the view (data is aliased), with room reserved for internal scratch sp attribs,
+//so the caller's mesh is never written to or realloc'd
+void stucMeshViewInit(
+	StucContext pCtx,
+	Mesh *pView,
+	const StucMesh *pSrc,
+	UBitField32 scratchAttribs,
+	StucAttribOrigin scratchOrigin
+);
+void stucMeshViewDestroy(StucContext pCtx, Mesh *pView, UBitField32 scratchAttribs);
+#define STUC_HASH_SEED 0xcbf29ce484222325ull
+U64 stucHashData(U64 hash, const void *pData, I64 size);
+U64 stucInMeshHash(StucContext pCtx, const StucMesh *pMesh);
+void stucInMeshCacheInit(StucContext pCtx);
+void stucInMeshCacheDestroy(StucContext pCtx);
+UBitField32 stucInMeshCacheSpAttribFlags();
+InMeshCacheEntry *stucInMeshCacheAcquire(StucContext pCtx, U64 hash, const StucMesh *pMesh);
+void stucInMeshCacheAppendSpAttribs(
+	StucContext pCtx,
+	Mesh *pMesh,
+	const InMeshCacheEntry *pEntry
+);
+void stucInMeshCacheRelease(
+	StucContext pCtx,
+	InMeshCacheEntry *pEntry,
+	StucMesh *pMesh,
+	bool builtEdges
+);
+void stucInMeshCacheStore(
+	StucContext pCtx,
+	U64 hash,
+	const StucMesh *pKeyMesh,
+	StucMesh *pMesh,
+	bool builtEdges
+);
 bool stucQuickCmpMesh(StucContext pCtx, const StucMesh *pA, const StucMesh *pB);
 bool stucQuickCmpObj(StucContext pCtx, const StucObject *pA, const StucObject *pB);
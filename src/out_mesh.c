@@ -24,7 +24,8 @@ StucErr stucInitOutMesh(MapToMeshBasic *pBasic, PixuctHTable *pMergeTable, I32 s
 	pMesh->vertBufSize = pMesh->faceBufSize;
 	pMesh->core.pFaces = pAlloc->fpMalloc(sizeof(I32) * pMesh->faceBufSize);
 	pMesh->core.pCorners = pAlloc->fpMalloc(sizeof(I32) * pMesh->cornerBufSize);
-	//pMesh->core.pEdges = pAlloc->fpMalloc(sizeof(I32) * pMesh->edgeBufSize);
+	//pEdges is realloced alongside pCorners, so it's sized to match
+	pMesh->core.pEdges = pAlloc->fpMalloc(sizeof(I32) * pMesh->cornerBufSize);
 
 	//in-mesh is the active src,
 	// unmatched active map attribs will not be marked active
@@ -77,6 +78,7 @@ void stucAddVertsToOutMesh(
 
 typedef struct OutCornerBufCorner {
 	I32 mergedVert;
+	I32 outVert;
 	FaceCorner bufCorner;
 	bool intersect;
 } OutCornerBufCorner;
@@ -92,6 +94,99 @@ typedef struct OutCornerBuf {
 	OutCornerBufArr final;
 } OutCornerBuf;
 
+typedef struct OutEdgeKey {
+	I32 vertMin;
+	I32 vertMax;
+} OutEdgeKey;
+
+typedef struct OutEdge {
+	PixuctHTableEntryCore core;
+	OutEdgeKey key;
+	I32 edge;
+	bool forward;
+	bool paired;
+} OutEdge;
+
+static
+PixuctKey outEdgeMakeKey(const void *pKeyData) {
+	return (PixuctKey){.pKey = pKeyData, .size = sizeof(OutEdgeKey)};
+}
+
+static
+void outEdgeInit(
+	void *pUserData,
+	PixuctHTableEntryCore *pEntryCore,
+	const void *pKeyData,
+	void *pInitInfo,
+	I32 linIdx
+) {
+	OutEdge *pEntry = (OutEdge *)pEntryCore;
+	pEntry->key = *(const OutEdgeKey *)pKeyData;
+	pEntry->edge = -1;
+	pEntry->paired = false;
+}
+
+static
+bool outEdgeCmp(
+	const PixuctHTableEntryCore *pEntryCore,
+	const void *pKeyData,
+	const void *pInitInfo
+) {
+	const OutEdge *pEntry = (OutEdge *)pEntryCore;
+	const OutEdgeKey *pKey = pKeyData;
+	return
+		pEntry->key.vertMin == pKey->vertMin &&
+		pEntry->key.vertMax == pKey->vertMax;
+}
+
+void stucOutEdgeTableInit(MapToMeshBasic *pBasic, PixuctHTable *pEdgeTable) {
+	pixuctHTableInit(
+		&pBasic->pCtx->alloc,
+		pEdgeTable,
+		pBasic->outMesh.core.vertCount / 2 + 1,
+		(I32Arr) {.pArr = (I32[]) {sizeof(OutEdge)}, .count = 1},
+		NULL,
+		NULL,
+		true
+	);
+}
+
+//out-verts are already known from the merge table, so edges are found here with a
+//lookup on the vert pair, rather than with a separate adjacency pass.
+//As with stucBuildEdgeList, an edge is shared only by 2 corners of opposite winding
+static
+void setOutCornerEdge(
+	MapToMeshBasic *pBasic,
+	PixuctHTable *pEdgeTable,
+	I32 outCorner,
+	I32 vert,
+	I32 vertNext
+) {
+	OutEdgeKey key = {
+		.vertMin = vert < vertNext ? vert : vertNext,
+		.vertMax = vert < vertNext ? vertNext : vert
+	};
+	bool forward = vert < vertNext;
+	OutEdge *pEntry = NULL;
+	pixuctHTableGet(
+		pEdgeTable,
+		0,
+		&key,
+		(void **)&pEntry,
+		true, NULL,
+		outEdgeMakeKey, NULL, outEdgeInit, outEdgeCmp
+	);
+	if (pEntry->edge != -1 && !pEntry->paired && pEntry->forward != forward) {
+		pEntry->paired = true;
+	}
+	else {
+		pEntry->edge = stucMeshAddEdge(pBasic->pCtx, &pBasic->outMesh, NULL);
+		pEntry->forward = forward;
+		pEntry->paired = false;
+	}
+	pBasic->outMesh.core.pEdges[outCorner] = pEntry->edge;
+}
+
 static
 void addBufFaceToOutMesh(
 	MapToMeshBasic *pBasic,
@@ -101,6 +196,7 @@ void addBufFaceToOutMesh(
 	I32 bufMeshIdx,
 	bool clip,
 	PixuctHTable *pMergeTable,
+	PixuctHTable *pEdgeTable,
 	OutBufIdxArr *pOutBufIdxArr,
 	I32 faceIdx
 ) {
@@ -147,6 +243,7 @@ void addBufFaceToOutMesh(
 			key.type == STUC_BUF_VERT_SUB_TYPE_EDGE_IN;
 		OutCornerBufCorner *pBufEntry = pOutBuf->buf.pArr + pOutBuf->buf.count;
 		pBufEntry->mergedVert = pEntry->linIdx;
+		pBufEntry->outVert = pEntry->outVert;
 		pBufEntry->intersect = pEntry->key.type == STUC_BUF_VERT_INTERSECT;
 		pBufEntry->bufCorner = bufCorner;
 		pOutBuf->buf.count++;
@@ -189,6 +286,16 @@ void addBufFaceToOutMesh(
 			.mergedVert = pOutBuf->final.pArr[idx].mergedVert,
 		};
 		pBasic->outMesh.core.pCorners[outCorner] = newIdx;
+		I32 idxNext = reverseWind ?
+			(idx ? idx - 1 : pOutBuf->final.count - 1) :
+			(idx + 1) % pOutBuf->final.count;
+		setOutCornerEdge(
+			pBasic,
+			pEdgeTable,
+			outCorner,
+			pOutBuf->final.pArr[idx].outVert,
+			pOutBuf->final.pArr[idxNext].outVert
+		);
 	}
 }
 
@@ -196,6 +303,7 @@ void stucAddFacesAndCornersToOutMesh(
 	MapToMeshBasic *pBasic,
 	const InPieceArr *pInPieces,
 	PixuctHTable *pMergeTable,
+	PixuctHTable *pEdgeTable,
 	OutBufIdxArr *pOutBufIdxArr,
 	BufOutRangeTable *pBufOutTable,
 	bool clip
@@ -219,6 +327,7 @@ void stucAddFacesAndCornersToOutMesh(
 				i,
 				clip,
 				pMergeTable,
+				pEdgeTable,
 				pOutBufIdxArr,
 				j
 			);
@@ -1061,6 +1061,101 @@ StucErr initRootAndChildren(
 	return PIX_ERR_SUCCESS;
 }
 
+static
+void occupancyGetCellRange(BBox bbox, V2_I32 *pMin, V2_I32 *pMax) {
+	//padded by a cell either side to stay conservative at cell boundaries
+	for (I32 i = 0; i < 2; ++i) {
+		I32 min = (I32)floorf(bbox.min.d[i] * STUC_OCCUPANCY_RES) - 1;
+		I32 max = (I32)floorf(bbox.max.d[i] * STUC_OCCUPANCY_RES) + 1;
+		pMin->d[i] = PIXM_MAX(min, 0);
+		pMax->d[i] = PIXM_MIN(max, STUC_OCCUPANCY_RES - 1);
+	}
+}
+
+static
+U64 occupancyWordMask(I32 word, I32 min, I32 max) {
+	I32 wordStart = word * 64;
+	I32 lo = PIXM_MAX(min - wordStart, 0);
+	I32 hi = PIXM_MIN(max - wordStart, 63);
+	if (lo > hi) {
+		return 0;
+	}
+	U64 hiMask = hi == 63 ? ~0ull : (0x1ull << (hi + 1)) - 1;
+	return hiMask & ~((0x1ull << lo) - 1);
+}
+
+static
+void occupancyMark(U64 *pOccupancy, BBox bbox) {
+	if (bbox.max.d[0] < .0f || bbox.max.d[1] < .0f ||
+	    bbox.min.d[0] > 1.0f || bbox.min.d[1] > 1.0f
+	) {
+		return;
+	}
+	V2_I32 min = {0};
+	V2_I32 max = {0};
+	occupancyGetCellRange(bbox, &min, &max);
+	for (I32 y = min.d[1]; y <= max.d[1]; ++y) {
+		U64 *pRow = pOccupancy + y * STUC_OCCUPANCY_WORDS;
+		for (I32 i = 0; i < STUC_OCCUPANCY_WORDS; ++i) {
+			pRow[i] |= occupancyWordMask(i, min.d[0], max.d[0]);
+		}
+	}
+}
+
+static
+bool occupancyTest(const U64 *pOccupancy, BBox bbox) {
+	V2_I32 min = {0};
+	V2_I32 max = {0};
+	occupancyGetCellRange(bbox, &min, &max);
+	for (I32 y = min.d[1]; y <= max.d[1]; ++y) {
+		const U64 *pRow = pOccupancy + y * STUC_OCCUPANCY_WORDS;
+		for (I32 i = 0; i < STUC_OCCUPANCY_WORDS; ++i) {
+			if (pRow[i] & occupancyWordMask(i, min.d[0], max.d[0])) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static
+void buildOccupancy(
+	StucContext pCtx,
+	QuadTree *pTree,
+	const Mesh *pMesh,
+	const BBox *pFaceBBoxes
+) {
+	pTree->pOccupancy = pCtx->alloc.fpCalloc(
+		STUC_OCCUPANCY_RES * STUC_OCCUPANCY_WORDS,
+		sizeof(U64)
+	);
+	for (I32 i = 0; i < pMesh->core.faceCount; ++i) {
+		occupancyMark(pTree->pOccupancy, pFaceBBoxes[i]);
+	}
+}
+
+//tests the in-face bounds against the occupancy bitmap in each tile it spans.
+//Returns false only if the face is definitely over empty map regions
+static
+bool isInFaceOverOccupiedRegion(const QuadTree *pTree, const FaceBounds *pFaceBounds) {
+	if (!pTree->pOccupancy) {
+		return true;
+	}
+	for (I32 y = pFaceBounds->min.d[1]; y <= pFaceBounds->max.d[1]; ++y) {
+		for (I32 x = pFaceBounds->min.d[0]; x <= pFaceBounds->max.d[0]; ++x) {
+			V2_F32 fTile = {.d = {(F32)x, (F32)y}};
+			BBox local = {
+				.min = _(pFaceBounds->fBBoxSmall.min V2SUB fTile),
+				.max = _(pFaceBounds->fBBoxSmall.max V2SUB fTile)
+			};
+			if (occupancyTest(pTree->pOccupancy, local)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 StucErr stucCreateQuadTree(
 	StucContext pCtx,
 	QuadTree *pTree,
@@ -1103,6 +1198,7 @@ StucErr stucCreateQuadTree(
 	printf("Created quadTree -- cells: %d, leaves: %d\n",
 	       pTree->cellCount, pTree->leafCount);
 	reallocCellTable(pCtx, pTree, sizeDecrease);
+	buildOccupancy(pCtx, pTree, pMesh, pFaceBBoxes);
 	stucStageEndWrap(pCtx);
 	PIX_ERR_CATCH(0, err, ;)
 	pCtx->alloc.fpFree(pFaceFlag);
@@ -1126,6 +1222,10 @@ void stucDestroyQuadTree(StucContext pCtx, QuadTree *pTree) {
 		}
 	}
 	pCtx->alloc.fpFree(pTree->cellTable.pArr);
+	if (pTree->pOccupancy) {
+		pCtx->alloc.fpFree(pTree->pOccupancy);
+		pTree->pOccupancy = NULL;
+	}
 }
 
 void stucGetFaceBoundsForTileTest(
@@ -1161,12 +1261,18 @@ StucErr stucGetEncasingCells(
 		    pInMesh->pMatIdx[i] != maskIdx) {
 			continue;
 		}
+		if (!stucIsFaceInRoi(pInMesh, i)) {
+			continue;
+		}
 		FaceRange faceInfo = stucGetFaceRange(&pInMesh->core, i);
 		if (faceInfo.size > 4) {
 			continue;
 		}
 		FaceBounds faceBounds = {0};
 		stucGetFaceBoundsForTileTest(&faceBounds, pInMesh, &faceInfo);
+		if (!isInFaceOverOccupiedRegion(&pMap->quadTree, &faceBounds)) {
+			continue;
+		}
 		V2_F32 *pVertBuf = pAlloc->fpMalloc(sizeof(V2_F32) * faceInfo.size);
 		for (I32 j = 0; j < faceInfo.size; ++j) {
 			pVertBuf[j] = pInMesh->pUvs[faceInfo.start + j];
@@ -11,6 +11,10 @@ SPDX-License-Identifier: Apache-2.0
 #include <types.h>
 
 #define CELL_MAX_VERTS 32
+//coarse bitmap of which regions of the 0-1 tile contain map faces.
+//In-faces over empty regions are skipped without walking the tree
+#define STUC_OCCUPANCY_RES 256
+#define STUC_OCCUPANCY_WORDS (STUC_OCCUPANCY_RES / 64)
 
 typedef struct Cell {
 	struct Cell *pChildren;
@@ -41,6 +45,7 @@ typedef struct {
 	I32 edgeFaceSize;
 	I32 cellCount;
 	I32 leafCount;
+	U64 *pOccupancy;
 } QuadTree;
 
 typedef struct {
@@ -3,6 +3,8 @@ SPDX-FileCopyrightText: 2025 Caleb Dawson
 SPDX-License-Identifier: Apache-2.0
 */
 
+#include <string.h>
+
 #include <mikktspace.h>
 
 #include <uv_stucco_intern.h>
@@ -60,10 +62,17 @@ typedef struct TangentJobArgs {
 	F32 *pTSigns;
 } TangentJobArgs;
 
-typedef struct TangentTris {
-	StucContext pCtx;
+typedef struct TangentTrisJobArgs {
+	JobArgs core;
 	Mesh *pMesh;
-} TangentTris;
+	I32Arr faces;
+} TangentTrisJobArgs;
+
+typedef struct TrisPosEntry {
+	PixuctHTableEntryCore core;
+	V3_F32 pos;
+	I32 face;
+} TrisPosEntry;
 
 
 static
@@ -433,8 +442,13 @@ int mikktGetNumFaces(const SMikkTSpaceContext *pCtx) {
 
 static
 int mikktTrisGetNumFaces(const SMikkTSpaceContext *pCtx) {
-	TangentTris *pState = pCtx->m_pUserData;
-	return pState->pMesh->core.faceCount;
+	TangentTrisJobArgs *pArgs = pCtx->m_pUserData;
+	return pArgs->faces.count;
+}
+
+static
+I32 mikktTrisGetCorner(const TangentTrisJobArgs *pArgs, I32 iFace, I32 iVert) {
+	return pArgs->faces.pArr[iFace] * 3 + iVert;
 }
 
 static
@@ -481,9 +495,9 @@ void mikktTrisGetPos(
 	const int iFace,
 	const int iVert
 ) {
-	TangentTris *pState = pCtx->m_pUserData;
-	I32 vertIdx = pState->pMesh->core.pCorners[iFace * 3 + iVert];
-	*(V3_F32 *)pFvPosOut = pState->pMesh->pPos[vertIdx];
+	TangentTrisJobArgs *pArgs = pCtx->m_pUserData;
+	I32 vertIdx = pArgs->pMesh->core.pCorners[mikktTrisGetCorner(pArgs, iFace, iVert)];
+	*(V3_F32 *)pFvPosOut = pArgs->pMesh->pPos[vertIdx];
 }
 
 static
@@ -507,9 +521,9 @@ void mikktTrisGetNormal(
 	const int iFace,
 	const int iVert
 ) {
-	TangentTris *pState = pCtx->m_pUserData;
-	I32 corner = iFace * 3 + iVert;
-	*(V3_F32 *)pFvNormOut = pState->pMesh->pNormals[corner];
+	TangentTrisJobArgs *pArgs = pCtx->m_pUserData;
+	I32 corner = mikktTrisGetCorner(pArgs, iFace, iVert);
+	*(V3_F32 *)pFvNormOut = pArgs->pMesh->pNormals[corner];
 }
 
 static
@@ -533,9 +547,9 @@ void mikktTrisGetTexCoord(
 	const int iFace,
 	const int iVert
 ) {
-	TangentTris *pState = pCtx->m_pUserData;
-	I32 corner = iFace * 3 + iVert;
-	*(V2_F32 *)pFvTexcOut = pState->pMesh->pUvs[corner];
+	TangentTrisJobArgs *pArgs = pCtx->m_pUserData;
+	I32 corner = mikktTrisGetCorner(pArgs, iFace, iVert);
+	*(V2_F32 *)pFvTexcOut = pArgs->pMesh->pUvs[corner];
 }
 
 static
@@ -560,10 +574,10 @@ void mikktTrisSetTSpaceBasic(
 	const int iFace,
 	const int iVert
 ) {
-	TangentTris *pState = pCtx->m_pUserData;
-	I32 corner = iFace * 3 + iVert;
-	pState->pMesh->pTangents[corner] = *(V3_F32 *)pFvTangent;
-	pState->pMesh->pTSigns[corner] = fSign;
+	TangentTrisJobArgs *pArgs = pCtx->m_pUserData;
+	I32 corner = mikktTrisGetCorner(pArgs, iFace, iVert);
+	pArgs->pMesh->pTangents[corner] = *(V3_F32 *)pFvTangent;
+	pArgs->pMesh->pTSigns[corner] = fSign;
 }
 
 static
@@ -599,7 +613,8 @@ StucErr stucBuildTangents(void *pArgsVoid) {
 	return err;
 }
 
-StucErr stucBuildTangentsForTris(StucContext pCtx, Mesh *pMesh) {
+static
+StucErr buildTangentsForTrisJob(void *pArgsVoid) {
 	StucErr err = PIX_ERR_SUCCESS;
 	SMikkTSpaceInterface mikktInterface = {
 		.m_getNumFaces = mikktTrisGetNumFaces,
@@ -609,13 +624,169 @@ StucErr stucBuildTangentsForTris(StucContext pCtx, Mesh *pMesh) {
 		.m_getTexCoord = mikktTrisGetTexCoord,
 		.m_setTSpaceBasic = mikktTrisSetTSpaceBasic
 	};
-	TangentTris state = {.pCtx = pCtx, .pMesh = pMesh};
+	TangentTrisJobArgs *pArgs = pArgsVoid;
 	SMikkTSpaceContext mikktCtx = {
 		.m_pInterface = &mikktInterface,
-		.m_pUserData = &state,
-		.alloc = pCtx->alloc
+		.m_pUserData = pArgs,
+		.alloc = pArgs->core.pCtx->alloc
 	};
-	err = stucBuildTangentsIntern(pCtx, &mikktCtx);
+	err = stucBuildTangentsIntern(pArgs->core.pCtx, &mikktCtx);
 	PIX_ERR_RETURN_IFNOT(err, "");
 	return err;
 }
+
+static
+PixuctKey trisPosMakeKey(const void *pKeyData) {
+	return (PixuctKey){.pKey = pKeyData, .size = sizeof(V3_F32)};
+}
+
+static
+void trisPosInit(
+	void *pUserData,
+	PixuctHTableEntryCore *pEntryCore,
+	const void *pKeyData,
+	void *pInitInfo,
+	I32 linIdx
+) {
+	TrisPosEntry *pEntry = (TrisPosEntry *)pEntryCore;
+	pEntry->pos = *(const V3_F32 *)pKeyData;
+	pEntry->face = *(I32 *)pInitInfo;
+}
+
+static
+bool trisPosCmp(
+	const PixuctHTableEntryCore *pEntryCore,
+	const void *pKeyData,
+	const void *pInitInfo
+) {
+	const TrisPosEntry *pEntry = (TrisPosEntry *)pEntryCore;
+	return !memcmp(&pEntry->pos, pKeyData, sizeof(V3_F32));
+}
+
+static
+I32 triIslandFind(I32 *pParent, I32 face) {
+	while (pParent[face] != face) {
+		pParent[face] = pParent[pParent[face]];
+		face = pParent[face];
+	}
+	return face;
+}
+
+static
+void triIslandUnion(I32 *pParent, I32 a, I32 b) {
+	a = triIslandFind(pParent, a);
+	b = triIslandFind(pParent, b);
+	//the lower idx is kept as root, so each island's root is it's first face
+	if (a < b) {
+		pParent[b] = a;
+	}
+	else if (b < a) {
+		pParent[a] = b;
+	}
+}
+
+//mikktspace only welds corners with equal positions, so tris which share no
+//positions can't affect each other's tangents. Islands are built from position
+//rather than vert idx, as split verts may share a position
+static
+void buildTriIslands(StucContext pCtx, const Mesh *pMesh, I32 *pParent) {
+	const StucMesh *pCore = &pMesh->core;
+	PixuctHTable posTable = {0};
+	pixuctHTableInit(
+		&pCtx->alloc,
+		&posTable,
+		pCore->cornerCount / 2 + 1,
+		(I32Arr) {.pArr = (I32[]) {sizeof(TrisPosEntry)}, .count = 1},
+		NULL,
+		NULL,
+		true
+	);
+	for (I32 i = 0; i < pCore->faceCount; ++i) {
+		pParent[i] = i;
+	}
+	for (I32 i = 0; i < pCore->faceCount; ++i) {
+		for (I32 j = 0; j < 3; ++j) {
+			V3_F32 pos = pMesh->pPos[pCore->pCorners[i * 3 + j]];
+			//so -0 & 0 are treated as equal, as they are by mikktspace
+			for (I32 k = 0; k < 3; ++k) {
+				pos.d[k] += .0f;
+			}
+			TrisPosEntry *pEntry = NULL;
+			SearchResult result = pixuctHTableGet(
+				&posTable,
+				0,
+				&pos,
+				(void **)&pEntry,
+				true, &i,
+				trisPosMakeKey, NULL, trisPosInit, trisPosCmp
+			);
+			if (result == PIX_SEARCH_FOUND) {
+				triIslandUnion(pParent, pEntry->face, i);
+			}
+		}
+	}
+	pixuctHTableDestroy(&posTable);
+}
+
+StucErr stucBuildTangentsForTris(StucContext pCtx, Mesh *pMesh) {
+	StucErr err = PIX_ERR_SUCCESS;
+	I32 faceCount = pMesh->core.faceCount;
+	if (!faceCount) {
+		return err;
+	}
+	I32 *pParent = pCtx->alloc.fpMalloc(faceCount * sizeof(I32));
+	buildTriIslands(pCtx, pMesh, pParent);
+	I32 *pIslandSize = pCtx->alloc.fpCalloc(faceCount, sizeof(I32));
+	for (I32 i = 0; i < faceCount; ++i) {
+		++pIslandSize[triIslandFind(pParent, i)];
+	}
+	//islands are assigned to jobs in order of their first face,
+	//with each job taking roughly an even share of faces.
+	//pIslandSize is reused to store each island's job
+	I32 facesPerJob = faceCount / PIX_THREAD_MAX_SUB_MAPPING_JOBS + 1;
+	I32 job = 0;
+	I32 jobFaceCount = 0;
+	for (I32 i = 0; i < faceCount; ++i) {
+		if (pParent[i] != i) {
+			continue;
+		}
+		if (jobFaceCount >= facesPerJob && job < PIX_THREAD_MAX_SUB_MAPPING_JOBS - 1) {
+			++job;
+			jobFaceCount = 0;
+		}
+		jobFaceCount += pIslandSize[i];
+		pIslandSize[i] = job;
+	}
+	I32 jobCount = job + 1;
+	TangentTrisJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+	//faces are added in ascending order, so each island keeps it's face order
+	for (I32 i = 0; i < faceCount; ++i) {
+		TangentTrisJobArgs *pArgs = jobArgs + pIslandSize[triIslandFind(pParent, i)];
+		I32 idx = -1;
+		PIXALC_DYN_ARR_ADD(I32, &pCtx->alloc, (&pArgs->faces), idx);
+		PIX_ERR_ASSERT("", idx != -1);
+		pArgs->faces.pArr[idx] = i;
+	}
+	pCtx->alloc.fpFree(pParent);
+	pCtx->alloc.fpFree(pIslandSize);
+	for (I32 i = 0; i < jobCount; ++i) {
+		jobArgs[i].core = (JobArgs) {
+			.pShared = pMesh,
+			.pCtx = pCtx,
+			.range = {.start = 0, .end = jobArgs[i].faces.count},
+			.id = i
+		};
+		jobArgs[i].pMesh = pMesh;
+	}
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, jobArgs, sizeof(TangentTrisJobArgs),
+		buildTangentsForTrisJob
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	PIX_ERR_CATCH(0, err, ;);
+	for (I32 i = 0; i < jobCount; ++i) {
+		pCtx->alloc.fpFree(jobArgs[i].faces.pArr);
+	}
+	return err;
+}
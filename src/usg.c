@@ -3,6 +3,7 @@ SPDX-FileCopyrightText: 2025 Caleb Dawson
 SPDX-License-Identifier: Apache-2.0
 */
 
+#include <stdlib.h>
 #include <float.h>
 #include <string.h>
 #include <math.h>
@@ -15,52 +16,41 @@ SPDX-License-Identifier: Apache-2.0
 #include <utils.h>
 
 
+//with a bvh, only a handful of tris are hit per query,
+//so hit edges are kept in a small arr rather than a table sized to the mesh
 typedef struct HitEdge {
-	struct HitEdge *pNext;
-	I32 verts[2];
-	bool valid;
+	I32 verts[2]; //verts[1] is -1 if a vert was hit, rather than an edge
 } HitEdge;
 
-typedef struct HitEdgeTable {
-	HitEdge *pTable;
+typedef struct HitEdgeArr {
+	HitEdge *pArr;
 	I32 size;
-} HitEdgeTable;
-
-static
-void initHitEdgeEntry(HitEdge *pEntry, I32 a, I32 b) {
-	pEntry->verts[0] = a;
-	pEntry->verts[1] = b;
-	pEntry->valid = true;
-}
+	I32 count;
+} HitEdgeArr;
 
 static
 bool addToHitEdges(
 	const StucAlloc *pAlloc,
-	HitEdgeTable *pHitEdges,
-	I32 *pVerts,
+	HitEdgeArr *pHitEdges,
+	const I32 *pVerts,
 	I32 a, I32 b
 ) {
-	U32 sum = b < 0 ? a : a + b;
-	I32 hash = stucFnvHash((U8 *)&sum, sizeof(sum), pHitEdges->size);
-	HitEdge *pEntry = pHitEdges->pTable + hash;
-	if (!pEntry->valid) {
-		initHitEdgeEntry(pEntry, a, b);
-		return true;
-	}
 	I32 verta = pVerts[a];
 	I32 vertb = b < 0 ? -1 : pVerts[b];
-	do {
-		if (pEntry->verts[0] == verta || pEntry->verts[0] == vertb ||
-			pEntry->verts[1] == verta || pEntry->verts[1] == vertb) {
+	if (vertb >= 0 && vertb < verta) {
+		I32 buf = verta;
+		verta = vertb;
+		vertb = buf;
+	}
+	for (I32 i = 0; i < pHitEdges->count; ++i) {
+		if (pHitEdges->pArr[i].verts[0] == verta && pHitEdges->pArr[i].verts[1] == vertb) {
 			return false;
 		}
-		if (!pEntry->pNext) {
-			pEntry = pEntry->pNext = pAlloc->fpCalloc(1, sizeof(HitEdge));
-			initHitEdgeEntry(pEntry, a, b);
-			return true;
-		}
-		pEntry = pEntry->pNext;
-	} while(pEntry);
+	}
+	I32 newIdx = -1;
+	PIXALC_DYN_ARR_ADD(HitEdge, pAlloc, pHitEdges, newIdx);
+	PIX_ERR_ASSERT("", newIdx >= 0);
+	pHitEdges->pArr[newIdx] = (HitEdge){.verts = {verta, vertb}};
 	return true;
 }
 
@@ -70,9 +60,8 @@ bool hitTestTri(
 	V3_F32 point,
 	V3_F32 *pTri,
 	I32 *pVerts,
-	HitEdgeTable *pHitEdges
+	HitEdgeArr *pHitEdges
 ) {
-	//add bounding squares to speed up tests maybe?
 	V3_F32 bc = pixmCartesianToBarycentric(
 		pTri,
 		&point,
@@ -121,63 +110,202 @@ bool hitTestTri(
 	return addToHitEdges(pAlloc, pHitEdges, pVerts, verts[0], verts[1]);
 }
 
+typedef struct BvhBuildTri {
+	I32 verts[3];
+	BBox bbox;
+	V2_F32 centroid;
+} BvhBuildTri;
+
 static
-void getTri(
-	V3_F32 *pTri,
-	I32 *pVerts,
-	Mesh *pMesh,
-	FaceRange *pFace,
+void bvhBuildTriAdd(
+	BvhBuildTri *pTris,
+	I32 *pCount,
+	const Mesh *pMesh,
+	const FaceRange *pFace,
 	I32 a, I32 b, I32 c
 ) {
-	pVerts[0] = pMesh->core.pCorners[pFace->start + a];
-	pVerts[1] = pMesh->core.pCorners[pFace->start + b];
-	pVerts[2] = pMesh->core.pCorners[pFace->start + c];
-	pTri[0] = pMesh->pPos[pVerts[0]];
-	pTri[1] = pMesh->pPos[pVerts[1]];
-	pTri[2] = pMesh->pPos[pVerts[2]];
+	BvhBuildTri *pTri = pTris + *pCount;
+	pTri->verts[0] = pMesh->core.pCorners[pFace->start + a];
+	pTri->verts[1] = pMesh->core.pCorners[pFace->start + b];
+	pTri->verts[2] = pMesh->core.pCorners[pFace->start + c];
+	pTri->bbox.min = (V2_F32){FLT_MAX, FLT_MAX};
+	pTri->bbox.max = (V2_F32){-FLT_MAX, -FLT_MAX};
+	for (I32 i = 0; i < 3; ++i) {
+		V3_F32 pos = pMesh->pPos[pTri->verts[i]];
+		for (I32 j = 0; j < 2; ++j) {
+			pTri->bbox.min.d[j] = PIXM_MIN(pTri->bbox.min.d[j], pos.d[j]);
+			pTri->bbox.max.d[j] = PIXM_MAX(pTri->bbox.max.d[j], pos.d[j]);
+		}
+	}
+	pTri->centroid = (V2_F32){
+		(pTri->bbox.min.d[0] + pTri->bbox.max.d[0]) * .5f,
+		(pTri->bbox.min.d[1] + pTri->bbox.max.d[1]) * .5f
+	};
+	++*pCount;
+}
 
+static
+I32 bvhCmpTriX(const void *pA, const void *pB) {
+	F32 a = ((const BvhBuildTri *)pA)->centroid.d[0];
+	F32 b = ((const BvhBuildTri *)pB)->centroid.d[0];
+	return (a > b) - (a < b);
 }
 
-bool stucIsPointInsideMesh(const StucAlloc *pAlloc, V3_F32 pointV3, Mesh *pMesh) {
-	//winding number test, with ray aligned with z axis
-	//(so flatten point and mesh into 2D (x,y))
-	I32 wind = 0;
-	HitEdgeTable hitEdges = {0};
-	hitEdges.size = pMesh->core.edgeCount;
-	hitEdges.pTable = pAlloc->fpCalloc(hitEdges.size, sizeof(HitEdge));
-	U8 triBuf[STUC_NGON_MAX_SIZE];
+static
+I32 bvhCmpTriY(const void *pA, const void *pB) {
+	F32 a = ((const BvhBuildTri *)pA)->centroid.d[1];
+	F32 b = ((const BvhBuildTri *)pB)->centroid.d[1];
+	return (a > b) - (a < b);
+}
+
+static
+void bvhBuildNode(UsgBvh *pBvh, BvhBuildTri *pTris, I32 nodeIdx, I32 start, I32 count) {
+	UsgBvhNode *pNode = pBvh->pNodes + nodeIdx;
+	pNode->bbox.min = (V2_F32){FLT_MAX, FLT_MAX};
+	pNode->bbox.max = (V2_F32){-FLT_MAX, -FLT_MAX};
+	for (I32 i = start; i < start + count; ++i) {
+		for (I32 j = 0; j < 2; ++j) {
+			pNode->bbox.min.d[j] = PIXM_MIN(pNode->bbox.min.d[j], pTris[i].bbox.min.d[j]);
+			pNode->bbox.max.d[j] = PIXM_MAX(pNode->bbox.max.d[j], pTris[i].bbox.max.d[j]);
+		}
+	}
+	if (count <= STUC_USG_BVH_LEAF_SIZE) {
+		pNode->start = start;
+		pNode->count = count;
+		return;
+	}
+	//median split along the longest axis
+	V2_F32 extent = _(pNode->bbox.max V2SUB pNode->bbox.min);
+	qsort(
+		pTris + start,
+		count,
+		sizeof(BvhBuildTri),
+		extent.d[0] >= extent.d[1] ? bvhCmpTriX : bvhCmpTriY
+	);
+	I32 half = count / 2;
+	I32 children = pBvh->nodeCount;
+	pBvh->nodeCount += 2;
+	pNode->start = children;
+	pNode->count = 0;
+	bvhBuildNode(pBvh, pTris, children, start, half);
+	bvhBuildNode(pBvh, pTris, children + 1, start + half, count - half);
+}
+
+StucErr stucUsgBvhBuild(const StucAlloc *pAlloc, UsgBvh *pBvh, const Mesh *pMesh) {
+	StucErr err = PIX_ERR_SUCCESS;
+	*pBvh = (UsgBvh){0};
+	I32 triCount = 0;
+	for (I32 i = 0; i < pMesh->core.faceCount; ++i) {
+		FaceRange face = stucGetFaceRange(&pMesh->core, i);
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			face.size >= 3 && face.size <= STUC_NGON_MAX_SIZE,
+			"invalid face size"
+		);
+		triCount += face.size - 2;
+	}
+	if (!triCount) {
+		return err;
+	}
+	BvhBuildTri *pTris = pAlloc->fpMalloc(triCount * sizeof(BvhBuildTri));
+	I32 count = 0;
+	U8 triBuf[(STUC_NGON_MAX_SIZE - 2) * 3];
 	for (I32 i = 0; i < pMesh->core.faceCount; ++i) {
 		FaceRange face = stucGetFaceRange(&pMesh->core, i);
-		V3_F32 tri[3] = {0};
-		I32 triVerts[3] = {0};
 		if (face.size == 3) {
-			getTri(tri, triVerts, pMesh, &face, 0, 1, 2);
-			wind += hitTestTri(pAlloc, pointV3, tri, triVerts, &hitEdges);
+			bvhBuildTriAdd(pTris, &count, pMesh, &face, 0, 1, 2);
 		}
 		else if (face.size == 4) {
-			getTri(tri, triVerts, pMesh, &face, 0, 1, 2);
-			wind += hitTestTri(pAlloc, pointV3, tri, triVerts, &hitEdges);
-			getTri(tri, triVerts, pMesh, &face, 2, 3, 0);
-			wind += hitTestTri(pAlloc, pointV3, tri, triVerts, &hitEdges);
+			bvhBuildTriAdd(pTris, &count, pMesh, &face, 0, 1, 2);
+			bvhBuildTriAdd(pTris, &count, pMesh, &face, 2, 3, 0);
 		}
 		else {
-			PIX_ERR_ASSERT("invalid face size", face.size <= STUC_NGON_MAX_SIZE);
-			I32 triCount = stucTriangulateFaceFromVerts(pAlloc, &face, pMesh, triBuf);
-			for (I32 j = 0; j < triCount; ++j) {
+			I32 faceTriCount = stucTriangulateFaceFromVerts(pAlloc, &face, pMesh, triBuf);
+			for (I32 j = 0; j < faceTriCount; ++j) {
 				I32 triStart = j * 3;
-				getTri(
-					tri,
-					triVerts,
+				bvhBuildTriAdd(
+					pTris,
+					&count,
 					pMesh,
 					&face,
 					triBuf[triStart],
 					triBuf[triStart + 1],
 					triBuf[triStart + 2]
 				);
-				wind += hitTestTri(pAlloc, pointV3, tri, triVerts, &hitEdges);
 			}
 		}
 	}
+	PIX_ERR_ASSERT("", count <= triCount);
+	pBvh->pNodes = pAlloc->fpMalloc(count * 2 * sizeof(UsgBvhNode));
+	pBvh->nodeCount = 1;
+	bvhBuildNode(pBvh, pTris, 0, 0, count);
+	pBvh->triCount = count;
+	pBvh->pTris = pAlloc->fpMalloc(count * 3 * sizeof(I32));
+	for (I32 i = 0; i < count; ++i) {
+		memcpy(pBvh->pTris + i * 3, pTris[i].verts, sizeof(pTris[i].verts));
+	}
+	pAlloc->fpFree(pTris);
+	return err;
+}
+
+void stucUsgBvhDestroy(const StucAlloc *pAlloc, UsgBvh *pBvh) {
+	if (pBvh->pNodes) {
+		pAlloc->fpFree(pBvh->pNodes);
+	}
+	if (pBvh->pTris) {
+		pAlloc->fpFree(pBvh->pTris);
+	}
+	*pBvh = (UsgBvh){0};
+}
+
+static
+bool isPointInBvhNode(const UsgBvhNode *pNode, V3_F32 point) {
+	return
+		point.d[0] >= pNode->bbox.min.d[0] && point.d[0] <= pNode->bbox.max.d[0] &&
+		point.d[1] >= pNode->bbox.min.d[1] && point.d[1] <= pNode->bbox.max.d[1];
+}
+
+bool stucIsPointInsideMesh(
+	const StucAlloc *pAlloc,
+	V3_F32 pointV3,
+	const Mesh *pMesh,
+	const UsgBvh *pBvh
+) {
+	//winding number test, with ray aligned with z axis
+	//(so flatten point and mesh into 2D (x,y)).
+	//Only tris in bvh leaves overlapping the point in x & y are tested
+	if (!pMesh || !pBvh->nodeCount) {
+		return false;
+	}
+	I32 wind = 0;
+	HitEdgeArr hitEdges = {0};
+	I32 stack[STUC_USG_BVH_MAX_DEPTH] = {0};
+	I32 stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize) {
+		const UsgBvhNode *pNode = pBvh->pNodes + stack[--stackSize];
+		if (!isPointInBvhNode(pNode, pointV3)) {
+			continue;
+		}
+		if (!pNode->count) {
+			PIX_ERR_ASSERT("bvh too deep", stackSize + 2 <= STUC_USG_BVH_MAX_DEPTH);
+			stack[stackSize++] = pNode->start + 1;
+			stack[stackSize++] = pNode->start;
+			continue;
+		}
+		for (I32 i = pNode->start; i < pNode->start + pNode->count; ++i) {
+			I32 *pTriVerts = pBvh->pTris + i * 3;
+			V3_F32 tri[3] = {
+				pMesh->pPos[pTriVerts[0]],
+				pMesh->pPos[pTriVerts[1]],
+				pMesh->pPos[pTriVerts[2]]
+			};
+			wind += hitTestTri(pAlloc, pointV3, tri, pTriVerts, &hitEdges);
+		}
+	}
+	if (hitEdges.pArr) {
+		pAlloc->fpFree(hitEdges.pArr);
+	}
 	return wind % 2;
 }
 
@@ -313,9 +441,8 @@ static
 void assignUsgToVertsInFace(
 	const StucAlloc *pAlloc,
 	StucMap pMap,
-	Mesh *pMesh,
+	const Usg *pUsg,
 	const Mesh *pSquares,
-	Mesh *pFlatCutoff,
 	I32 usgIdx,
 	I32 faceIdx,
 	I32 *pCellFaces,
@@ -333,10 +460,10 @@ void assignUsgToVertsInFace(
 	for (I32 l = 0; l < mapFace.size; ++l) {
 		I32 vertIdx = pMap->pMesh->core.pCorners[mapFace.start + l];
 		V3_F32 vert = pMap->pMesh->pPos[vertIdx];
-		if (stucIsPointInsideMesh(pAlloc, vert, pMesh)) {
+		if (stucIsPointInsideMesh(pAlloc, vert, pUsg->pMesh, &pUsg->bvh)) {
 			pMap->pMesh->pUsg[vertIdx] = usgIdx + 1;
-			if (pFlatCutoff &&
-				stucIsPointInsideMesh(pAlloc, vert, pFlatCutoff)) {
+			if (pUsg->pFlatCutoff &&
+				stucIsPointInsideMesh(pAlloc, vert, pUsg->pFlatCutoff, &pUsg->cutoffBvh)) {
 
 				//negative indicates the vert is above the cutoff
 				pMap->pMesh->pUsg[vertIdx] *= -1;
@@ -364,8 +491,7 @@ StucErr stucAssignUsgsToVerts(
 		&averageMapFacesPerFace
 	);
 	for (I32 i = 0; i < pMap->usgArr.count; ++i) {
-		Mesh *pMesh = (Mesh *)pUsgArr[i].obj.pData;
-		Mesh *pFlatCutoff = pMap->usgArr.pArr[i].pFlatCutoff + pUsgArr[i].flatCutoff.idx;
+		const Usg *pUsg = pMap->usgArr.pArr + i;
 		FaceRange squaresFace = stucGetFaceRange(&pSquares->core, i);
 		FaceCells *pFaceCellsEntry = stucIdxFaceCells(&faceCellsTable, i, 0);
 		for (I32 j = 0; j < pFaceCellsEntry->cellSize; ++j) {
@@ -395,9 +521,8 @@ StucErr stucAssignUsgsToVerts(
 				assignUsgToVertsInFace(
 					pAlloc,
 					pMap,
-					pMesh,
+					pUsg,
 					pSquares,
-					pFlatCutoff,
 					i,
 					k,
 					pCellFaces,
@@ -502,10 +627,181 @@ StucErr isFaceClosestToOrigin(
 	return err;
 }
 
+//uv-space grid over the in-faces listed in the in-face table.
+//Each face is added once per uv tile it spans, with its bounds moved into 0-1 space,
+//so a usg origin only needs testing against the faces in its cell
+typedef struct InFaceGridEntry {
+	I32 face;
+	V2_I32 tile;
+} InFaceGridEntry;
+
+typedef struct InFaceGrid {
+	I32 *pCellStarts; //dim * dim + 1
+	InFaceGridEntry *pEntries;
+	I32 dim;
+} InFaceGrid;
+
+#define STUC_USG_GRID_DIM_MAX 256
+
+static
+bool getFaceGridCells(
+	const InFaceGrid *pGrid,
+	const FaceBounds *pBounds,
+	V2_I32 tile,
+	V2_I32 *pMin,
+	V2_I32 *pMax
+) {
+	for (I32 i = 0; i < 2; ++i) {
+		F32 min = pBounds->fBBoxSmall.min.d[i] - (F32)tile.d[i];
+		F32 max = pBounds->fBBoxSmall.max.d[i] - (F32)tile.d[i];
+		if (max < .0f || min > 1.0f) {
+			return false;
+		}
+		pMin->d[i] = PIXM_MAX((I32)(min * pGrid->dim), 0);
+		pMax->d[i] = PIXM_MIN((I32)(max * pGrid->dim), pGrid->dim - 1);
+	}
+	return true;
+}
+
+//if pEntries is NULL, cell sizes are counted instead
+static
+void addFaceToGrid(InFaceGrid *pGrid, const Mesh *pInMesh, I32 faceIdx) {
+	FaceRange face = stucGetFaceRange(&pInMesh->core, faceIdx);
+	FaceBounds bounds = {0};
+	stucGetFaceBoundsForTileTest(&bounds, pInMesh, &face);
+	for (I32 l = bounds.min.d[1]; l <= bounds.max.d[1]; ++l) {
+		for (I32 m = bounds.min.d[0]; m <= bounds.max.d[0]; ++m) {
+			V2_I32 tile = {m, l};
+			V2_I32 min = {0};
+			V2_I32 max = {0};
+			if (!getFaceGridCells(pGrid, &bounds, tile, &min, &max)) {
+				continue;
+			}
+			for (I32 y = min.d[1]; y <= max.d[1]; ++y) {
+				for (I32 x = min.d[0]; x <= max.d[0]; ++x) {
+					I32 cell = y * pGrid->dim + x;
+					if (pGrid->pEntries) {
+						pGrid->pEntries[pGrid->pCellStarts[cell]++] =
+							(InFaceGridEntry){.face = faceIdx, .tile = tile};
+					}
+					else {
+						pGrid->pCellStarts[cell]++;
+					}
+				}
+			}
+		}
+	}
+}
+
+static
+void inFaceGridBuild(
+	const StucAlloc *pAlloc,
+	InFaceGrid *pGrid,
+	const Mesh *pInMesh,
+	const InFaceArr *pInFaceTable,
+	I32 squareCount
+) {
+	//faces are often listed for multiple squares, so they're de-duplicated first
+	U8 *pAdded = pAlloc->fpCalloc(pInMesh->core.faceCount, 1);
+	I32 faceCount = 0;
+	for (I32 i = 0; i < squareCount; ++i) {
+		faceCount += pInFaceTable[i].count;
+	}
+	I32 *pFaces = pAlloc->fpMalloc(PIXM_MAX(faceCount, 1) * sizeof(I32));
+	faceCount = 0;
+	for (I32 i = 0; i < squareCount; ++i) {
+		for (I32 j = 0; j < pInFaceTable[i].count; ++j) {
+			I32 face = pInFaceTable[i].pArr[j];
+			if (!pAdded[face]) {
+				pAdded[face] = true;
+				pFaces[faceCount++] = face;
+			}
+		}
+	}
+	pAlloc->fpFree(pAdded);
+	pGrid->dim = (I32)sqrtf((F32)faceCount);
+	pGrid->dim = PIXM_MIN(PIXM_MAX(pGrid->dim, 1), STUC_USG_GRID_DIM_MAX);
+	I32 cellCount = pGrid->dim * pGrid->dim;
+	pGrid->pCellStarts = pAlloc->fpCalloc(cellCount + 1, sizeof(I32));
+	pGrid->pEntries = NULL;
+	for (I32 i = 0; i < faceCount; ++i) {
+		addFaceToGrid(pGrid, pInMesh, pFaces[i]);
+	}
+	//convert counts to starts
+	I32 entryCount = 0;
+	for (I32 i = 0; i < cellCount; ++i) {
+		I32 count = pGrid->pCellStarts[i];
+		pGrid->pCellStarts[i] = entryCount;
+		entryCount += count;
+	}
+	pGrid->pCellStarts[cellCount] = entryCount;
+	pGrid->pEntries = pAlloc->fpMalloc(PIXM_MAX(entryCount, 1) * sizeof(InFaceGridEntry));
+	for (I32 i = 0; i < faceCount; ++i) {
+		addFaceToGrid(pGrid, pInMesh, pFaces[i]);
+	}
+	//fill pass advanced each start to the next cell's start, so shift back
+	for (I32 i = cellCount - 1; i > 0; --i) {
+		pGrid->pCellStarts[i] = pGrid->pCellStarts[i - 1];
+	}
+	pGrid->pCellStarts[0] = 0;
+	pAlloc->fpFree(pFaces);
+}
+
+static
+void inFaceGridDestroy(const StucAlloc *pAlloc, InFaceGrid *pGrid) {
+	if (pGrid->pCellStarts) {
+		pAlloc->fpFree(pGrid->pCellStarts);
+	}
+	if (pGrid->pEntries) {
+		pAlloc->fpFree(pGrid->pEntries);
+	}
+	*pGrid = (InFaceGrid){0};
+}
+
+static
+StucErr testFaceTilesForOrigin(
+	const Usg *pUsg,
+	const Mesh *pInMesh,
+	FaceRange *pInFace,
+	FaceBounds *pFaceBounds,
+	V2_I32 minTile,
+	V2_I32 maxTile,
+	V3_F32 *pClosestBc,
+	FaceRange *pClosestFace,
+	I8 *pClosestFaceCorners,
+	F32 *pClosestDist,
+	bool *pRet
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	for (I32 l = minTile.d[1]; l <= maxTile.d[1]; ++l) {
+		for (I32 m = minTile.d[0]; m <= maxTile.d[0]; ++m) {
+			V2_I32 tileMin = {m, l};
+			err = isFaceClosestToOrigin(
+				pUsg,
+				pInMesh,
+				tileMin,
+				pInFace,
+				pFaceBounds,
+				pClosestBc,
+				pClosestFace,
+				pClosestFaceCorners,
+				pClosestDist,
+				pRet
+			);
+			PIX_ERR_RETURN_IFNOT(err, "");
+			if (*pRet) {
+				return err;
+			}
+		}
+	}
+	return err;
+}
+
 static
 StucErr getClosestTriToOrigin(
 	const Usg *pUsg,
 	const Mesh *pInMesh,
+	const InFaceGrid *pGrid,
 	InFaceArr *pInFaceTable,
 	I32 i,
 	V3_F32 *pClosestBc,
@@ -514,33 +810,64 @@ StucErr getClosestTriToOrigin(
 	F32 *pClosestDist
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
+	bool ret = false;
+	V2_F32 origin = pUsg->origin;
+	if (origin.d[0] >= .0f && origin.d[0] <= 1.0f &&
+		origin.d[1] >= .0f && origin.d[1] <= 1.0f) {
+
+		//only faces in the origin's cell can contain it
+		I32 x = PIXM_MIN((I32)(origin.d[0] * pGrid->dim), pGrid->dim - 1);
+		I32 y = PIXM_MIN((I32)(origin.d[1] * pGrid->dim), pGrid->dim - 1);
+		I32 cell = y * pGrid->dim + x;
+		for (I32 j = pGrid->pCellStarts[cell]; j < pGrid->pCellStarts[cell + 1]; ++j) {
+			const InFaceGridEntry *pEntry = pGrid->pEntries + j;
+			FaceRange inFace = stucGetFaceRange(&pInMesh->core, pEntry->face);
+			FaceBounds faceBounds = {0};
+			stucGetFaceBoundsForTileTest(&faceBounds, pInMesh, &inFace);
+			err = testFaceTilesForOrigin(
+				pUsg,
+				pInMesh,
+				&inFace,
+				&faceBounds,
+				pEntry->tile, pEntry->tile,
+				pClosestBc,
+				pClosestFace,
+				pClosestFaceCorners,
+				pClosestDist,
+				&ret
+			);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+			if (ret) {
+				return err;
+			}
+		}
+	}
+	//origin isn't inside any face, fallback to finding the closest.
+	//The grid pass may have tested faces outside this square's table,
+	//so the closest state it left is discarded
+	*pClosestBc = (V3_F32){FLT_MAX, FLT_MAX, FLT_MAX};
+	*pClosestFace = (FaceRange){.idx = -1};
+	pClosestFaceCorners[0] = pClosestFaceCorners[1] = pClosestFaceCorners[2] = 0;
+	*pClosestDist = FLT_MAX;
 	for (I32 j = 0; j < pInFaceTable[i].count; ++j) {
 		FaceRange inFace = stucGetFaceRange(&pInMesh->core, pInFaceTable[i].pArr[j]);
 		FaceBounds faceBounds = {0};
 		stucGetFaceBoundsForTileTest(&faceBounds, pInMesh, &inFace);
-		V2_I32 minTile = faceBounds.min;
-		V2_I32 maxTile = faceBounds.max;
-		for (I32 l = minTile.d[1]; l <= maxTile.d[1]; ++l) {
-			for (I32 m = minTile.d[0]; m <= maxTile.d[0]; ++m) {
-				V2_I32 tileMin = {m, l};
-				bool ret = false;
-				err = isFaceClosestToOrigin(
-					pUsg,
-					pInMesh,
-					tileMin,
-					&inFace,
-					&faceBounds,
-					pClosestBc,
-					pClosestFace,
-					pClosestFaceCorners,
-					pClosestDist,
-					&ret
-				);
-				PIX_ERR_THROW_IFNOT(err, "", 0);
-				if (ret) {
-					return err;
-				}
-			}
+		err = testFaceTilesForOrigin(
+			pUsg,
+			pInMesh,
+			&inFace,
+			&faceBounds,
+			faceBounds.min, faceBounds.max,
+			pClosestBc,
+			pClosestFace,
+			pClosestFaceCorners,
+			pClosestDist,
+			&ret
+		);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+		if (ret) {
+			return err;
 		}
 	}
 	PIX_ERR_ASSERT("", pClosestFace->idx >= 0);
@@ -548,6 +875,100 @@ StucErr getClosestTriToOrigin(
 	return err;
 }
 
+typedef struct SampleUsgShared {
+	const StucMap pMap;
+	const Mesh *pInMesh;
+	const StucMesh *pSquares;
+	const Mesh *pSquaresWrap;
+	InFaceArr *pInFaceTable;
+	InFaceGrid grid;
+} SampleUsgShared;
+
+typedef struct SampleUsgJobArgs {
+	JobArgs core;
+} SampleUsgJobArgs;
+
+static
+I32 sampleUsgJobsGetRange(StucContext pCtx, const void *pShared, void *pInitInfo) {
+	return ((const SampleUsgShared *)pShared)->pSquares->faceCount;
+}
+
+static
+StucErr sampleInAttribsAtUsgOrigin(const SampleUsgShared *pShared, I32 i) {
+	StucErr err = PIX_ERR_SUCCESS;
+	const Mesh *pInMesh = pShared->pInMesh;
+	const StucMesh *pSquares = pShared->pSquares;
+	InFaceArr *pInFaceTable = pShared->pInFaceTable;
+	const Usg *pUsg = pShared->pMap->usgArr.pArr + pInFaceTable[i].usg;
+	V3_F32 closestBc = {FLT_MAX, FLT_MAX, FLT_MAX};
+	FaceRange closestFace = {.idx = -1};
+	I8 closestFaceCorners[3] = {0};
+	F32 closestDist = FLT_MAX;
+	err = getClosestTriToOrigin(
+		pUsg,
+		pInMesh,
+		&pShared->grid,
+		pInFaceTable,
+		i,
+		&closestBc,
+		&closestFace,
+		closestFaceCorners,
+		&closestDist
+	);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	pInFaceTable[i].tri[0] = closestFace.start + closestFaceCorners[0];
+	pInFaceTable[i].tri[1] = closestFace.start + closestFaceCorners[1];
+	pInFaceTable[i].tri[2] = closestFace.start + closestFaceCorners[2];
+	pInFaceTable[i].tbn =
+		stucGetInterpolatedTbn(pInMesh, &closestFace, closestFaceCorners, closestBc);
+	pInFaceTable[i].normal = *(V3_F32 *)&pInFaceTable[i].tbn.d[2];
+	//add offset if current position will cause intersections with surface
+	FaceRange face = stucGetFaceRange(pSquares, i);
+	I32 triVerts[3] = {
+		pInMesh->core.pCorners[pInFaceTable[i].tri[0]],
+		pInMesh->core.pCorners[pInFaceTable[i].tri[1]],
+		pInMesh->core.pCorners[pInFaceTable[i].tri[2]]
+	};
+	V3_F32 tri[3] = {
+		pInMesh->pPos[triVerts[0]],
+		pInMesh->pPos[triVerts[1]],
+		pInMesh->pPos[triVerts[2]]
+	};
+	// where a is the origin, ab is the normal, and c is the square vert
+	V3_F32 a = pixmBarycentricToCartesian(tri, closestBc);
+	V3_F32 ab = pInFaceTable[i].normal;
+	F32 tMax = -FLT_MAX;
+	PIX_ERR_ASSERT("", face.start >= 0 && face.size >= 3);
+	for (I32 j = 0; j < face.size; ++j) {
+		I32 vert = pSquares->pCorners[face.start + j];
+		V3_F32 ac = _(pShared->pSquaresWrap->pPos[vert] V3SUB a);
+		F32 t = _(ab V3DOT ac);
+		if (t > tMax) {
+			tMax = t;
+		}
+	}
+	pInFaceTable[i].offset = tMax > .0f ? tMax : .0f;
+
+	//TODO support usg for more than just normal maps,
+	//     add a ui to select which attribs should be uniform.
+	//     Ideally you should be able to do this per usg,
+	//     though you'd need to store usg names for that to work.
+	return err;
+}
+
+static
+StucErr sampleUsgJob(void *pArgsVoid) {
+	StucErr err = PIX_ERR_SUCCESS;
+	SampleUsgJobArgs *pArgs = pArgsVoid;
+	const SampleUsgShared *pShared = pArgs->core.pShared;
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		//each square only writes to it's own in-face table entry
+		err = sampleInAttribsAtUsgOrigin(pShared, i);
+		PIX_ERR_RETURN_IFNOT(err, "");
+	}
+	return err;
+}
+
 StucErr stucSampleInAttribsAtUsgOrigins(
 	StucContext pCtx,
 	const StucMap pMap,
@@ -557,70 +978,39 @@ StucErr stucSampleInAttribsAtUsgOrigins(
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	PIX_ERR_ASSERT("", pSquares);
-	for (I32 i = 0; i < pSquares->faceCount; ++i) {
-		const Usg *pUsg = pMap->usgArr.pArr + pInFaceTable[i].usg;
-		V3_F32 closestBc = {FLT_MAX, FLT_MAX, FLT_MAX};
-		FaceRange closestFace = {.idx = -1};
-		I8 closestFaceCorners[3] = {0};
-		F32 closestDist = FLT_MAX;
-		err = getClosestTriToOrigin(
-			pUsg,
-			pInMesh,
-			pInFaceTable,
-			i,
-			&closestBc,
-			&closestFace,
-			closestFaceCorners,
-			&closestDist
-		);
-		PIX_ERR_THROW_IFNOT(err, "", 0);
-		pInFaceTable[i].tri[0] = closestFace.start + closestFaceCorners[0];
-		pInFaceTable[i].tri[1] = closestFace.start + closestFaceCorners[1];
-		pInFaceTable[i].tri[2] = closestFace.start + closestFaceCorners[2];
-		pInFaceTable[i].tbn =
-			stucGetInterpolatedTbn(pInMesh, &closestFace, closestFaceCorners, closestBc);
-		pInFaceTable[i].normal = *(V3_F32 *)&pInFaceTable[i].tbn.d[2];
-		//add offset if current position will cause intersections with surface
-		FaceRange face = stucGetFaceRange(pSquares, i);
-		I32 triVerts[3] = {
-			pInMesh->core.pCorners[pInFaceTable[i].tri[0]],
-			pInMesh->core.pCorners[pInFaceTable[i].tri[1]],
-			pInMesh->core.pCorners[pInFaceTable[i].tri[2]]
-		};
-		V3_F32 tri[3] = {
-			pInMesh->pPos[triVerts[0]],
-			pInMesh->pPos[triVerts[1]],
-			pInMesh->pPos[triVerts[2]]
-		};
-		Mesh squaresWrap = {.core = *pSquares};
-		err = stucAssignActiveAliases(
-			pCtx,
-			&squaresWrap,
-			0x1 << STUC_ATTRIB_USE_POS,
-			STUC_DOMAIN_NONE
-		);
-		PIX_ERR_THROW_IFNOT(err, "", 0);
-		// where a is the origin, ab is the normal, and c is the square vert
-		V3_F32 a = pixmBarycentricToCartesian(tri, closestBc);
-		V3_F32 ab = pInFaceTable[i].normal;
-		F32 tMax = -FLT_MAX;
-		PIX_ERR_ASSERT("", face.start >= 0 && face.size >= 3);
-		for (I32 j = 0; j < face.size; ++j) {
-			I32 vert = pSquares->pCorners[face.start + j];
-			V3_F32 ac = _(squaresWrap.pPos[vert] V3SUB a);
-			F32 t = _(ab V3DOT ac);
-			if (t > tMax) {
-				tMax = t;
-			}
-		}
-		pInFaceTable[i].offset = tMax > .0f ? tMax : .0f;
-		
-		//TODO support usg for more than just normal maps,
-		//     add a ui to select which attribs should be uniform.
-		//     Ideally you should be able to do this per usg,
-		//     though you'd need to store usg names for that to work.
-	}
+	Mesh squaresWrap = {.core = *pSquares};
+	err = stucAssignActiveAliases(
+		pCtx,
+		&squaresWrap,
+		0x1 << STUC_ATTRIB_USE_POS,
+		STUC_DOMAIN_NONE
+	);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	SampleUsgShared shared = {
+		.pMap = pMap,
+		.pInMesh = pInMesh,
+		.pSquares = pSquares,
+		.pSquaresWrap = &squaresWrap,
+		.pInFaceTable = pInFaceTable
+	};
+	inFaceGridBuild(&pCtx->alloc, &shared.grid, pInMesh, pInFaceTable, pSquares->faceCount);
+	I32 jobCount = 0;
+	SampleUsgJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+	stucMakeJobArgs(
+		pCtx,
+		&shared,
+		&jobCount, jobArgs, sizeof(SampleUsgJobArgs),
+		NULL,
+		sampleUsgJobsGetRange, NULL
+	);
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, jobArgs, sizeof(SampleUsgJobArgs),
+		sampleUsgJob
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
 	PIX_ERR_CATCH(0, err, ;);
+	inFaceGridDestroy(&pCtx->alloc, &shared.grid);
 	return err;
 }
 
@@ -9,6 +9,26 @@ SPDX-License-Identifier: Apache-2.0
 
 #include <types.h>
 
+//leaves hold at most this many tris
+#define STUC_USG_BVH_LEAF_SIZE 4
+#define STUC_USG_BVH_MAX_DEPTH 64
+
+//nodes are bounded in x & y only, as inside tests cast along z.
+//Leaves have a tri count, inner nodes have a count of 0,
+//and their children are stored as a pair at start & start + 1
+typedef struct UsgBvhNode {
+	BBox bbox;
+	I32 start;
+	I32 count;
+} UsgBvhNode;
+
+typedef struct UsgBvh {
+	UsgBvhNode *pNodes;
+	I32 *pTris; //3 verts per tri
+	I32 nodeCount;
+	I32 triCount;
+} UsgBvh;
+
 typedef struct Usg {
 	//allow user to save name of usg meshes if desired?
 	//probably wouldn't include it in the map file by default,
@@ -16,6 +36,8 @@ typedef struct Usg {
 	//and edit the stuc file later, it may be helpful as a choice
 	Mesh *pMesh;
 	Mesh *pFlatCutoff;
+	UsgBvh bvh;
+	UsgBvh cutoffBvh;
 	V2_F32 origin;
 } Usg;
 
@@ -87,4 +109,11 @@ void stucUsgVertTransform(
 	V2_F32 tileMin,
 	M3x3 *pTbn
 );
-bool stucIsPointInsideMesh(const StucAlloc *pAlloc, V3_F32 pointV3, Mesh *pMesh);
\ No newline at end of file
+StucErr stucUsgBvhBuild(const StucAlloc *pAlloc, UsgBvh *pBvh, const Mesh *pMesh);
+void stucUsgBvhDestroy(const StucAlloc *pAlloc, UsgBvh *pBvh);
+bool stucIsPointInsideMesh(
+	const StucAlloc *pAlloc,
+	V3_F32 pointV3,
+	const Mesh *pMesh,
+	const UsgBvh *pBvh
+);
\ No newline at end of file
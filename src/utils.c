@@ -155,137 +155,253 @@ bool stucCheckIfEdgeIsReceive(const Mesh *pMesh, I32 edge, F32 receiveLen) {
 	return true;
 }
 
-typedef struct AdjEntry {
-	I32 face;
-	I32 corner;
-} AdjEntry;
-
-typedef struct AdjBucket {
-	AdjEntry* pArr;
-	I32 count;
-	I32 size;
-} AdjBucket;
+#define EDGE_SORT_RADIX 256
+
+//edges are found by sorting corners by their (min vert, max vert) key, so that
+//corners sharing an edge end up adjacent. The sort is a parallel LSD radix sort
+//over only the bytes needed to index a vert, so no per-vert buckets are required.
+typedef struct EdgeSortShared {
+	const StucMesh *pMesh;
+	U64 *pKeys[2];
+	I32 *pCornerIdx[2];
+	I32 src;
+	I32 shift;
+} EdgeSortShared;
+
+typedef struct EdgeSortJobArgs {
+	JobArgs core;
+	Range cornerRange;
+	I32 hist[EDGE_SORT_RADIX];
+} EdgeSortJobArgs;
 
 static
-void adjTableDestroyBuckets(const StucAlloc *pAlloc, I32 count, AdjBucket *pAdjTable) {
-	for (I32 i = 0; i < count; ++i) {
-		if (pAdjTable[i].pArr) {
-			pAlloc->fpFree(pAdjTable[i].pArr);
-		}
-	}
+U64 edgeSortKeyGet(I32 vert, I32 vertNext) {
+	U32 min = vert < vertNext ? vert : vertNext;
+	U32 max = vert < vertNext ? vertNext : vert;
+	return (U64)min << 32 | max;
 }
 
 static
-StucErr buildCornerAdjTable(
-	const StucAlloc *pAlloc,
-	const StucMesh *pMesh,
-	AdjBucket *pAdjTable
-) {
+StucErr edgeSortEmitKeys(void *pArgsVoid) {
 	StucErr err = PIX_ERR_SUCCESS;
-	PIX_ERR_ASSERT("", pAdjTable);
-	for (I32 i = 0; i < pMesh->faceCount; ++i) {
+	EdgeSortJobArgs *pArgs = pArgsVoid;
+	const EdgeSortShared *pShared = pArgs->core.pShared;
+	const StucMesh *pMesh = pShared->pMesh;
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
 		FaceRange face = stucGetFaceRange(pMesh, i);
 		for (I32 j = 0; j < face.size; ++j) {
-			AdjBucket* pBucket = pAdjTable + pMesh->pCorners[face.start + j];
-			PIX_ERR_ASSERT("", pBucket->count <= pBucket->size);
-			if (!pBucket->pArr) {
-				pBucket->size = 2;
-				pBucket->pArr =
-					pAlloc->fpMalloc(sizeof(AdjEntry) * pBucket->size);
-			}
-			else if (pBucket->count == pBucket->size) {
-				PIX_ERR_ASSERT("tried to realloc null arr", pBucket->pArr);
-				pBucket->size *= 2;
-				pBucket->pArr = pAlloc->fpRealloc(
-					pBucket->pArr,
-					sizeof(AdjEntry) * pBucket->size
+			I32 vert = pMesh->pCorners[face.start + j];
+			for (I32 k = 0; k < j; ++k) {
+				PIX_ERR_RETURN_IFNOT_COND(
+					err,
+					pMesh->pCorners[face.start + k] != vert,
+					"Invalid mesh, 2 corners in this face share 1 vert"
 				);
 			}
-			pBucket->pArr[pBucket->count].face = i;
-			pBucket->pArr[pBucket->count].corner = j;
-			pBucket->count++;
+			I32 vertNext = pMesh->pCorners[face.start + (j + 1) % face.size];
+			pShared->pKeys[0][face.start + j] = edgeSortKeyGet(vert, vertNext);
+			pShared->pCornerIdx[0][face.start + j] = face.start + j;
 		}
 	}
-	PIX_ERR_CATCH(0, err,
-		adjTableDestroyBuckets(pAlloc, pMesh->vertCount, pAdjTable);
-	;);
 	return err;
 }
 
 static
-StucErr findEdgesForFace(StucMesh *pMesh, AdjBucket* pAdjTable, I32 idx) {
-	StucErr err = PIX_ERR_SUCCESS;
-	FaceRange face = stucGetFaceRange(pMesh, idx);
-	for (I32 j = 0; j < face.size; ++j) {
-		if (pMesh->pEdges[face.start + j] >= 0) {
-			continue; //Already set
-		}
-		I32 edge = pMesh->edgeCount;
-		pMesh->edgeCount++;
-		AdjBucket* pBucket = pAdjTable + pMesh->pCorners[face.start + j];
-		PIX_ERR_ASSERT("", pBucket->count > 0 && pBucket->size >= pBucket->count);
-		for (I32 k = 0; k < pBucket->count; ++k) {
-			AdjEntry* pEntry = pBucket->pArr + k;
-			if (pEntry->face == idx) {
-				PIX_ERR_RETURN_IFNOT_COND(
-					err,
-					pEntry->corner == j,
-					"Invalid mesh, 2 corners in this face share 1 vert"
-				);
-				continue;
-			}
-			FaceRange otherFace = stucGetFaceRange(pMesh, pEntry->face);
-			I32 nextCorner = (j + 1) % face.size;
-			I32 otherPrevCorner = pEntry->corner ?
-				pEntry->corner - 1 : otherFace.size - 1;
-			if (pMesh->pEdges[otherFace.start + otherPrevCorner] >= 0) {
-				continue; //Already set
-			}
-			if (pMesh->pCorners[face.start + nextCorner] !=
-				pMesh->pCorners[otherFace.start + otherPrevCorner]) {
-				continue; //Not connected
-			}
-			pMesh->pEdges[otherFace.start + otherPrevCorner] = edge;
-			break;
+StucErr edgeSortHistogram(void *pArgsVoid) {
+	EdgeSortJobArgs *pArgs = pArgsVoid;
+	const EdgeSortShared *pShared = pArgs->core.pShared;
+	const U64 *pKeys = pShared->pKeys[pShared->src];
+	memset(pArgs->hist, 0, sizeof(pArgs->hist));
+	for (I32 i = pArgs->cornerRange.start; i < pArgs->cornerRange.end; ++i) {
+		pArgs->hist[pKeys[i] >> pShared->shift & (EDGE_SORT_RADIX - 1)]++;
+	}
+	return PIX_ERR_SUCCESS;
+}
+
+static
+StucErr edgeSortScatter(void *pArgsVoid) {
+	EdgeSortJobArgs *pArgs = pArgsVoid;
+	const EdgeSortShared *pShared = pArgs->core.pShared;
+	I32 dest = !pShared->src;
+	const U64 *pKeys = pShared->pKeys[pShared->src];
+	const I32 *pCornerIdx = pShared->pCornerIdx[pShared->src];
+	//hist holds this job's starting offset for each digit at this point
+	for (I32 i = pArgs->cornerRange.start; i < pArgs->cornerRange.end; ++i) {
+		I32 digit = pKeys[i] >> pShared->shift & (EDGE_SORT_RADIX - 1);
+		I32 idx = pArgs->hist[digit]++;
+		pShared->pKeys[dest][idx] = pKeys[i];
+		pShared->pCornerIdx[dest][idx] = pCornerIdx[i];
+	}
+	return PIX_ERR_SUCCESS;
+}
+
+static
+void edgeSortHistToOffsets(I32 jobCount, EdgeSortJobArgs *pJobArgs) {
+	I32 offset = 0;
+	for (I32 i = 0; i < EDGE_SORT_RADIX; ++i) {
+		for (I32 j = 0; j < jobCount; ++j) {
+			I32 count = pJobArgs[j].hist[i];
+			pJobArgs[j].hist[i] = offset;
+			offset += count;
 		}
-		pMesh->pEdges[face.start + j] = edge;
 	}
-	return err;
 }
 
 static
-StucErr findEdges(StucMesh* pMesh, AdjBucket* pAdjTable) {
+I32 edgeSortJobsGetRange(StucContext pCtx, const void *pShared, void *pInitInfo) {
+	return ((const EdgeSortShared *)pShared)->pMesh->faceCount;
+}
+
+static
+void edgeSortJobInit(StucContext pCtx, void *pShared, void *pInitInfo, void *pEntryVoid) {
+	EdgeSortJobArgs *pEntry = pEntryVoid;
+	const StucMesh *pMesh = ((EdgeSortShared *)pShared)->pMesh;
+	pEntry->cornerRange = (Range) {
+		.start = pMesh->pFaces[pEntry->core.range.start],
+		.end = pMesh->pFaces[pEntry->core.range.end]
+	};
+}
+
+static
+I32 edgeSortGetVertBytes(I32 vertCount) {
+	I32 bytes = 1;
+	while (bytes < 4 && (U32)(vertCount - 1) >> bytes * 8) {
+		++bytes;
+	}
+	return bytes;
+}
+
+static
+StucErr edgeSortCorners(
+	StucContext pCtx,
+	EdgeSortShared *pShared,
+	I32 jobCount,
+	EdgeSortJobArgs *pJobArgs
+) {
 	StucErr err = PIX_ERR_SUCCESS;
-	for (I32 i = 0; i < pMesh->faceCount; ++i) {
-		err = findEdgesForFace(pMesh, pAdjTable, i);
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, pJobArgs, sizeof(EdgeSortJobArgs),
+		edgeSortEmitKeys
+	);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	I32 vertBytes = edgeSortGetVertBytes(pShared->pMesh->vertCount);
+	//max vert is the low half of the key, so it's sorted first
+	for (I32 i = 0; i < vertBytes * 2; ++i) {
+		pShared->shift = (i / vertBytes) * 32 + (i % vertBytes) * 8;
+		err = stucDoJobInParallel(
+			pCtx,
+			jobCount, pJobArgs, sizeof(EdgeSortJobArgs),
+			edgeSortHistogram
+		);
 		PIX_ERR_RETURN_IFNOT(err, "");
+		edgeSortHistToOffsets(jobCount, pJobArgs);
+		err = stucDoJobInParallel(
+			pCtx,
+			jobCount, pJobArgs, sizeof(EdgeSortJobArgs),
+			edgeSortScatter
+		);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		pShared->src = !pShared->src;
 	}
 	return err;
 }
 
+static
+bool isCornerEdgeForward(const StucMesh *pMesh, I32 corner, U64 key) {
+	return (U32)(key >> 32) == (U32)pMesh->pCorners[corner];
+}
+
+//corners with equal keys are contiguous, and in ascending order as the sort is stable.
+//As before, a corner is paired with the first unpaired corner after it which
+//traverses the edge in the opposite direction
+static
+void pairSortedCorners(
+	const StucMesh *pMesh,
+	const U64 *pKeys,
+	const I32 *pCornerIdx,
+	I32 *pPartner
+) {
+	I32 runStart = 0;
+	for (I32 i = 1; i <= pMesh->cornerCount; ++i) {
+		if (i < pMesh->cornerCount && pKeys[i] == pKeys[runStart]) {
+			continue;
+		}
+		for (I32 j = runStart; j < i; ++j) {
+			I32 corner = pCornerIdx[j];
+			if (pPartner[corner] != -1) {
+				continue;
+			}
+			bool forward = isCornerEdgeForward(pMesh, corner, pKeys[j]);
+			for (I32 k = j + 1; k < i; ++k) {
+				I32 other = pCornerIdx[k];
+				if (pPartner[other] != -1 ||
+					isCornerEdgeForward(pMesh, other, pKeys[k]) == forward
+				) {
+					continue;
+				}
+				pPartner[corner] = other;
+				pPartner[other] = corner;
+				break;
+			}
+		}
+		runStart = i;
+	}
+}
+
 StucErr stucBuildEdgeList(StucContext pCtx, StucMesh *pMesh) {
 	StucErr err = PIX_ERR_SUCCESS;
 	PIX_ERR_RETURN_IFNOT_COND(err, !pMesh->pEdges, "");
 	const StucAlloc *pAlloc = &pCtx->alloc;
 	PIX_ERR_ASSERT("", pMesh->vertCount);
-	AdjBucket* pAdjTable =
-		pAlloc->fpCalloc(pMesh->vertCount, sizeof(AdjBucket));
-	err = buildCornerAdjTable(pAlloc, pMesh, pAdjTable);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
+	PIX_ERR_ASSERT("", pMesh->cornerCount);
+	EdgeSortShared shared = {.pMesh = pMesh};
+	for (I32 i = 0; i < 2; ++i) {
+		shared.pKeys[i] = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(U64));
+		shared.pCornerIdx[i] = pAlloc->fpMalloc(pMesh->cornerCount * sizeof(I32));
+	}
+	I32 jobCount = 0;
+	EdgeSortJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+	stucMakeJobArgs(
+		pCtx,
+		&shared,
+		&jobCount, jobArgs, sizeof(EdgeSortJobArgs),
+		NULL,
+		edgeSortJobsGetRange, edgeSortJobInit
+	);
+	err = edgeSortCorners(pCtx, &shared, jobCount, jobArgs);
+	PIX_ERR_THROW_IFNOT(err, "failed to sort corners by edge", 0);
 	{
-		PIX_ERR_ASSERT("", pMesh->cornerCount);
 		I32 dataSize = sizeof(I32) * pMesh->cornerCount;
 		pMesh->pEdges = pAlloc->fpMalloc(dataSize);
 		memset(pMesh->pEdges, -1, dataSize);
-		err = findEdges(pMesh, pAdjTable);
-		PIX_ERR_THROW_IFNOT(err, "'findEdges' returned error", 1);
-		PIX_ERR_CATCH(1, err,
-			pAlloc->fpFree(pMesh->pEdges);
+		//the dest buffer of the last pass is reused for partners
+		I32 *pPartner = shared.pCornerIdx[!shared.src];
+		memset(pPartner, -1, dataSize);
+		pairSortedCorners(
+			pMesh,
+			shared.pKeys[shared.src],
+			shared.pCornerIdx[shared.src],
+			pPartner
 		);
+		//ids are assigned in corner order, so edge order matches face order
+		pMesh->edgeCount = 0;
+		for (I32 i = 0; i < pMesh->cornerCount; ++i) {
+			if (pMesh->pEdges[i] != -1) {
+				continue;
+			}
+			pMesh->pEdges[i] = pMesh->edgeCount;
+			if (pPartner[i] != -1) {
+				pMesh->pEdges[pPartner[i]] = pMesh->edgeCount;
+			}
+			pMesh->edgeCount++;
+		}
 	}
 	PIX_ERR_CATCH(0, err, ;);
-	adjTableDestroyBuckets(pAlloc, pMesh->vertCount, pAdjTable);
-	pAlloc->fpFree(pAdjTable);
+	for (I32 i = 0; i < 2; ++i) {
+		pAlloc->fpFree(shared.pKeys[i]);
+		pAlloc->fpFree(shared.pCornerIdx[i]);
+	}
 	return err;
 }
 
@@ -553,6 +669,10 @@ StucErr stucDoJobInParallel(
 	if (!jobCount) {
 		return err;
 	}
+	//small inputs are only given 1 job, which isn't worth the dispatch and wait
+	if (jobCount == 1) {
+		return func(pJobArgs);
+	}
 	void **ppJobHandles = NULL;
 	err = sendOffJobs(pCtx, jobCount, pJobArgs, argStructSize, func, &ppJobHandles);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
@@ -557,18 +557,21 @@ V3_F32 stucGetBarycentricInTriFromVerts(
 	return stucGetBarycentricInTri(pMesh, pFace, stucGetVertPos, pTriCorners, vert);
 }
 
-//Caller must check for nan in return value
+//Caller must check for nan in return value.
+//Pass a constant faceSize to get a tri or quad only variant
 STUC_FORCE_INLINE
-V3_F32 stucGetBarycentricInFace(
+V3_F32 stucGetBarycentricInFaceSized(
 	const Mesh *pMesh,
 	const FaceRange *pFace,
+	I32 faceSize,
 	V2_I16 tile,
 	V3_F32 (* fpGetPoint)(const Mesh *, const FaceRange *, I32),
 	I8 *pTriCorners,
 	V2_F32 vertV2
 ) {
 	PIX_ERR_ASSERT("", pixmV2F32IsFinite(vertV2));
-	PIX_ERR_ASSERT("", (pFace->size == 3 || pFace->size == 4) && pTriCorners);
+	PIX_ERR_ASSERT("", faceSize == pFace->size);
+	PIX_ERR_ASSERT("", (faceSize == 3 || faceSize == 4) && pTriCorners);
 	V3_F32 vert = {.d = {vertV2.d[0], vertV2.d[1]}};
 	V3_F32 fTile = {.d = {(F32)tile.d[0], (F32)tile.d[1]}};
 	V3_F32 triA[3] = {0};
@@ -577,7 +580,7 @@ V3_F32 stucGetBarycentricInFace(
 	}
 	V3_F32 up = {.d = {.0f, .0f, 1.0f}};
 	V3_F32 vertBc = pixmCartesianToBarycentric(triA, &vert, &up);
-	if (pFace->size == 4 && pixmV3F32IsFinite(vertBc) && vertBc.d[1] < 0) {
+	if (faceSize == 4 && pixmV3F32IsFinite(vertBc) && vertBc.d[1] < 0) {
 		//base face is a quad, and vert is outside first tri,
 		//so use the second tri
 		
@@ -598,6 +601,27 @@ V3_F32 stucGetBarycentricInFace(
 	return vertBc;
 }
 
+//Caller must check for nan in return value
+STUC_FORCE_INLINE
+V3_F32 stucGetBarycentricInFace(
+	const Mesh *pMesh,
+	const FaceRange *pFace,
+	V2_I16 tile,
+	V3_F32 (* fpGetPoint)(const Mesh *, const FaceRange *, I32),
+	I8 *pTriCorners,
+	V2_F32 vertV2
+) {
+	return stucGetBarycentricInFaceSized(
+		pMesh,
+		pFace,
+		pFace->size,
+		tile,
+		fpGetPoint,
+		pTriCorners,
+		vertV2
+	);
+}
+
 static inline
 V3_F32 stucGetBarycentricInFaceFromVerts(
 	const Mesh *pMesh,
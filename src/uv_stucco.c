@@ -60,6 +60,7 @@ StucErr stucContextInit(
 	else {
 		stucIoSetDefault(*pCtx);
 	}
+	stucCodecsSetDefault(*pCtx);
 	err = (*pCtx)->threadPool.fpInit(
 		&(*pCtx)->pThreadPoolHandle,
 		&(*pCtx)->threadCount,
@@ -91,6 +92,7 @@ StucErr stucContextInit(
 }
 
 StucErr stucContextDestroy(StucContext pCtx) {
+	stucInMeshCacheDestroy(pCtx);
 	if (pCtx->pThreadPoolHandle) {
 		pCtx->threadPool.fpDestroy(pCtx->pThreadPoolHandle);
 	}
@@ -98,20 +100,23 @@ StucErr stucContextDestroy(StucContext pCtx) {
 	return PIX_ERR_SUCCESS;
 }
 
-//TODO replace these with StucUsg and StucObj arr structs, that combine arr and count
-StucErr stucMapFileLoadForEdit(
-	StucContext pCtx,
-	const char *filePath,
-	I32 *pObjCount,
-	StucObject **ppObjArr,
-	I32 *pUsgCount,
-	StucUsg **ppUsgArr,
-	I32 *pFlatCutoffCount,
-	StucObject **ppFlatCutoffArr,
-	StucAttribIndexedArr *pIndexedAttribs
-) {
-	//TODO reimplement
-	return PIX_ERR_ERROR;
+StucErr stucContextClipCacheSet(StucContext pCtx, bool enable) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pCtx, "");
+	pCtx->clipCache = enable;
+	return err;
+}
+
+StucErr stucContextInMeshCacheSet(StucContext pCtx, bool enable) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pCtx, "");
+	if (enable && !pCtx->pInMeshCache) {
+		stucInMeshCacheInit(pCtx);
+	}
+	else if (!enable) {
+		stucInMeshCacheDestroy(pCtx);
+	}
+	return err;
 }
 
 static
@@ -190,6 +195,101 @@ void addTri(
 	++pBufMesh->faceCount;
 }
 
+typedef struct TriangulateShared {
+	const StucMesh *pMesh;
+	const Mesh *pWrap;
+	const StucMesh *pBufMesh;
+} TriangulateShared;
+
+typedef struct TriangulateJobArgs {
+	JobArgs core;
+	//ngon tris are found in the count pass, and stored here for the fill pass.
+	//Each ngon is stored as a tri count, followed by it's tris
+	U8 *pNgonTris;
+	I32 ngonTrisSize;
+	I32 ngonTrisCount;
+	I32 triCount;
+	I32 triStart;
+} TriangulateJobArgs;
+
+static
+I32 triangulateJobsGetRange(StucContext pCtx, const void *pShared, void *pInitInfo) {
+	return ((const TriangulateShared *)pShared)->pMesh->faceCount;
+}
+
+static
+void ngonTrisAppend(
+	const StucAlloc *pAlloc,
+	TriangulateJobArgs *pArgs,
+	const U8 *pTris,
+	I32 count
+) {
+	I32 len = count * 3 + 1;
+	if (pArgs->ngonTrisCount + len > pArgs->ngonTrisSize) {
+		pArgs->ngonTrisSize = (pArgs->ngonTrisCount + len) * 2;
+		pArgs->pNgonTris = pArgs->pNgonTris ?
+			pAlloc->fpRealloc(pArgs->pNgonTris, pArgs->ngonTrisSize) :
+			pAlloc->fpMalloc(pArgs->ngonTrisSize);
+	}
+	pArgs->pNgonTris[pArgs->ngonTrisCount] = (U8)count;
+	memcpy(pArgs->pNgonTris + pArgs->ngonTrisCount + 1, pTris, count * 3);
+	pArgs->ngonTrisCount += len;
+}
+
+static
+StucErr triangulateCount(void *pArgsVoid) {
+	StucErr err = PIX_ERR_SUCCESS;
+	TriangulateJobArgs *pArgs = pArgsVoid;
+	const TriangulateShared *pShared = pArgs->core.pShared;
+	const StucAlloc *pAlloc = &pArgs->core.pCtx->alloc;
+	U8 triBuf[(STUC_NGON_MAX_SIZE - 2) * 3];
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		FaceRange face = stucGetFaceRange(pShared->pMesh, i);
+		if (face.size <= 4) {
+			pArgs->triCount += face.size - 2;
+			continue;
+		}
+		PIX_ERR_ASSERT("invalid face size", face.size <= STUC_NGON_MAX_SIZE);
+		I32 count = stucTriangulateFaceFromVerts(pAlloc, &face, pShared->pWrap, triBuf);
+		ngonTrisAppend(pAlloc, pArgs, triBuf, count);
+		pArgs->triCount += count;
+	}
+	return err;
+}
+
+static
+StucErr triangulateFill(void *pArgsVoid) {
+	StucErr err = PIX_ERR_SUCCESS;
+	TriangulateJobArgs *pArgs = pArgsVoid;
+	const TriangulateShared *pShared = pArgs->core.pShared;
+	const StucMesh *pMesh = pShared->pMesh;
+	//attrib arrays are shared, each job only writes to it's own range of tris
+	StucMesh bufMesh = *pShared->pBufMesh;
+	bufMesh.faceCount = pArgs->triStart;
+	bufMesh.cornerCount = pArgs->triStart * 3;
+	I32 ngonTrisIdx = 0;
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		FaceRange face = stucGetFaceRange(pMesh, i);
+		if (face.size == 3) {
+			addTri(&bufMesh, pMesh, &face, (U8[]){0, 1, 2});
+		}
+		else if (face.size == 4) {
+			addTri(&bufMesh, pMesh, &face, (U8[]){0, 1, 2});
+			addTri(&bufMesh, pMesh, &face, (U8[]){2, 3, 0});
+		}
+		else {
+			I32 count = pArgs->pNgonTris[ngonTrisIdx];
+			const U8 *pTris = pArgs->pNgonTris + ngonTrisIdx + 1;
+			for (I32 j = 0; j < count; ++j) {
+				addTri(&bufMesh, pMesh, &face, pTris + j * 3);
+			}
+			ngonTrisIdx += count * 3 + 1;
+		}
+	}
+	PIX_ERR_ASSERT("", bufMesh.faceCount == pArgs->triStart + pArgs->triCount);
+	return err;
+}
+
 StucErr stucMeshTriangulate(StucContext pCtx, StucMesh *pMesh) {
 	StucErr err = PIX_ERR_SUCCESS;
 	PIX_ERR_ASSERT("", pMesh->pFaces && pMesh->pCorners);
@@ -206,8 +306,32 @@ StucErr stucMeshTriangulate(StucContext pCtx, StucMesh *pMesh) {
 	);
 	PIX_ERR_RETURN_IFNOT(err, "");
 
-	I32 triCount = pMesh->cornerCount - pMesh->faceCount * 2;
-	StucMesh bufMesh = {.faceCount = triCount, .cornerCount = triCount * 3};
+	//tris are counted per job first, so each job can fill it's own range in parallel
+	StucMesh bufMesh = {0};
+	TriangulateShared shared = {.pMesh = pMesh, .pWrap = &wrap, .pBufMesh = &bufMesh};
+	I32 jobCount = 0;
+	TriangulateJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+	stucMakeJobArgs(
+		pCtx,
+		&shared,
+		&jobCount, jobArgs, sizeof(TriangulateJobArgs),
+		NULL,
+		triangulateJobsGetRange, NULL
+	);
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, jobArgs, sizeof(TriangulateJobArgs),
+		triangulateCount
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	I32 triCount = 0;
+	for (I32 i = 0; i < jobCount; ++i) {
+		jobArgs[i].triStart = triCount;
+		triCount += jobArgs[i].triCount;
+	}
+
+	bufMesh.faceCount = triCount;
+	bufMesh.cornerCount = triCount * 3;
 	bufMesh.pCorners = pCtx->alloc.fpMalloc(sizeof(I32) * bufMesh.cornerCount);
 	StucDomain domain = STUC_DOMAIN_FACE;
 	err = stucAllocAttribs(pCtx, domain, triCount, &bufMesh, 1, &pMesh, 0, false, true, false, false);
@@ -216,39 +340,28 @@ StucErr stucMeshTriangulate(StucContext pCtx, StucMesh *pMesh) {
 	err = stucAllocAttribs(pCtx, domain, triCount * 3, &bufMesh, 1, &pMesh, 0, false, true, false, false);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
 
-	bufMesh.faceCount = 0;
-	bufMesh.cornerCount = 0;
-	U8 triBuf[STUC_NGON_MAX_SIZE];
-	for (I32 i = 0; i < pMesh->faceCount; ++i) {
-		FaceRange face = stucGetFaceRange(pMesh, i);
-		if (face.size == 3) {
-			addTri(&bufMesh, pMesh, &face, (U8[]){0, 1, 2});
-		}
-		else if (face.size == 4) {
-			addTri(&bufMesh, pMesh, &face, (U8[]){0, 1, 2});
-			addTri(&bufMesh, pMesh, &face, (U8[]){2, 3, 0});
-		}
-		else {
-			PIX_ERR_ASSERT(
-				"invalid face size",
-				face.size > 4 && face.size <= STUC_NGON_MAX_SIZE
-			);
-			I32 count = stucTriangulateFaceFromVerts(&pCtx->alloc, &face, &wrap, triBuf);
-			for (I32 i = 0; i < count; ++i) {
-				addTri(&bufMesh, pMesh, &face, triBuf + i * 3);
-			}
-		}
-	}
-	/*
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, jobArgs, sizeof(TriangulateJobArgs),
+		triangulateFill
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	//the edge list is indexed by corner, so it's invalid once the mesh is triangulated.
+	//Edges and their attribs are dropped
 	if (pMesh->pEdges) {
 		pCtx->alloc.fpFree(pMesh->pEdges);
 		pMesh->pEdges = NULL;
 	}
+	for (I32 i = 0; i < pMesh->edgeAttribs.count; ++i) {
+		if (pMesh->edgeAttribs.pArr[i].core.pData) {
+			pCtx->alloc.fpFree(pMesh->edgeAttribs.pArr[i].core.pData);
+		}
+	}
 	if (pMesh->edgeAttribs.pArr) {
 		pCtx->alloc.fpFree(pMesh->edgeAttribs.pArr);
-		pMesh->edgeAttribs = (AttribArray){0};
 	}
-	*/
+	pMesh->edgeAttribs = (AttribArray){0};
+	pMesh->edgeCount = 0;
 	pCtx->alloc.fpFree(pMesh->pFaces);
 	pCtx->alloc.fpFree(pMesh->pCorners);
 	pCtx->alloc.fpFree(pMesh->faceAttribs.pArr);
@@ -271,6 +384,11 @@ StucErr stucMeshTriangulate(StucContext pCtx, StucMesh *pMesh) {
 			pCtx->alloc.fpFree(bufMesh.cornerAttribs.pArr);
 		}
 	);
+	for (I32 i = 0; i < jobCount; ++i) {
+		if (jobArgs[i].pNgonTris) {
+			pCtx->alloc.fpFree(jobArgs[i].pNgonTris);
+		}
+	}
 	return err;
 }
 
@@ -318,6 +436,8 @@ StucErr initFlatCutoff(
 			.transform = pCutoffObj->transform
 		}
 	);
+	err = stucUsgBvhBuild(&pCtx->alloc, &pUsg->cutoffBvh, pUsg->pFlatCutoff);
+	PIX_ERR_RETURN_IFNOT(err, "");
 	return err;
 }
 
@@ -339,6 +459,7 @@ typedef struct MapDepEntry {
 	char *pPath;
 	bool onStack;
 	bool depsAdded;
+	bool queued;
 } MapDepEntry;
 
 typedef struct MapDepStackEntry {
@@ -475,106 +596,133 @@ StucErr mapDepStackPop(MapDepStack *pStack) {
 }
 
 static
-void destroyMapOptsArr(const StucAlloc *pAlloc, ObjMapOptsArr *pArr) {
+void destroyBakedTarget(StucContext pCtx, BakedTarget *pBaked) {
+	if (pBaked->obj.pData) {
+		stucMeshDestroy(pCtx, (StucMesh *)pBaked->obj.pData);
+		pCtx->alloc.fpFree(pBaked->obj.pData);
+	}
+	stucAttribIndexedArrDestroy(pCtx, &pBaked->idxAttribs);
+	if (pBaked->pDeps) {
+		pCtx->alloc.fpFree(pBaked->pDeps);
+	}
+	*pBaked = (BakedTarget){0};
+}
+
+static
+void destroyMapOptsArr(StucContext pCtx, ObjMapOptsArr *pArr) {
 	for (I32 i = 0; i < pArr->count; ++i) {
 		if (pArr->pArr[i].arr.pArr) {
-			pAlloc->fpFree(pArr->pArr[i].arr.pArr);
+			pCtx->alloc.fpFree(pArr->pArr[i].arr.pArr);
 		}
+		destroyBakedTarget(pCtx, &pArr->pArr[i].baked);
 	}
 	if (pArr->pArr) {
-		pAlloc->fpFree(pArr->pArr);
+		pCtx->alloc.fpFree(pArr->pArr);
 	}
 	*pArr = (ObjMapOptsArr){0};
 }
 
-static
-StucErr stucMapFileLoadIntern(
+//TODO replace these with StucUsg and StucObj arr structs, that combine arr and count
+StucErr stucMapFileLoadForEdit(
 	StucContext pCtx,
-	MapDepEntry *pEntry
+	const char *filePath,
+	I32 *pObjCount,
+	StucObject **ppObjArr,
+	I32 *pUsgCount,
+	StucUsg **ppUsgArr,
+	I32 *pFlatCutoffCount,
+	StucObject **ppFlatCutoffArr,
+	StucAttribIndexedArr *pIndexedAttribs,
+	const StucMapLoadFilter *pFilter
 ) {
-	PixErr err = PIX_ERR_SUCCESS;
-	PIX_ERR_RETURN_IFNOT_COND(err, pEntry->pName, "file name is too long");
-	StucMap pMap = pCtx->alloc.fpCalloc(1, sizeof(MapFile));
-	pMap->pName = pEntry->pName;
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		pCtx && filePath &&
+		pObjCount && ppObjArr &&
+		pUsgCount && ppUsgArr &&
+		pFlatCutoffCount && ppFlatCutoffArr &&
+		pIndexedAttribs,
+		"invalid args"
+	);
 	StucObjArr objArr = {0};
 	StucUsgArr usgArr = {0};
 	StucObjArr cutoffArr = {0};
 	ObjMapOptsArr mapOptsArr = {0};
 	err = stucMapImport(
-		pCtx, pEntry->pPath,
+		pCtx, filePath,
 		&objArr,
 		&mapOptsArr,
 		&usgArr,
 		&cutoffArr,
 		NULL,
-		&pMap->indexedAttribs,
-		true
+		NULL,
+		pIndexedAttribs,
+		true,
+		pFilter,
+		false
 	);
-	PIX_ERR_THROW_IFNOT(err, "failed to load file from disk", 0);
+	PIX_ERR_RETURN_IFNOT(err, "failed to load file from disk");
+	//mapping opts aren't editable yet
+	destroyMapOptsArr(pCtx, &mapOptsArr);
+	*pObjCount = objArr.count;
+	*ppObjArr = objArr.pArr;
+	*pUsgCount = usgArr.count;
+	*ppUsgArr = usgArr.pArr;
+	*pFlatCutoffCount = cutoffArr.count;
+	*ppFlatCutoffArr = cutoffArr.pArr;
+	return err;
+}
 
-	I32 targetIdx = 0;
-	for (I32 i = 0; i < objArr.count; ++i) {
-		Mesh *pMesh = (Mesh *)objArr.pArr[i].pData;
-		
-		err = stucAttemptToSetMissingActiveDomains(&pMesh->core);
-		PIX_ERR_THROW_IFNOT(err, "", 0);
+//deps are loaded before the maps that use them, so their hashes are already set
+static
+U64 getMapDepTreeHash(const MapDepEntry *pEntry) {
+	if (pEntry->timestamp == .0) {
+		return 0;
+	}
+	U64 hash = stucHashData(STUC_HASH_SEED, &pEntry->timestamp, sizeof(pEntry->timestamp));
+	for (I32 i = 0; i < pEntry->deps.count; ++i) {
+		const MapFile *pDep = pEntry->deps.pArr[i]->pMap;
+		if (!pDep || !pDep->depTreeHash) {
+			return 0;
+		}
+		hash = stucHashData(hash, &pDep->depTreeHash, sizeof(pDep->depTreeHash));
+	}
+	return hash ? hash : 1;
+}
 
-		if (targetIdx < mapOptsArr.count &&
-			mapOptsArr.pArr[targetIdx].obj == i
+//a baked target is only valid if none of the maps it was mapped with,
+//or any of their deps, have changed
+static
+bool isBakedTargetCurrent(const MapDepEntry *pEntry, const BakedTarget *pBaked) {
+	if (!pBaked->obj.pData) {
+		return false;
+	}
+	for (I32 i = 0; i < pBaked->depCount; ++i) {
+		I32 map = pBaked->pDeps[i].map;
+		if (map < 0 || map >= pEntry->deps.count) {
+			return false;
+		}
+		const MapFile *pDep = pEntry->deps.pArr[map]->pMap;
+		if (!pDep ||
+			!pDep->depTreeHash ||
+			pDep->depTreeHash != pBaked->pDeps[i].depTreeHash
 		) {
-			StucMapArr *pMapArr = &mapOptsArr.pArr[targetIdx].arr;
-			for (I32 j = 0; j < pMapArr->count; ++j) {
-				StucMapArrEntry *pArrEntry = pMapArr->pArr + j;
-				pArrEntry->map.ptr = pEntry->deps.pArr[pArrEntry->map.idx]->pMap;
-				PIX_ERR_ASSERT("", pMapArr->pArr[j].map.ptr);
-			}
-			StucMesh meshOut = {0};
-			AttribIndexedArr outIdxAttribArr = {0};
-			err = stucMapToMesh(
-				pCtx,
-				pMapArr,
-				&pMesh->core,
-				&pMap->indexedAttribs,
-				&meshOut,
-				&outIdxAttribArr,
-				1.0f,//TODO replace with actual wScale an receiveLen vars
-				-1.0f,
-				false, //TODO should this be true? if not remove option from merge func,
-				false
-			);
-			PIX_ERR_THROW_IFNOT(err, "", 0);
-			//TODO edge list returned from stucMapToMesh is broken, this is a temp fix
-			if (meshOut.pEdges) {
-				pCtx->alloc.fpFree(meshOut.pEdges);
-				meshOut.pEdges = NULL;
-			}
-			err = stucBuildEdgeList(pCtx, &meshOut);
-			PIX_ERR_THROW_IFNOT(err, "", 0);
-			stucAttribIndexedArrDestroy(pCtx, &pMap->indexedAttribs);
-			pMap->indexedAttribs = outIdxAttribArr;
-			stucMeshDestroy(pCtx, &pMesh->core);
-			pMesh->core = meshOut;
-			++targetIdx;
+			return false;
 		}
-		err = stucAssignActiveAliases(
-			pCtx,
-			pMesh,
-			STUC_ATTRIB_USE_FIELD(((StucAttribUse[]) {
-				STUC_ATTRIB_USE_POS,
-				STUC_ATTRIB_USE_UV,
-				STUC_ATTRIB_USE_NORMAL,
-				STUC_ATTRIB_USE_RECEIVE,
-				STUC_ATTRIB_USE_IDX
-			})),
-			STUC_DOMAIN_NONE
-		);
-		PIX_ERR_THROW_IFNOT(err, "", 0);
-		stucApplyObjTransform(objArr.pArr + i);
 	}
+	return true;
+}
+
+//merges the map's objects into a single mesh, and builds the tables used when mapping
+static
+StucErr mapMeshBuild(StucContext pCtx, StucMap pMap, StucObjArr *pObjArr, bool hasUsgs) {
+	StucErr err = PIX_ERR_SUCCESS;
 	Mesh *pMapMesh = pCtx->alloc.fpCalloc(1, sizeof(Mesh));
 	pMapMesh->core.type.type = STUC_OBJECT_DATA_MESH_INTERN;
-	err = stucMergeObjArr(pCtx, pMapMesh, &objArr, false);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
+	err = stucMergeObjArr(pCtx, pMapMesh, pObjArr, false);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	pMap->pMesh = pMapMesh;
 
 	UBitField32 spToAppend = STUC_ATTRIB_USE_FIELD(((StucAttribUse[]) {
 		STUC_ATTRIB_USE_EDGE_LEN
@@ -582,7 +730,7 @@ StucErr stucMapFileLoadIntern(
 	stucAppendSpAttribsToMesh(
 		pCtx,
 		pMapMesh,
-		spToAppend | (usgArr.count ? 0x1 << STUC_ATTRIB_USE_USG : 0x0),
+		spToAppend | (hasUsgs ? 0x1 << STUC_ATTRIB_USE_USG : 0x0),
 		STUC_ATTRIB_ORIGIN_MAP
 	);
 
@@ -618,7 +766,7 @@ StucErr stucMapFileLoadIntern(
 		})),
 		STUC_DOMAIN_NONE
 	);
-	PIX_ERR_THROW_IFNOT(err, "", 0);
+	PIX_ERR_RETURN_IFNOT(err, "");
 	{
 		V3_F32 offset = {.d = {.5f, .5f, .0f}};
 		for (I32 i = 0; i < pMapMesh->core.vertCount; ++i) {
@@ -627,10 +775,7 @@ StucErr stucMapFileLoadIntern(
 	}
 
 	buildEdgeLenList(pCtx, pMapMesh);
-
-	//TODO some form of heap corruption when many objects
-	//test with address sanitizer on CircuitPieces.stuc
-	stucObjArrDestroy(pCtx, &objArr);
+	pMap->edgeLenAvg = stucGetEdgeLenAvg(&pMapMesh->core, pMapMesh->pPos, true);
 
 	//set corner attribs to interpolate by default
 	//TODO make this an option in ui, even for non common attribs
@@ -638,66 +783,245 @@ StucErr stucMapFileLoadIntern(
 		pMapMesh->core.cornerAttribs.pArr[i].interpolate = true;
 	}
 
-	pMap->pMesh = pMapMesh;
-
 	triCacheBuild(&pCtx->alloc, pMap);
 	buildFaceBBoxes(&pCtx->alloc, pMap);
+	pMap->pMesh->uniformFaceSize = stucGetUniformFaceSize(&pMap->pMesh->core);
 
 	//the quadtree is created before USGs are assigned to verts,
 	//as the tree's used to speed up the process
 	printf("File loaded. Creating quad tree\n");
 	err = stucCreateQuadTree(pCtx, &pMap->quadTree, pMap->pMesh, pMap->pFaceBBoxes);
-	PIX_ERR_THROW_IFNOT(err, "failed to create quadtree", 0);
-
-	if (usgArr.count) {
-		pMap->usgArr.count = usgArr.count;
-		pMap->usgArr.pArr = pCtx->alloc.fpCalloc(pMap->usgArr.count, sizeof(Usg));
-		for (I32 i = 0; i < pMap->usgArr.count; ++i) {
-			Mesh *pUsgMesh = (Mesh *)usgArr.pArr[i].obj.pData;
-			err = stucAttemptToSetMissingActiveDomains(&pUsgMesh->core);
-			PIX_ERR_THROW_IFNOT(err, "", 0);
-			err = stucAssignActiveAliases(
-				pCtx,
-				pUsgMesh,
-				0x1 << STUC_ATTRIB_USE_POS,
-				STUC_DOMAIN_NONE
-			);
-			PIX_ERR_THROW_IFNOT(err, "", 0);
-			Usg *pUsg = pMap->usgArr.pArr + i;
-			pUsg->origin = *(V2_F32 *)&usgArr.pArr[i].obj.transform.d[3];
-			pUsg->pMesh = pUsgMesh;
-			stucApplyObjTransform(&usgArr.pArr[i].obj);
-			if (usgArr.pArr[i].flatCutoff.enabled) {
-				//TODO these shouldn't be duplicated for each usg,
-				//store cutoffs in a separate arr
-				I32 cutoffIdx = usgArr.pArr[i].flatCutoff.idx;
-				initFlatCutoff(pCtx, pUsg, cutoffArr.pArr + cutoffIdx);
-			}
-		}
-		Mesh *pSquares = pCtx->alloc.fpCalloc(1, sizeof(Mesh));
-		stucAllocUsgSquaresMesh(pCtx, pMap, pSquares);
-		stucFillUsgSquaresMesh(pMap, usgArr.pArr, pSquares);
-		pMap->usgArr.pSquares = pSquares;
-		stucAssignUsgsToVerts(&pCtx->alloc, pMap, usgArr.pArr);
-		pMap->usgArr.pMemArr = usgArr.pArr;
-	}
-
-	pEntry->pMap = pMap;
-	PIX_ERR_CATCH(0, err, stucMapFileUnload(pCtx, pMap);)
-	destroyMapOptsArr(&pCtx->alloc, &mapOptsArr);
+	PIX_ERR_RETURN_IFNOT(err, "failed to create quadtree");
+	return err;
+}
 
+static
+StucErr mapObjAliasAndXform(StucContext pCtx, StucObject *pObj) {
+	StucErr err = PIX_ERR_SUCCESS;
+	Mesh *pMesh = (Mesh *)pObj->pData;
+	err = stucAssignActiveAliases(
+		pCtx,
+		pMesh,
+		STUC_ATTRIB_USE_FIELD(((StucAttribUse[]) {
+			STUC_ATTRIB_USE_POS,
+			STUC_ATTRIB_USE_UV,
+			STUC_ATTRIB_USE_NORMAL,
+			STUC_ATTRIB_USE_RECEIVE,
+			STUC_ATTRIB_USE_IDX
+		})),
+		STUC_DOMAIN_NONE
+	);
+	PIX_ERR_RETURN_IFNOT(err, "");
+	stucApplyObjTransform(pObj);
 	return err;
 }
 
-typedef struct StucMapLoadIntern {
-	StucContext pCtx;
-	const char *pFilepath;
-	F64 timestamp;
-	void *pUserData;
-	PixErr (* fpMapGet)(void *, const char *, char **, double *, StucMap * const);
-	PixErr (* fpMapStore)(
-		void *,
-		const char *,
+//each level is the map with every object swapped for its coarsest lod at or below
+//that level. Levels where no object has a lod are skipped
+static
+StucErr mapLodsBuild(
+	StucContext pCtx,
+	StucMap pMap,
+	const StucObjArr *pObjArr,
+	MapLodArr *pLodArr
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	I32 levelMax = 0;
+	for (I32 i = 0; i < pLodArr->count; ++i) {
+		StucObject *pObj = &pLodArr->pArr[i].obj;
+		err = stucAttemptToSetMissingActiveDomains(&((Mesh *)pObj->pData)->core);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		err = mapObjAliasAndXform(pCtx, pObj);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		levelMax = PIXM_MAX(levelMax, pLodArr->pArr[i].level);
+	}
+	if (!levelMax) {
+		return err;
+	}
+	pMap->pLods = pCtx->alloc.fpCalloc(levelMax, sizeof(MapFile));
+	StucObjArr levelObjArr = {.size = pObjArr->count, .count = pObjArr->count};
+	levelObjArr.pArr = pCtx->alloc.fpMalloc(levelObjArr.size * sizeof(StucObject));
+	memcpy(levelObjArr.pArr, pObjArr->pArr, levelObjArr.size * sizeof(StucObject));
+	for (I32 i = 1; i <= levelMax; ++i) {
+		bool changed = false;
+		for (I32 j = 0; j < pLodArr->count; ++j) {
+			const MapLod *pLod = pLodArr->pArr + j;
+			if (pLod->level == i) {
+				levelObjArr.pArr[pLod->objIdx] = pLod->obj;
+				changed = true;
+			}
+		}
+		if (!changed) {
+			continue;
+		}
+		MapFile *pLevel = pMap->pLods + pMap->lodCount;
+		++pMap->lodCount;
+		pLevel->pName = pMap->pName;
+		pLevel->timestamp = pMap->timestamp;
+		pLevel->depTreeHash = pMap->depTreeHash;
+		err = mapMeshBuild(pCtx, pLevel, &levelObjArr, false);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	PIX_ERR_CATCH(0, err, ;);
+	//objects are borrowed from pObjArr and pLodArr
+	pCtx->alloc.fpFree(levelObjArr.pArr);
+	return err;
+}
+
+static
+StucErr stucMapFileLoadIntern(
+	StucContext pCtx,
+	MapDepEntry *pEntry
+) {
+	PixErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, pEntry->pName, "file name is too long");
+	StucMap pMap = pCtx->alloc.fpCalloc(1, sizeof(MapFile));
+	pMap->pName = pEntry->pName;
+	//kept so targets baked against this map can be validated
+	pMap->timestamp = pEntry->timestamp;
+	pMap->depTreeHash = getMapDepTreeHash(pEntry);
+	StucObjArr objArr = {0};
+	StucUsgArr usgArr = {0};
+	StucObjArr cutoffArr = {0};
+	ObjMapOptsArr mapOptsArr = {0};
+	MapLodArr lodArr = {0};
+	err = stucMapImport(
+		pCtx, pEntry->pPath,
+		&objArr,
+		&mapOptsArr,
+		&usgArr,
+		&cutoffArr,
+		&lodArr,
+		NULL,
+		&pMap->indexedAttribs,
+		true,
+		NULL,
+		true //loads run as pool jobs (see loadQueuedMaps)
+	);
+	PIX_ERR_THROW_IFNOT(err, "failed to load file from disk", 0);
+
+	I32 targetIdx = 0;
+	for (I32 i = 0; i < objArr.count; ++i) {
+		Mesh *pMesh = (Mesh *)objArr.pArr[i].pData;
+		
+		err = stucAttemptToSetMissingActiveDomains(&pMesh->core);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+
+		if (targetIdx < mapOptsArr.count &&
+			mapOptsArr.pArr[targetIdx].obj == i &&
+			isBakedTargetCurrent(pEntry, &mapOptsArr.pArr[targetIdx].baked)
+		) {
+			BakedTarget *pBaked = &mapOptsArr.pArr[targetIdx].baked;
+			stucAttribIndexedArrDestroy(pCtx, &pMap->indexedAttribs);
+			pMap->indexedAttribs = pBaked->idxAttribs;
+			pBaked->idxAttribs = (StucAttribIndexedArr){0};
+			stucMeshDestroy(pCtx, &pMesh->core);
+			pMesh->core = *(StucMesh *)pBaked->obj.pData;
+			*(StucMesh *)pBaked->obj.pData = (StucMesh){0};
+			err = stucAttemptToSetMissingActiveDomains(&pMesh->core);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+			++targetIdx;
+		}
+		else if (targetIdx < mapOptsArr.count &&
+			mapOptsArr.pArr[targetIdx].obj == i
+		) {
+			StucMapArr *pMapArr = &mapOptsArr.pArr[targetIdx].arr;
+			for (I32 j = 0; j < pMapArr->count; ++j) {
+				StucMapArrEntry *pArrEntry = pMapArr->pArr + j;
+				pArrEntry->map.ptr = pEntry->deps.pArr[pArrEntry->map.idx]->pMap;
+				PIX_ERR_ASSERT("", pMapArr->pArr[j].map.ptr);
+			}
+			StucMesh meshOut = {0};
+			AttribIndexedArr outIdxAttribArr = {0};
+			err = stucMapToMesh(
+				pCtx,
+				pMapArr,
+				&pMesh->core,
+				&pMap->indexedAttribs,
+				&meshOut,
+				&outIdxAttribArr,
+				1.0f,//TODO replace with actual wScale an receiveLen vars
+				-1.0f,
+				false, //TODO should this be true? if not remove option from merge func,
+				false,
+				NULL,
+				NULL
+			);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+			stucAttribIndexedArrDestroy(pCtx, &pMap->indexedAttribs);
+			pMap->indexedAttribs = outIdxAttribArr;
+			stucMeshDestroy(pCtx, &pMesh->core);
+			pMesh->core = meshOut;
+			++targetIdx;
+		}
+		err = mapObjAliasAndXform(pCtx, objArr.pArr + i);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	err = mapMeshBuild(pCtx, pMap, &objArr, usgArr.count);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	//lods aren't built for maps with usgs, as usg squares are only mapped at full res
+	if (!usgArr.count && lodArr.count) {
+		err = mapLodsBuild(pCtx, pMap, &objArr, &lodArr);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	//TODO some form of heap corruption when many objects
+	//test with address sanitizer on CircuitPieces.stuc
+	stucObjArrDestroy(pCtx, &objArr);
+
+	if (usgArr.count) {
+		pMap->usgArr.count = usgArr.count;
+		pMap->usgArr.pArr = pCtx->alloc.fpCalloc(pMap->usgArr.count, sizeof(Usg));
+		for (I32 i = 0; i < pMap->usgArr.count; ++i) {
+			Mesh *pUsgMesh = (Mesh *)usgArr.pArr[i].obj.pData;
+			err = stucAttemptToSetMissingActiveDomains(&pUsgMesh->core);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+			err = stucAssignActiveAliases(
+				pCtx,
+				pUsgMesh,
+				0x1 << STUC_ATTRIB_USE_POS,
+				STUC_DOMAIN_NONE
+			);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+			Usg *pUsg = pMap->usgArr.pArr + i;
+			pUsg->origin = *(V2_F32 *)&usgArr.pArr[i].obj.transform.d[3];
+			pUsg->pMesh = pUsgMesh;
+			stucApplyObjTransform(&usgArr.pArr[i].obj);
+			//built after the transform is applied, as bounds are in map space
+			err = stucUsgBvhBuild(&pCtx->alloc, &pUsg->bvh, pUsgMesh);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+			if (usgArr.pArr[i].flatCutoff.enabled) {
+				//TODO these shouldn't be duplicated for each usg,
+				//store cutoffs in a separate arr
+				I32 cutoffIdx = usgArr.pArr[i].flatCutoff.idx;
+				err = initFlatCutoff(pCtx, pUsg, cutoffArr.pArr + cutoffIdx);
+				PIX_ERR_THROW_IFNOT(err, "", 0);
+			}
+		}
+		Mesh *pSquares = pCtx->alloc.fpCalloc(1, sizeof(Mesh));
+		stucAllocUsgSquaresMesh(pCtx, pMap, pSquares);
+		stucFillUsgSquaresMesh(pMap, usgArr.pArr, pSquares);
+		pMap->usgArr.pSquares = pSquares;
+		stucAssignUsgsToVerts(&pCtx->alloc, pMap, usgArr.pArr);
+		pMap->usgArr.pMemArr = usgArr.pArr;
+	}
+
+	pEntry->pMap = pMap;
+	PIX_ERR_CATCH(0, err, stucMapFileUnload(pCtx, pMap);)
+	destroyMapOptsArr(pCtx, &mapOptsArr);
+	stucMapLodArrDestroy(pCtx, &lodArr);
+
+	return err;
+}
+
+typedef struct StucMapLoadIntern {
+	StucContext pCtx;
+	const char *pFilepath;
+	F64 timestamp;
+	void *pUserData;
+	PixErr (* fpMapGet)(void *, const char *, char **, double *, StucMap * const);
+	PixErr (* fpMapStore)(
+		void *,
+		const char *,
 		const char *,
 		double,
 		StucMap,
@@ -809,40 +1133,134 @@ StucErr stucMapLoadDestroy(StucMapLoad *pState) {
 	return PIX_ERR_SUCCESS;
 }
 
+//fpMapStore is only called from the calling thread
 static
-StucErr finaliseMapLoad(StucMapLoad *pState, MapDepStack *pStack, PixtyStrArr *pDepBuf) {
+StucErr storeMapLoad(StucMapLoad *pState, MapDepEntry *pEntry, PixtyStrArr *pDepBuf) {
 	StucErr err = PIX_ERR_SUCCESS;
-	MapDepStackEntry *pStackEntry = pStack->stack + pStack->ptr;
-	if (pStackEntry->pMap->status != STUC_MAP_PENDING_LOAD) {
-		PIX_ERR_ASSERT("", pStackEntry->pMap->status == STUC_MAP_MISSING_DEP);
-	}
-	else if (stucMapFileLoadIntern(pState->pCtx, pStackEntry->pMap) == PIX_ERR_SUCCESS) {
-		pStackEntry->pMap->status = STUC_MAP_LOADED;
-	}
-	else {
-		pStackEntry->pMap->status = STUC_MAP_ERROR;
-	}
-	I32 depCount = pStackEntry->pMap->deps.count;
+	I32 depCount = pEntry->deps.count;
 	if (depCount) {
 		PIXALC_DYN_ARR_RESIZE(void *, &pState->pCtx->alloc, pDepBuf, depCount);
 		for (I32 i = 0; i < depCount; ++i) {
-			pDepBuf->pArr[i].pStr = pStackEntry->pMap->deps.pArr[i]->pName;
+			pDepBuf->pArr[i].pStr = pEntry->deps.pArr[i]->pName;
 		}
 	}
 	pDepBuf->count = depCount;
 	err = pState->fpMapStore(
 		pState->pUserData,
-		pStackEntry->pMap->pName,
-		pStackEntry->pMap->pPath,
-		pStackEntry->pMap->timestamp,
-		pStackEntry->pMap->pMap,
-		pStackEntry->pMap->status,
+		pEntry->pName,
+		pEntry->pPath,
+		pEntry->timestamp,
+		pEntry->pMap,
+		pEntry->status,
 		pDepBuf
 	);
 	PIX_ERR_RETURN_IFNOT(err, "");
 	return err;
 }
 
+typedef struct MapLoadShared {
+	MapDepEntry **ppWave;
+	I32 count;
+} MapLoadShared;
+
+typedef struct MapLoadJobArgs {
+	JobArgs core;
+} MapLoadJobArgs;
+
+static
+I32 mapLoadJobsGetRange(StucContext pCtx, const void *pShared, void *pInitInfo) {
+	return ((const MapLoadShared *)pShared)->count;
+}
+
+static
+StucErr mapLoadJob(void *pArgsVoid) {
+	MapLoadJobArgs *pArgs = pArgsVoid;
+	const MapLoadShared *pShared = pArgs->core.pShared;
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		MapDepEntry *pEntry = pShared->ppWave[i];
+		//a map failing to load isn't an error here, it's reported through it's status
+		pEntry->status = stucMapFileLoadIntern(pArgs->core.pCtx, pEntry) == PIX_ERR_SUCCESS ?
+			STUC_MAP_LOADED : STUC_MAP_ERROR;
+	}
+	return PIX_ERR_SUCCESS;
+}
+
+//false if any deps are yet to be loaded
+static
+bool isMapReadyToLoad(const MapDepEntry *pEntry, bool *pMissingDep) {
+	*pMissingDep = false;
+	for (I32 i = 0; i < pEntry->deps.count; ++i) {
+		StucMapStatus status = pEntry->deps.pArr[i]->status;
+		if (status == STUC_MAP_PENDING_LOAD) {
+			return false;
+		}
+		if (status != STUC_MAP_LOADED) {
+			*pMissingDep = true;
+		}
+	}
+	return true;
+}
+
+//maps are loaded in waves. Each wave is every queued map whose deps are all loaded,
+//and its maps are loaded in parallel
+static
+StucErr loadQueuedMaps(StucMapLoad *pState, MapDepPtrArr *pQueue, PixtyStrArr *pDepBuf) {
+	StucErr err = PIX_ERR_SUCCESS;
+	StucContext pCtx = pState->pCtx;
+	if (!pQueue->count) {
+		return err;
+	}
+	MapLoadShared shared = {
+		.ppWave = pCtx->alloc.fpMalloc(pQueue->count * sizeof(MapDepEntry *))
+	};
+	I32 remaining = pQueue->count;
+	while (remaining) {
+		shared.count = 0;
+		I32 removed = 0;
+		for (I32 i = 0; i < pQueue->count; ++i) {
+			MapDepEntry *pEntry = pQueue->pArr[i];
+			bool missingDep = false;
+			if (!pEntry || !isMapReadyToLoad(pEntry, &missingDep)) {
+				continue;
+			}
+			pQueue->pArr[i] = NULL;
+			++removed;
+			if (missingDep) {
+				pEntry->status = STUC_MAP_MISSING_DEP;
+				err = storeMapLoad(pState, pEntry, pDepBuf);
+				PIX_ERR_THROW_IFNOT(err, "", 0);
+				continue;
+			}
+			shared.ppWave[shared.count] = pEntry;
+			++shared.count;
+		}
+		PIX_ERR_THROW_IFNOT_COND(err, removed, "circular map dependency", 0);
+		remaining -= removed;
+		I32 jobCount = shared.count; //max jobs
+		MapLoadJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+		stucMakeJobArgs(
+			pCtx,
+			&shared,
+			&jobCount, jobArgs, sizeof(MapLoadJobArgs),
+			NULL,
+			mapLoadJobsGetRange, NULL
+		);
+		err = stucDoJobInParallel(
+			pCtx,
+			jobCount, jobArgs, sizeof(MapLoadJobArgs),
+			mapLoadJob
+		);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+		for (I32 i = 0; i < shared.count; ++i) {
+			err = storeMapLoad(pState, shared.ppWave[i], pDepBuf);
+			PIX_ERR_THROW_IFNOT(err, "", 0);
+		}
+	}
+	PIX_ERR_CATCH(0, err, ;);
+	pCtx->alloc.fpFree(shared.ppWave);
+	return err;
+}
+
 static
 StucErr handleDeps(StucMapLoad *pState, MapDepStack *pStack) {
 	StucErr err = PIX_ERR_SUCCESS;
@@ -882,6 +1300,7 @@ StucErr walkMapDeps(StucMapLoad *pState) {
 	StucContext pCtx = pState->pCtx;
 
 	PixtyStrArr depBuf = {0};
+	MapDepPtrArr loadQueue = {0};
 	MapDepStack stack = {0};
 	addMapDepEntry(&pCtx->alloc, &pState->table, pState->pFilepath, &stack.stack[0].pMap);
 	stack.stack[0].pMap->timestamp = pState->timestamp;
@@ -895,7 +1314,10 @@ StucErr walkMapDeps(StucMapLoad *pState) {
 			err = getMapOrPath(pState, &stack);
 			PIX_ERR_THROW_IFNOT(err, "", 0);
 		}
-		if (pStackEntry->pMap->status == STUC_MAP_PENDING_LOAD) {
+		//queued maps have already been walked, through another map that depends on them
+		if (pStackEntry->pMap->status == STUC_MAP_PENDING_LOAD &&
+			!pStackEntry->pMap->queued
+		) {
 			err = handleDeps(pState, &stack);
 			PIX_ERR_THROW_IFNOT(err, "", 0);
 			PIX_ERR_ASSERT("", pStackEntry->depIdx <= pStackEntry->pMap->deps.count);
@@ -908,13 +1330,18 @@ StucErr walkMapDeps(StucMapLoad *pState) {
 				continue;
 			}
 			if (pState->depsPassDone) {
-				err = finaliseMapLoad(pState, &stack, &depBuf);
-				PIX_ERR_THROW_IFNOT(err, "", 0);
+				//maps are queued in post-order, so deps always come first
+				I32 idx = 0;
+				PIXALC_DYN_ARR_ADD(void *, &pCtx->alloc, &loadQueue, idx);
+				loadQueue.pArr[idx] = pStackEntry->pMap;
+				pStackEntry->pMap->queued = true;
 			}
 		}
 		err = mapDepStackPop(&stack);
 		PIX_ERR_THROW_IFNOT(err, "", 0);
 	} while(++i, stack.ptr >= 0);
+	err = loadQueuedMaps(pState, &loadQueue, &depBuf);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
 	PIX_ERR_THROW_IFNOT_COND(
 	err,
 	!pState->depsPassDone || stack.stack[0].pMap->status == STUC_MAP_LOADED,
@@ -924,6 +1351,9 @@ StucErr walkMapDeps(StucMapLoad *pState) {
 	if (depBuf.pArr) {
 		pState->pCtx->alloc.fpFree(depBuf.pArr);
 	}
+	if (loadQueue.pArr) {
+		pState->pCtx->alloc.fpFree(loadQueue.pArr);
+	}
 	return err;
 }
 
@@ -972,7 +1402,9 @@ StucErr stucMapFileLoad(StucMapLoad *pState) {
 	return err;
 }
 
-StucErr stucMapFileUnload(StucContext pCtx, StucMap pMap) {
+//frees what's built by mapMeshBuild
+static
+void mapMeshDestroy(StucContext pCtx, StucMap pMap) {
 	stucDestroyQuadTree(pCtx, &pMap->quadTree);
 	if (pMap->pMesh) {
 		stucMeshDestroy(pCtx, (StucMesh *)&pMap->pMesh->core);
@@ -982,9 +1414,23 @@ StucErr stucMapFileUnload(StucContext pCtx, StucMap pMap) {
 	if (pMap->pFaceBBoxes) {
 		pCtx->alloc.fpFree(pMap->pFaceBBoxes);
 	}
+}
+
+StucErr stucMapFileUnload(StucContext pCtx, StucMap pMap) {
+	mapMeshDestroy(pCtx, pMap);
+	for (I32 i = 0; i < pMap->lodCount; ++i) {
+		mapMeshDestroy(pCtx, pMap->pLods + i);
+	}
+	if (pMap->pLods) {
+		pCtx->alloc.fpFree(pMap->pLods);
+	}
 	if (pMap->usgArr.pSquares) {
 		pCtx->alloc.fpFree((Mesh *)pMap->usgArr.pSquares);
 	}
+	for (I32 i = 0; i < pMap->usgArr.count; ++i) {
+		stucUsgBvhDestroy(&pCtx->alloc, &pMap->usgArr.pArr[i].bvh);
+		stucUsgBvhDestroy(&pCtx->alloc, &pMap->usgArr.pArr[i].cutoffBvh);
+	}
 	pCtx->alloc.fpFree(pMap);
 	return PIX_ERR_SUCCESS;
 }
@@ -1204,6 +1650,38 @@ bool checkIfNoFacesHaveMaskIdx(const Mesh *pMesh, I8 maskIdx) {
 	return true;
 }
 
+//the tangent & bitangent of the in-mesh tbn are only used to xform map normals
+//(which are in tangent space), and when sampling usg tbns
+//(pInFaceTable is set during the usg squares pass)
+static
+bool mapToMeshNeedsTbn(StucContext pCtx, const StucMap pMap, const InFaceTable *pInFaceTable) {
+	return
+		pInFaceTable ||
+		stucGetActiveAttribConst(pCtx, &pMap->pMesh->core, STUC_ATTRIB_USE_NORMAL);
+}
+
+static
+void destroyEncasedTables(
+	StucContext pCtx,
+	I32 jobCount,
+	FindEncasedFacesJobArgs *pJobArgs
+) {
+	for (I32 i = 0; i < jobCount; ++i) {
+		PixalcLinAlloc *pEncasedAlloc =
+			pixuctHTableAllocGet(&pJobArgs[i].encasedFaces, 0);
+		PixalcLinAllocIter iter = {0};
+		pixalcLinAllocIterInit(pEncasedAlloc, (Range) {0, INT32_MAX}, &iter);
+		for (; !pixalcLinAllocIterAtEnd(&iter); pixalcLinAllocIterInc(&iter)) {
+			EncasedMapFace *pEntry = pixalcLinAllocGetItem(&iter);
+			if (pEntry->inFaces.pArr) {
+				pCtx->alloc.fpFree(pEntry->inFaces.pArr);
+				pEntry->inFaces.pArr = NULL;
+			}
+		}
+		pixuctHTableDestroy(&pJobArgs[i].encasedFaces);
+	}
+}
+
 static
 StucErr mapToMeshInternal(
 	StucContext pCtx,
@@ -1214,7 +1692,8 @@ StucErr mapToMeshInternal(
 	const StucBlendOptArr *pOptArr,
 	InFaceTable *pInFaceTable,
 	F32 wScale,
-	F32 receiveLen
+	F32 receiveLen,
+	const JobCancel *pCancel
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	if (checkIfNoFacesHaveMaskIdx(pMeshIn, maskIdx)) {
@@ -1229,6 +1708,8 @@ StucErr mapToMeshInternal(
 		.receiveLen = receiveLen,
 		.maskIdx = maskIdx,
 		.pInFaceTable = pInFaceTable,
+		.inFaceSize = pMeshIn->uniformFaceSize,
+		.pCancel = pCancel
 	};
 	//printf("A\n");
 	if (pInFaceTable) {
@@ -1250,7 +1731,10 @@ StucErr mapToMeshInternal(
 		&findEncasedJobCount, findEncasedJobArgs,
 		&empty
 	);
-	PIX_ERR_RETURN_IFNOT(err, "");
+	if (err != PIX_ERR_SUCCESS) {
+		destroyEncasedTables(pCtx, findEncasedJobCount, findEncasedJobArgs);
+		PIX_ERR_RETURN(err, "");
+	}
 	//printf("B\n");
 	if (!empty) {
 		BufMeshArr bufMeshes = {0};
@@ -1268,27 +1752,18 @@ StucErr mapToMeshInternal(
 			&inPiecesSplit, &inPiecesSplitClip,
 			&splitAlloc
 		);
-		for (I32 i = 0; i < findEncasedJobCount; ++i) {
-			PixalcLinAlloc *pEncasedAlloc =
-				pixuctHTableAllocGet(&findEncasedJobArgs[i].encasedFaces, 0);
-			PixalcLinAllocIter iter = {0};
-			pixalcLinAllocIterInit(pEncasedAlloc, (Range) {0, INT32_MAX}, &iter);
-			for (; !pixalcLinAllocIterAtEnd(&iter); pixalcLinAllocIterInc(&iter)) {
-				EncasedMapFace *pEntry = pixalcLinAllocGetItem(&iter);
-				if (pEntry->inFaces.pArr) {
-					basic.pCtx->alloc.fpFree(pEntry->inFaces.pArr);
-					pEntry->inFaces.pArr = NULL;
-				}
-			}
-			pixuctHTableDestroy(&findEncasedJobArgs[i].encasedFaces);
-		}
-		PIX_ERR_RETURN_IFNOT(err, "");
+		destroyEncasedTables(pCtx, findEncasedJobCount, findEncasedJobArgs);
+		PIX_ERR_THROW_IFNOT(err, "", 1);
+		err = stucJobCancelCheck(pCancel);
+		PIX_ERR_THROW_IFNOT(err, "", 1);
 		//printf("C\n");
 		
 		err = stucInPieceArrInitBufMeshes(&basic, &inPiecesSplitClip, stucClipMapFace);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		PIX_ERR_THROW_IFNOT(err, "", 1);
 		err = stucInPieceArrInitBufMeshes(&basic, &inPiecesSplit, stucAddMapFaceToBufMesh);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		PIX_ERR_THROW_IFNOT(err, "", 1);
+		err = stucJobCancelCheck(pCancel);
+		PIX_ERR_THROW_IFNOT(err, "", 1);
 		//printf("D\n");
 
 		PixuctHTable mergeTable = {0};
@@ -1304,7 +1779,9 @@ StucErr mapToMeshInternal(
 			&mergeTable,
 			&snappedVerts
 		);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		PIX_ERR_THROW_IFNOT(err, "", 2);
+		err = stucJobCancelCheck(pCancel);
+		PIX_ERR_THROW_IFNOT(err, "", 2);
 		//printf("F\n");
 
 		stucInitOutMesh(&basic, &mergeTable, snappedVerts);
@@ -1313,10 +1790,13 @@ StucErr mapToMeshInternal(
 		bufOutTable.size =
 			inPiecesSplit.pBufMeshes->count + inPiecesSplitClip.pBufMeshes->count;
 		bufOutTable.pArr = pCtx->alloc.fpCalloc(bufOutTable.size, sizeof(BufOutRange));
+		PixuctHTable edgeTable = {0};
+		stucOutEdgeTableInit(&basic, &edgeTable);
 		stucAddFacesAndCornersToOutMesh(
 			&basic,
 			&inPiecesSplit,
 			&mergeTable,
+			&edgeTable,
 			&outBufIdxArr,
 			&bufOutTable,
 			false
@@ -1325,30 +1805,39 @@ StucErr mapToMeshInternal(
 			&basic,
 			&inPiecesSplitClip,
 			&mergeTable,
+			&edgeTable,
 			&outBufIdxArr,
 			&bufOutTable,
 			true
 		);
+		pixuctHTableDestroy(&edgeTable);
 		if (!basic.outMesh.core.faceCount) {
 			goto cleanUp;
 		}
 		stucMeshSetLastFace(pCtx, &basic.outMesh);
+		err = stucJobCancelCheck(pCancel);
+		PIX_ERR_THROW_IFNOT(err, "", 2);
 		//printf("G\n");
 
-		err = stucBuildTangentsForInPieces(
-			pCtx,
-			pMeshIn,
-			&inPiecesSplit, &inPiecesSplitClip,
-			&mergeTable
-		);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		basic.needsTbn = mapToMeshNeedsTbn(pCtx, pMap, pInFaceTable);
+		if (basic.needsTbn) {
+			err = stucBuildTangentsForInPieces(
+				pCtx,
+				pMeshIn,
+				&inPiecesSplit, &inPiecesSplitClip,
+				&mergeTable
+			);
+			PIX_ERR_THROW_IFNOT(err, "", 2);
+		}
+		err = stucJobCancelCheck(pCancel);
+		PIX_ERR_THROW_IFNOT(err, "", 2);
 		//printf("H\n");
 		
 		err = stucXFormAndInterpVerts(&basic, &inPiecesSplit, &inPiecesSplitClip, &mergeTable, 0);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		PIX_ERR_THROW_IFNOT(err, "", 2);
 		//intersect verts
 		err = stucXFormAndInterpVerts(&basic, &inPiecesSplit, &inPiecesSplitClip, &mergeTable, 1);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		PIX_ERR_THROW_IFNOT(err, "", 2);
 		err = stucInterpAttribs(
 			&basic,
 			&inPiecesSplit, &inPiecesSplitClip,
@@ -1357,7 +1846,7 @@ StucErr mapToMeshInternal(
 			&outBufIdxArr,
 			STUC_DOMAIN_FACE, stucInterpFaceAttribs
 		);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		PIX_ERR_THROW_IFNOT(err, "", 2);
 		//vert merge lin-idx is replaced with out-vert idx in corner-interp job,
 		// so faces must be interpolated before corners
 		err = stucInterpAttribs(
@@ -1368,12 +1857,16 @@ StucErr mapToMeshInternal(
 			&outBufIdxArr,
 			STUC_DOMAIN_CORNER, stucInterpCornerAttribs
 		);
-		PIX_ERR_RETURN_IFNOT(err, "");
+		PIX_ERR_THROW_IFNOT(err, "", 2);
 		//printf("I\n");
 
 		stucReallocMeshToFit(pCtx, &basic.outMesh);
 		*pOutMesh = basic.outMesh.core;
 		//printf("J\n");
+		//on error or cancellation, the partially built out-mesh is discarded
+		PIX_ERR_CATCH(2, err,
+			stucMeshDestroy(pCtx, &basic.outMesh.core);
+		);
 	cleanUp:
 		if (outBufIdxArr.pArr) {
 			pCtx->alloc.fpFree(outBufIdxArr.pArr);
@@ -1381,6 +1874,10 @@ StucErr mapToMeshInternal(
 		if (bufOutTable.pArr) {
 			pCtx->alloc.fpFree(bufOutTable.pArr);
 		}
+		pixuctHTableDestroy(&mergeTable);
+		//jumps to here are made before the merge table is initialized
+		PIX_ERR_CATCH(1, err, ;);
+		inPieceArrDestroy(pCtx, &inPieceArr);
 		for (I32 i = 0; i < splitAlloc.count; ++i) {
 			if (splitAlloc.pArr[i].encased.valid) {
 				pixalcLinAllocDestroy(&splitAlloc.pArr[i].encased);
@@ -1392,7 +1889,6 @@ StucErr mapToMeshInternal(
 				pixalcLinAllocDestroy(&splitAlloc.pArr[i].border);
 			}
 		}
-		pixuctHTableDestroy(&mergeTable);
 		inPieceArrDestroy(pCtx, &inPiecesSplit);
 		inPieceArrDestroy(pCtx, &inPiecesSplitClip);
 		stucBufMeshArrDestroy(pCtx, &bufMeshes);
@@ -1822,6 +2318,8 @@ typedef struct StucMapToMeshArgs {
 	F32 wScale;
 	F32 receiveLen;
 	bool triangulate;
+	const StucRoi *pRoi;
+	StucCancelToken *pCancel;
 } StucMapToMeshArgs;
 
 static
@@ -1837,7 +2335,9 @@ StucErr mapToMeshFromJob(void *pArgsVoid) {
 		pArgs->wScale,
 		pArgs->receiveLen,
 		false,
-		pArgs->triangulate
+		pArgs->triangulate,
+		pArgs->pRoi,
+		pArgs->pCancel
 	);
 }
 
@@ -1851,7 +2351,9 @@ StucErr stucQueueMapToMesh(
 	StucAttribIndexedArr *pOutIndexedAttribs,
 	F32 wScale,
 	F32 receiveLen,
-	bool triangulate
+	bool triangulate,
+	const StucRoi *pRoi,
+	StucCancelToken *pCancel
 ) {
 	StucMapToMeshArgs *pArgs = pCtx->alloc.fpCalloc(1, sizeof(StucMapToMeshArgs));
 	pArgs->pCtx = pCtx;
@@ -1863,6 +2365,8 @@ StucErr stucQueueMapToMesh(
 	pArgs->wScale = wScale;
 	pArgs->receiveLen = receiveLen;
 	pArgs->triangulate = triangulate;
+	pArgs->pRoi = pRoi;
+	pArgs->pCancel = pCancel;
 	pCtx->threadPool.pJobStackPushJobs(
 		pCtx->pThreadPoolHandle,
 		1,
@@ -1873,17 +2377,139 @@ StucErr stucQueueMapToMesh(
 	return PIX_ERR_SUCCESS;
 }
 
+//world units per uv unit, from the ratio of the face's areas
 static
-StucErr mapMapArrToMesh(
+F32 getInFaceUvToWorldScale(const Mesh *pMesh, const FaceRange *pFace) {
+	F32 uvArea = .0f;
+	F32 worldArea = .0f;
+	V2_F32 uvA = stucGetUvPos(pMesh, pFace, 0);
+	V3_F32 posA = stucGetVertPos(pMesh, pFace, 0);
+	for (I32 i = 1; i < pFace->size - 1; ++i) {
+		V2_F32 uvB = stucGetUvPos(pMesh, pFace, i);
+		V2_F32 uvC = stucGetUvPos(pMesh, pFace, i + 1);
+		uvB = _(uvB V2SUB uvA);
+		uvC = _(uvC V2SUB uvA);
+		uvArea += uvB.d[0] * uvC.d[1] - uvB.d[1] * uvC.d[0];
+		V3_F32 posB = stucGetVertPos(pMesh, pFace, i);
+		V3_F32 posC = stucGetVertPos(pMesh, pFace, i + 1);
+		posB = _(posB V3SUB posA);
+		posC = _(posC V3SUB posA);
+		worldArea += pixmV3F32Len(_(posB V3CROSS posC));
+	}
+	//both areas are doubled, which cancels out
+	uvArea = fabsf(uvArea);
+	return uvArea > FLT_EPSILON ? sqrtf(worldArea / uvArea) : .0f;
+}
+
+//0 is the full res map, and 1 onward are its lods
+static
+I32 getInFaceLod(const StucMap pMap, F32 scale, F32 lodEdgeLen) {
+	for (I32 i = 0; i < pMap->lodCount; ++i) {
+		const MapFile *pLevel = i ? pMap->pLods + i - 1 : pMap;
+		if (pLevel->edgeLenAvg * scale >= lodEdgeLen) {
+			return i;
+		}
+	}
+	return pMap->lodCount;
+}
+
+//in-faces are split by level with the roi mask, and each level's mapped separately
+static
+StucErr mapToMeshLods(
 	StucContext pCtx,
-	const StucMapArr *pMapArr,
+	const StucMap pMap,
+	Mesh *pMeshIn,
+	Mesh *pOut,
+	I8 maskIdx,
+	const StucBlendOptArr *pOptArr,
+	F32 wScale,
+	F32 receiveLen,
+	F32 lodEdgeLen,
+	const JobCancel *pCancel
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	I32 levelCount = pMap->lodCount + 1;
+	I32 faceCount = pMeshIn->core.faceCount;
+	I8 *pFaceLevels = pCtx->alloc.fpMalloc(faceCount);
+	for (I32 i = 0; i < faceCount; ++i) {
+		if (!stucIsFaceInRoi(pMeshIn, i)) {
+			pFaceLevels[i] = -1;
+			continue;
+		}
+		FaceRange face = stucGetFaceRange(&pMeshIn->core, i);
+		F32 scale = getInFaceUvToWorldScale(pMeshIn, &face);
+		pFaceLevels[i] = (I8)getInFaceLod(pMap, scale, lodEdgeLen);
+	}
+	U8 *pRoiMask = pMeshIn->pRoiMask;
+	I32 byteCount = (faceCount + 7) / 8;
+	pMeshIn->pRoiMask = pCtx->alloc.fpMalloc(byteCount);
+	Mesh *pLevelOut = pCtx->alloc.fpCalloc(levelCount, sizeof(Mesh));
+	StucObjArr levelObjArr = {.size = levelCount};
+	levelObjArr.pArr = pCtx->alloc.fpCalloc(levelObjArr.size, sizeof(StucObject));
+	for (I32 i = 0; i < levelCount; ++i) {
+		memset(pMeshIn->pRoiMask, 0, byteCount);
+		bool empty = true;
+		for (I32 j = 0; j < faceCount; ++j) {
+			if (pFaceLevels[j] == i) {
+				pMeshIn->pRoiMask[j >> 3] |= 1 << (j & 7);
+				empty = false;
+			}
+		}
+		if (empty) {
+			continue;
+		}
+		err = mapToMeshInternal(
+			pCtx,
+			i ? pMap->pLods + i - 1 : pMap,
+			pMeshIn,
+			&pLevelOut[i].core,
+			maskIdx,
+			pOptArr,
+			NULL,
+			wScale,
+			receiveLen,
+			pCancel
+		);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+		if (pLevelOut[i].core.faceCount) {
+			levelObjArr.pArr[levelObjArr.count].pData = (StucObjectData *)&pLevelOut[i];
+			++levelObjArr.count;
+		}
+	}
+	if (levelObjArr.count == 1) {
+		StucMesh *pLevelMesh = (StucMesh *)levelObjArr.pArr[0].pData;
+		pOut->core = *pLevelMesh;
+		*pLevelMesh = (StucMesh){0};
+	}
+	else if (levelObjArr.count) {
+		pOut->core.type = ((StucMesh *)levelObjArr.pArr[0].pData)->type;
+		err = stucMergeObjArr(pCtx, pOut, &levelObjArr, false);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	PIX_ERR_CATCH(0, err, ;);
+	for (I32 i = 0; i < levelCount; ++i) {
+		stucMeshDestroy(pCtx, &pLevelOut[i].core);
+	}
+	pCtx->alloc.fpFree(pLevelOut);
+	pCtx->alloc.fpFree(levelObjArr.pArr);
+	pCtx->alloc.fpFree(pFaceLevels);
+	pCtx->alloc.fpFree(pMeshIn->pRoiMask);
+	pMeshIn->pRoiMask = pRoiMask;
+	return err;
+}
+
+static
+StucErr mapMapArrToMesh(
+	StucContext pCtx,
+	const StucMapArr *pMapArr,
 	Mesh *pMeshIn,
 	const StucAttribIndexedArr *pInIndexedAttribs,
 	StucMesh *pMeshOut,
 	StucAttribIndexedArr *pOutIndexedAttribs,
 	F32 wScale,
 	F32 receiveLen,
-	bool keepExistingIdxAttribs
+	bool keepExistingIdxAttribs,
+	const JobCancel *pCancel
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	Mesh *pOutBufArr = pCtx->alloc.fpCalloc(pMapArr->count, sizeof(Mesh));
@@ -1892,6 +2518,8 @@ StucErr mapMapArrToMesh(
 	outObjWrapArr.pArr = pCtx->alloc.fpCalloc(outObjWrapArr.size, sizeof(StucObject));
 	for (I32 i = 0; i < pMapArr->count; ++i) {
 		outObjWrapArr.pArr[i].pData = (StucObjectData *)&pOutBufArr[i];
+		err = stucJobCancelCheck(pCancel);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
 		const StucMap pMap = pMapArr->pArr[i].map.ptr;
 		I8 matIdx = pMapArr->pArr[i].matIdx;
 		InFaceTable inFaceTable = {0};
@@ -1920,7 +2548,8 @@ StucErr mapMapArrToMesh(
 				pMapArr->pArr[i].blendOptArr,
 				&inFaceTable,
 				1.0f,
-				-1.0f
+				-1.0f,
+				pCancel
 			);
 			PIX_ERR_THROW_IFNOT(err, "map to mesh usg failed", 1);
 			err = stucSampleInAttribsAtUsgOrigins(
@@ -1943,17 +2572,34 @@ StucErr mapMapArrToMesh(
 				STUC_DOMAIN_NONE
 			);
 		}
-		err = mapToMeshInternal(
-			pCtx,
-			pMap,
-			pMeshIn,
-			&pOutBufArr[i].core,
-			matIdx,
-			pMapArr->pArr[i].blendOptArr,
-			NULL,
-			wScale,
-			receiveLen
-		);
+		if (pMapArr->pArr[i].lodEdgeLen > .0f && pMap->lodCount && !pMap->usgArr.count) {
+			err = mapToMeshLods(
+				pCtx,
+				pMap,
+				pMeshIn,
+				pOutBufArr + i,
+				matIdx,
+				pMapArr->pArr[i].blendOptArr,
+				wScale,
+				receiveLen,
+				pMapArr->pArr[i].lodEdgeLen,
+				pCancel
+			);
+		}
+		else {
+			err = mapToMeshInternal(
+				pCtx,
+				pMap,
+				pMeshIn,
+				&pOutBufArr[i].core,
+				matIdx,
+				pMapArr->pArr[i].blendOptArr,
+				NULL,
+				wScale,
+				receiveLen,
+				pCancel
+			);
+		}
 		PIX_ERR_THROW_IFNOT(err, "map to mesh failed", 1);
 		PIX_ERR_CATCH(1, err, ;);
 		if (pMap->usgArr.count) {
@@ -1990,71 +2636,29 @@ StucErr mapMapArrToMesh(
 	return err;
 }
 
+//on a cache hit, the cached sp attribs are aliased rather than allocated
 static
 StucErr appendSpAttribsToInMesh(
 	const StucContext pCtx,
 	Mesh *pWrap,
 	const StucMesh *pMeshIn,
-	UBitField32 flags
+	UBitField32 flags,
+	const InMeshCacheEntry *pCached
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
-	UBitField32 has = 0;
-	stucQuerySpAttribs(pCtx, pMeshIn, flags, &has);
-	if (has) {
-		PIX_ERR_RETURN(err, "in-mesh contains attribs it shouldn't");
+	UBitField32 cachedFlags = pCached ? stucInMeshCacheSpAttribFlags() : 0;
+	stucMeshViewInit(pCtx, pWrap, pMeshIn, flags & ~cachedFlags, STUC_ATTRIB_ORIGIN_MESH_IN);
+	if (pCached) {
+		stucInMeshCacheAppendSpAttribs(pCtx, pWrap, pCached);
 	}
-	Mesh meshInCpy = {.core = *pMeshIn};
-	const Mesh *const pMeshInCpyPtr = &meshInCpy;
-	stucAllocAttribsFromMeshArr(
-		pCtx,
-		pWrap,
-		1, &pMeshInCpyPtr,
-		0,
-		false,
-		false, //dont allocate data
-		true, //alias pMeshIn's data instead
-		false
-	);
-	stucAppendSpAttribsToMesh(
-		pCtx,
-		pWrap,
-		flags, 
-		STUC_ATTRIB_ORIGIN_MESH_IN
-	);
 	return err;
 }
 
-static
-void destroyAppendedSpAttribs(StucContext pCtx, StucMesh *pMesh, UBitField32 flags) {
-	for (I32 i = 1; i < STUC_ATTRIB_USE_SP_ENUM_COUNT; ++i) {
-		if (!(flags >> i & 0x1)) {
-			continue;
-		}
-		Attrib *pAttrib = stucGetActiveAttrib(pCtx, pMesh, i);
-		if (pAttrib) {
-			if (pAttrib->core.pData) {
-				pCtx->alloc.fpFree(pAttrib->core.pData);
-				pAttrib->core.pData = NULL;
-			}
-		}
-	}
-	if (pMesh->faceAttribs.pArr) {
-		pCtx->alloc.fpFree(pMesh->faceAttribs.pArr);
-		pMesh->faceAttribs.pArr = NULL;
-	}
-	if (pMesh->cornerAttribs.pArr) {
-		pCtx->alloc.fpFree(pMesh->cornerAttribs.pArr);
-		pMesh->cornerAttribs.pArr = NULL;
-	}
-	if (pMesh->edgeAttribs.pArr) {
-		pCtx->alloc.fpFree(pMesh->edgeAttribs.pArr);
-		pMesh->edgeAttribs.pArr = NULL;
-	}
-	if (pMesh->vertAttribs.pArr) {
-		pCtx->alloc.fpFree(pMesh->vertAttribs.pArr);
-		pMesh->vertAttribs.pArr = NULL;
-	}
-}
+typedef struct InMeshCacheState {
+	StucMesh meshIn; //in-mesh the hash was taken from, with active domains set
+	U64 hash;
+	InMeshCacheEntry *pEntry; //set on a hit
+} InMeshCacheState;
 
 static
 StucErr initMeshInWrap(
@@ -2062,7 +2666,8 @@ StucErr initMeshInWrap(
 	Mesh *pWrap,
 	StucMesh meshIn, //passed by value so we can set active attrib domains if missing
 	UBitField32 spAttribsToAppend,
-	bool *pBuildEdges
+	bool *pBuildEdges,
+	InMeshCacheState *pCacheState
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	err = stucAttemptToSetMissingActiveDomains(&meshIn);
@@ -2070,17 +2675,36 @@ StucErr initMeshInWrap(
 	stucAliasMeshCoreNoAttribs(&pWrap->core, &meshIn);
 	*pBuildEdges = !meshIn.edgeCount;
 	if (*pBuildEdges) {
-		printf("no edge list found, building one\n");
 		PIX_ERR_RETURN_IFNOT_COND(
 			err,
 			!meshIn.edgeAttribs.count,
 			"in-mesh has edge attribs, yet no edge list"
 		);
-		err = stucBuildEdgeList(pCtx, &pWrap->core);
-		PIX_ERR_RETURN_IFNOT(err, "failed to build edge list");
-		printf("finished building edge list\n");
 	}
-	err = appendSpAttribsToInMesh(pCtx, pWrap, &meshIn, spAttribsToAppend);
+	UBitField32 has = 0;
+	stucQuerySpAttribs(pCtx, &meshIn, spAttribsToAppend, &has);
+	if (has) {
+		PIX_ERR_RETURN(err, "in-mesh contains attribs it shouldn't");
+	}
+	if (pCtx->pInMeshCache) {
+		pCacheState->meshIn = meshIn;
+		pCacheState->hash = stucInMeshHash(pCtx, &meshIn);
+		pCacheState->pEntry = stucInMeshCacheAcquire(pCtx, pCacheState->hash, &meshIn);
+	}
+	const InMeshCacheEntry *pCached = pCacheState->pEntry;
+	if (*pBuildEdges) {
+		if (pCached) {
+			pWrap->core.pEdges = pCached->pEdges;
+			pWrap->core.edgeCount = pCached->edgeCount;
+		}
+		else {
+			printf("no edge list found, building one\n");
+			err = stucBuildEdgeList(pCtx, &pWrap->core);
+			PIX_ERR_RETURN_IFNOT(err, "failed to build edge list");
+			printf("finished building edge list\n");
+		}
+	}
+	err = appendSpAttribsToInMesh(pCtx, pWrap, &meshIn, spAttribsToAppend, pCached);
 	PIX_ERR_RETURN_IFNOT(err, "");
 	stucSetAttribOrigins(&pWrap->core.meshAttribs, STUC_ATTRIB_ORIGIN_MESH_IN);
 	stucSetAttribOrigins(&pWrap->core.faceAttribs, STUC_ATTRIB_ORIGIN_MESH_IN);
@@ -2100,8 +2724,10 @@ StucErr initMeshInWrap(
 	);
 	PIX_ERR_RETURN_IFNOT(err, "");
 
-	buildEdgeAdj(pWrap);
-	buildSeamAndPreserveTables(pWrap);
+	if (!pCached) {
+		buildEdgeAdj(pWrap);
+		buildSeamAndPreserveTables(pWrap);
+	}
 
 	//set sp
 	stucSetAttribCopyOpt(
@@ -2129,7 +2755,127 @@ StucErr initMeshInWrap(
 	return err;
 }
 
-StucErr stucMapToMesh(
+static
+bool isRangeOverlapping(F32 aMin, F32 aMax, F32 bMin, F32 bMax) {
+	return aMin <= bMax && bMin <= aMax;
+}
+
+static
+bool isFaceInRoiBounds(const Mesh *pMesh, FaceRange face, const StucRoi *pRoi) {
+	if (pRoi->type == STUC_ROI_WORLD_BOUNDS) {
+		V3_F32 min = pMesh->pPos[pMesh->core.pCorners[face.start]];
+		V3_F32 max = min;
+		for (I32 i = 1; i < face.size; ++i) {
+			V3_F32 pos = pMesh->pPos[pMesh->core.pCorners[face.start + i]];
+			for (I32 j = 0; j < 3; ++j) {
+				min.d[j] = PIXM_MIN(min.d[j], pos.d[j]);
+				max.d[j] = PIXM_MAX(max.d[j], pos.d[j]);
+			}
+		}
+		return
+			isRangeOverlapping(min.d[0], max.d[0], pRoi->worldMin.d[0], pRoi->worldMax.d[0]) &&
+			isRangeOverlapping(min.d[1], max.d[1], pRoi->worldMin.d[1], pRoi->worldMax.d[1]) &&
+			isRangeOverlapping(min.d[2], max.d[2], pRoi->worldMin.d[2], pRoi->worldMax.d[2]);
+	}
+	BBox bbox = {.min = pMesh->pUvs[face.start], .max = pMesh->pUvs[face.start]};
+	for (I32 i = 1; i < face.size; ++i) {
+		V2_F32 uv = pMesh->pUvs[face.start + i];
+		for (I32 j = 0; j < 2; ++j) {
+			bbox.min.d[j] = PIXM_MIN(bbox.min.d[j], uv.d[j]);
+			bbox.max.d[j] = PIXM_MAX(bbox.max.d[j], uv.d[j]);
+		}
+	}
+	for (I32 i = 0; i < pRoi->uvRectCount; ++i) {
+		const StucRoiRect *pRect = pRoi->pUvRects + i;
+		if (isRangeOverlapping(bbox.min.d[0], bbox.max.d[0], pRect->min.d[0], pRect->max.d[0]) &&
+			isRangeOverlapping(bbox.min.d[1], bbox.max.d[1], pRect->min.d[1], pRect->max.d[1])
+		) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//in-face range covered by a single roi.
+//Batched in-meshes are mapped as one, so each has it's own range
+typedef struct RoiRange {
+	const StucRoi *pRoi;
+	I32 faceStart;
+	I32 faceEnd;
+} RoiRange;
+
+static
+StucErr validateRoi(const StucRoi *pRoi) {
+	StucErr err = PIX_ERR_SUCCESS;
+	switch (pRoi->type) {
+		case STUC_ROI_NONE:
+			break;
+		case STUC_ROI_FACES:
+			PIX_ERR_RETURN_IFNOT_COND(err, pRoi->pFaceMask, "roi face mask is NULL");
+			break;
+		case STUC_ROI_UV_RECTS:
+			PIX_ERR_RETURN_IFNOT_COND(
+				err,
+				pRoi->pUvRects || !pRoi->uvRectCount,
+				"roi uv rect arr is NULL"
+			);
+			break;
+		case STUC_ROI_WORLD_BOUNDS:
+			break;
+		default:
+			PIX_ERR_RETURN(err, "invalid roi type");
+	}
+	return err;
+}
+
+//resolves the rois into a per-face bitmask on the in-mesh wrap,
+//which is then checked alongside the mat mask when finding encasing cells.
+//Ranges without a roi are set in full
+static
+StucErr initRoiMask(
+	StucContext pCtx,
+	Mesh *pMesh,
+	I32 rangeCount,
+	const RoiRange *pRanges
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	bool hasRoi = false;
+	for (I32 i = 0; i < rangeCount; ++i) {
+		const StucRoi *pRoi = pRanges[i].pRoi;
+		if (pRoi) {
+			err = validateRoi(pRoi);
+			PIX_ERR_RETURN_IFNOT(err, "");
+			hasRoi |= pRoi->type != STUC_ROI_NONE;
+		}
+	}
+	if (!hasRoi) {
+		return err;
+	}
+	I32 byteCount = (pMesh->core.faceCount + 7) / 8;
+	pMesh->pRoiMask = pCtx->alloc.fpCalloc(byteCount, 1);
+	for (I32 i = 0; i < rangeCount; ++i) {
+		const RoiRange *pRange = pRanges + i;
+		const StucRoi *pRoi = pRange->pRoi;
+		for (I32 j = pRange->faceStart; j < pRange->faceEnd; ++j) {
+			bool in = true;
+			if (pRoi && pRoi->type == STUC_ROI_FACES) {
+				I32 local = j - pRange->faceStart;
+				in = pRoi->pFaceMask[local >> 3] >> (local & 7) & 0x1;
+			}
+			else if (pRoi && pRoi->type != STUC_ROI_NONE) {
+				FaceRange face = stucGetFaceRange(&pMesh->core, j);
+				in = isFaceInRoiBounds(pMesh, face, pRoi);
+			}
+			if (in) {
+				pMesh->pRoiMask[j >> 3] |= 1 << (j & 7);
+			}
+		}
+	}
+	return err;
+}
+
+static
+StucErr mapToMesh(
 	StucContext pCtx,
 	const StucMapArr *pMapArr,
 	const StucMesh *pMeshIn,
@@ -2139,7 +2885,10 @@ StucErr stucMapToMesh(
 	F32 wScale,
 	F32 receiveLen,
 	bool keepExistingIdxAttribs,
-	bool triangulate
+	bool triangulate,
+	I32 roiCount,
+	const RoiRange *pRois,
+	const JobCancel *pCancel
 ) {
 	StucErr err = PIX_ERR_SUCCESS;
 	PIX_ERR_RETURN_IFNOT_COND(err, pMeshIn, "");
@@ -2156,14 +2905,21 @@ StucErr stucMapToMesh(
 		STUC_ATTRIB_USE_EDGE_CORNERS
 	}));
 	bool builtEdges = false;
+	InMeshCacheState cacheState = {0};
 	err = initMeshInWrap(
 		pCtx,
 		&meshInWrap,
 		*(StucMesh *)pMeshIn,
 		spAttribsToAppend,
-		&builtEdges
+		&builtEdges,
+		&cacheState
 	);
 	PIX_ERR_THROW_IFNOT(err, "", 0);
+	//in-faces are limited to tris & quads, if they're all one or the other,
+	//fixed size variants of hot funcs are used
+	meshInWrap.uniformFaceSize = stucGetUniformFaceSize(&meshInWrap.core);
+	err = initRoiMask(pCtx, &meshInWrap, roiCount, pRois);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
 
 	PIX_ERR_THROW_IFNOT_COND(
 		err,
@@ -2180,7 +2936,8 @@ StucErr stucMapToMesh(
 		pOutIndexedAttribs,
 		wScale,
 		receiveLen,
-		keepExistingIdxAttribs
+		keepExistingIdxAttribs,
+		pCancel
 	);
 	PIX_ERR_THROW_IFNOT(err, "mapMapArrToMesh returned error", 0);
 	if (triangulate) {
@@ -2188,13 +2945,517 @@ StucErr stucMapToMesh(
 		PIX_ERR_THROW_IFNOT(err, "", 0);
 	}
 	PIX_ERR_CATCH(0, err, ;);
+	//cached tables are detached from the wrap, so they aren't freed below
+	if (cacheState.pEntry) {
+		stucInMeshCacheRelease(pCtx, cacheState.pEntry, &meshInWrap.core, builtEdges);
+	}
+	else if (pCtx->pInMeshCache && err == PIX_ERR_SUCCESS) {
+		stucInMeshCacheStore(
+			pCtx,
+			cacheState.hash,
+			&cacheState.meshIn,
+			&meshInWrap.core,
+			builtEdges
+		);
+	}
 	if (builtEdges && meshInWrap.core.pEdges) {
 		if (meshInWrap.core.pEdges) {
 			pCtx->alloc.fpFree(meshInWrap.core.pEdges);
 			meshInWrap.core.pEdges = NULL;
 		}
 	}
-	destroyAppendedSpAttribs(pCtx, &meshInWrap.core, spAttribsToAppend);
+	if (meshInWrap.pRoiMask) {
+		pCtx->alloc.fpFree(meshInWrap.pRoiMask);
+		meshInWrap.pRoiMask = NULL;
+	}
+	stucMeshViewDestroy(pCtx, &meshInWrap, spAttribsToAppend);
+	return err;
+}
+
+StucErr stucMapToMesh(
+	StucContext pCtx,
+	const StucMapArr *pMapArr,
+	const StucMesh *pMeshIn,
+	const StucAttribIndexedArr *pInIndexedAttribs,
+	StucMesh *pMeshOut,
+	StucAttribIndexedArr *pOutIndexedAttribs,
+	F32 wScale,
+	F32 receiveLen,
+	bool keepExistingIdxAttribs,
+	bool triangulate,
+	const StucRoi *pRoi,
+	StucCancelToken *pCancel
+) {
+	JobCancel cancel = {0};
+	stucJobCancelInit(&cancel, pCancel);
+	RoiRange roi = {
+		.pRoi = pRoi,
+		.faceEnd = pMeshIn ? pMeshIn->faceCount : 0
+	};
+	return mapToMesh(
+		pCtx,
+		pMapArr,
+		pMeshIn,
+		pInIndexedAttribs,
+		pMeshOut,
+		pOutIndexedAttribs,
+		wScale,
+		receiveLen,
+		keepExistingIdxAttribs,
+		triangulate,
+		1, &roi,
+		&cancel
+	);
+}
+
+//faces of a merged batch in-mesh are tagged with the idx of their entry.
+//It's carried over to the out-mesh like any other in-face attrib
+static const char batchEntryAttribName[STUC_ATTRIB_NAME_MAX_LEN] = "StucBatchEntry";
+
+static
+bool cmpAttribLayout(const AttribArray *pA, const AttribArray *pB) {
+	if (pA->count != pB->count) {
+		return false;
+	}
+	for (I32 i = 0; i < pA->count; ++i) {
+		const AttribCore *pACore = &pA->pArr[i].core;
+		const AttribCore *pBCore = &pB->pArr[i].core;
+		if (pACore->type != pBCore->type ||
+			pACore->use != pBCore->use ||
+			strncmp(pACore->name, pBCore->name, STUC_ATTRIB_NAME_MAX_LEN)
+		) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static
+bool cmpActiveAttribs(const StucMesh *pA, const StucMesh *pB) {
+	for (I32 i = 0; i < STUC_ATTRIB_USE_ENUM_COUNT; ++i) {
+		const StucAttribActive *pAActive = pA->activeAttribs + i;
+		const StucAttribActive *pBActive = pB->activeAttribs + i;
+		if (pAActive->active != pBActive->active) {
+			return false;
+		}
+		if (pAActive->active &&
+			(pAActive->domain != pBActive->domain || pAActive->idx != pBActive->idx)
+		) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//entries are only merged if their in-meshes share an attrib layout,
+//and they share the same indexed attribs
+static
+bool isBatchEntryCompatible(
+	const StucMapToMeshBatchEntry *pA,
+	const StucMapToMeshBatchEntry *pB
+) {
+	const StucMesh *pAMesh = pA->pMeshIn;
+	const StucMesh *pBMesh = pB->pMeshIn;
+	return
+		pA->pInIndexedAttribs == pB->pInIndexedAttribs &&
+		pA->keepExistingIdxAttribs == pB->keepExistingIdxAttribs &&
+		!pAMesh->meshAttribs.count && !pBMesh->meshAttribs.count &&
+		!pAMesh->edgeCount == !pBMesh->edgeCount &&
+		cmpActiveAttribs(pAMesh, pBMesh) &&
+		cmpAttribLayout(&pAMesh->faceAttribs, &pBMesh->faceAttribs) &&
+		cmpAttribLayout(&pAMesh->cornerAttribs, &pBMesh->cornerAttribs) &&
+		cmpAttribLayout(&pAMesh->edgeAttribs, &pBMesh->edgeAttribs) &&
+		cmpAttribLayout(&pAMesh->vertAttribs, &pBMesh->vertAttribs) &&
+		!stucGetAttribInternConst(
+			batchEntryAttribName,
+			&pBMesh->faceAttribs,
+			false,
+			NULL, NULL, NULL
+		);
+}
+
+static
+StucErr batchMergeInMeshes(
+	StucContext pCtx,
+	I32 entryCount,
+	const StucMapToMeshBatchEntry *pEntries,
+	Mesh *pMerged,
+	RoiRange *pRois
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	MeshCounts totalCount = {0};
+	for (I32 i = 0; i < entryCount; ++i) {
+		const StucMesh *pMesh = pEntries[i].pMeshIn;
+		err = stucValidateMesh(&pCtx->alloc, pMesh, false, false);
+		PIX_ERR_RETURN_IFNOT(err, "invalid in-mesh");
+		pRois[i] = (RoiRange){
+			.pRoi = pEntries[i].pRoi,
+			.faceStart = totalCount.faces,
+			.faceEnd = totalCount.faces + pMesh->faceCount
+		};
+		totalCount.faces += pMesh->faceCount;
+		totalCount.corners += pMesh->cornerCount;
+		totalCount.edges += pMesh->edgeCount;
+		totalCount.verts += pMesh->vertCount;
+	}
+	pMerged->core.type.type = STUC_OBJECT_DATA_MESH;
+	pMerged->faceBufSize = totalCount.faces + 1; //+1 for last face index
+	pMerged->cornerBufSize = totalCount.corners;
+	pMerged->edgeBufSize = totalCount.edges;
+	pMerged->vertBufSize = totalCount.verts;
+	pMerged->core.pFaces = pCtx->alloc.fpMalloc(sizeof(I32) * pMerged->faceBufSize);
+	pMerged->core.pCorners = pCtx->alloc.fpMalloc(sizeof(I32) * pMerged->cornerBufSize);
+	if (totalCount.edges) {
+		pMerged->core.pEdges = pCtx->alloc.fpMalloc(sizeof(I32) * pMerged->cornerBufSize);
+	}
+	//entries share a layout, so the first is used as the template
+	Mesh srcWrap = {.core = *pEntries[0].pMeshIn};
+	err = stucAttemptToSetMissingActiveDomains(&srcWrap.core);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	const Mesh *pSrcWrap = &srcWrap;
+	err = stucAllocAttribsFromMeshArr(
+		pCtx,
+		pMerged,
+		1,
+		&pSrcWrap,
+		-1,
+		false, true, false, false
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	for (I32 i = 0; i < entryCount; ++i) {
+		err = stucCopyMesh(pCtx, &pMerged->core, pEntries[i].pMeshIn);
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	Attrib *pEntryAttrib = NULL;
+	stucAppendAttrib(
+		&pCtx->alloc,
+		&pMerged->core.faceAttribs,
+		&pEntryAttrib,
+		batchEntryAttribName,
+		pMerged->faceBufSize,
+		false,
+		STUC_ATTRIB_ORIGIN_MESH_IN,
+		STUC_ATTRIB_COPY,
+		STUC_ATTRIB_I32,
+		STUC_ATTRIB_USE_NONE
+	);
+	for (I32 i = 0; i < entryCount; ++i) {
+		for (I32 j = pRois[i].faceStart; j < pRois[i].faceEnd; ++j) {
+			*stucAttribAsI32(&pEntryAttrib->core, j) = i;
+		}
+	}
+	PIX_ERR_CATCH(0, err,
+		stucMeshDestroy(pCtx, &pMerged->core);
+		*pMerged = (Mesh){0};
+	);
+	return err;
+}
+
+//removes an attrib from the arr without freeing it's data
+static
+void detachAttrib(StucMesh *pMesh, StucDomain domain, I32 idx) {
+	AttribArray *pArr = stucGetAttribArrFromDomain(pMesh, domain);
+	for (I32 i = idx; i < pArr->count - 1; ++i) {
+		pArr->pArr[i] = pArr->pArr[i + 1];
+	}
+	pArr->count--;
+	for (I32 i = 0; i < STUC_ATTRIB_USE_ENUM_COUNT; ++i) {
+		StucAttribActive *pActive = pMesh->activeAttribs + i;
+		if (pActive->active && pActive->domain == domain && pActive->idx > idx) {
+			pActive->idx--;
+		}
+	}
+}
+
+static
+void destroyBatchOutMeshes(
+	StucContext pCtx,
+	I32 entryCount,
+	const StucMapToMeshBatchEntry *pEntries
+) {
+	for (I32 i = 0; i < entryCount; ++i) {
+		stucMeshDestroy(pCtx, pEntries[i].pMeshOut);
+		*pEntries[i].pMeshOut = (StucMesh){0};
+	}
+}
+
+//splits the out-mesh of a merged batch into an out-mesh per entry.
+//In-meshes don't share verts or edges, so neither do out-faces from different entries
+static
+StucErr batchSplitOutMesh(
+	StucContext pCtx,
+	StucMesh *pMerged,
+	I32 entryCount,
+	const StucMapToMeshBatchEntry *pEntries
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	for (I32 i = 0; i < entryCount; ++i) {
+		*pEntries[i].pMeshOut = (StucMesh){0};
+	}
+	I32 attribIdx = -1;
+	stucGetAttribIntern(
+		batchEntryAttribName,
+		&pMerged->faceAttribs,
+		false,
+		NULL, NULL,
+		&attribIdx
+	);
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		attribIdx != -1 || !pMerged->faceCount,
+		"batch entry attrib missing from out-mesh"
+	);
+	I32 *pFaceEntries = NULL;
+	if (attribIdx != -1) {
+		//detached so the split meshes don't inherit it
+		pFaceEntries = pMerged->faceAttribs.pArr[attribIdx].core.pData;
+		detachAttrib(pMerged, STUC_DOMAIN_FACE, attribIdx);
+	}
+	MeshCounts *pCounts = pCtx->alloc.fpCalloc(entryCount, sizeof(MeshCounts));
+	I32 *pVertTable = pCtx->alloc.fpMalloc(PIXM_MAX(pMerged->vertCount, 1) * sizeof(I32));
+	I32 *pVertEntries = pCtx->alloc.fpMalloc(PIXM_MAX(pMerged->vertCount, 1) * sizeof(I32));
+	memset(pVertTable, -1, pMerged->vertCount * sizeof(I32));
+	I32 *pEdgeTable = NULL;
+	I32 *pEdgeEntries = NULL;
+	if (pMerged->pEdges) {
+		pEdgeTable = pCtx->alloc.fpMalloc(PIXM_MAX(pMerged->edgeCount, 1) * sizeof(I32));
+		pEdgeEntries = pCtx->alloc.fpMalloc(PIXM_MAX(pMerged->edgeCount, 1) * sizeof(I32));
+		memset(pEdgeTable, -1, pMerged->edgeCount * sizeof(I32));
+	}
+	for (I32 i = 0; i < pMerged->faceCount; ++i) {
+		I32 entry = pFaceEntries[i];
+		PIX_ERR_THROW_IFNOT_COND(err, entry >= 0 && entry < entryCount, "", 0);
+		MeshCounts *pCount = pCounts + entry;
+		FaceRange face = stucGetFaceRange(pMerged, i);
+		pCount->faces++;
+		pCount->corners += face.size;
+		for (I32 j = face.start; j < face.end; ++j) {
+			I32 vert = pMerged->pCorners[j];
+			if (pVertTable[vert] == -1) {
+				pVertTable[vert] = pCount->verts++;
+				pVertEntries[vert] = entry;
+			}
+			if (pEdgeTable && pEdgeTable[pMerged->pEdges[j]] == -1) {
+				pEdgeTable[pMerged->pEdges[j]] = pCount->edges++;
+				pEdgeEntries[pMerged->pEdges[j]] = entry;
+			}
+		}
+	}
+	Mesh mergedWrap = {.core = *pMerged};
+	const Mesh *pMergedWrap = &mergedWrap;
+	for (I32 i = 0; i < entryCount; ++i) {
+		Mesh wrap = {
+			.core.type.type = STUC_OBJECT_DATA_MESH,
+			.faceBufSize = pCounts[i].faces + 1,
+			.cornerBufSize = pCounts[i].corners,
+			.edgeBufSize = pCounts[i].edges,
+			.vertBufSize = pCounts[i].verts
+		};
+		wrap.core.pFaces = pCtx->alloc.fpMalloc(sizeof(I32) * wrap.faceBufSize);
+		if (wrap.cornerBufSize) {
+			wrap.core.pCorners = pCtx->alloc.fpMalloc(sizeof(I32) * wrap.cornerBufSize);
+			if (pEdgeTable) {
+				wrap.core.pEdges = pCtx->alloc.fpMalloc(sizeof(I32) * wrap.cornerBufSize);
+			}
+		}
+		*pEntries[i].pMeshOut = wrap.core;
+		err = stucAllocAttribsFromMeshArr(
+			pCtx,
+			&wrap,
+			1,
+			&pMergedWrap,
+			-1,
+			false, true, false, false
+		);
+		*pEntries[i].pMeshOut = wrap.core;
+		PIX_ERR_THROW_IFNOT(err, "", 0);
+	}
+	for (I32 i = 0; i < pMerged->faceCount; ++i) {
+		StucMesh *pOut = pEntries[pFaceEntries[i]].pMeshOut;
+		FaceRange face = stucGetFaceRange(pMerged, i);
+		I32 outFace = pOut->faceCount++;
+		pOut->pFaces[outFace] = pOut->cornerCount;
+		stucCopyAllAttribs(&pOut->faceAttribs, outFace, &pMerged->faceAttribs, i, false);
+		for (I32 j = face.start; j < face.end; ++j) {
+			I32 outCorner = pOut->cornerCount++;
+			pOut->pCorners[outCorner] = pVertTable[pMerged->pCorners[j]];
+			if (pEdgeTable) {
+				pOut->pEdges[outCorner] = pEdgeTable[pMerged->pEdges[j]];
+			}
+			stucCopyAllAttribs(
+				&pOut->cornerAttribs, outCorner,
+				&pMerged->cornerAttribs, j,
+				false
+			);
+		}
+	}
+	for (I32 i = 0; i < pMerged->vertCount; ++i) {
+		if (pVertTable[i] == -1) {
+			continue;
+		}
+		StucMesh *pOut = pEntries[pVertEntries[i]].pMeshOut;
+		stucCopyAllAttribs(&pOut->vertAttribs, pVertTable[i], &pMerged->vertAttribs, i, false);
+	}
+	for (I32 i = 0; pEdgeTable && i < pMerged->edgeCount; ++i) {
+		if (pEdgeTable[i] == -1) {
+			continue;
+		}
+		StucMesh *pOut = pEntries[pEdgeEntries[i]].pMeshOut;
+		stucCopyAllAttribs(&pOut->edgeAttribs, pEdgeTable[i], &pMerged->edgeAttribs, i, false);
+	}
+	for (I32 i = 0; i < entryCount; ++i) {
+		StucMesh *pOut = pEntries[i].pMeshOut;
+		pOut->pFaces[pOut->faceCount] = pOut->cornerCount;
+		pOut->edgeCount = pCounts[i].edges;
+		pOut->vertCount = pCounts[i].verts;
+	}
+	PIX_ERR_CATCH(0, err,
+		destroyBatchOutMeshes(pCtx, entryCount, pEntries);
+	);
+	if (pFaceEntries) {
+		pCtx->alloc.fpFree(pFaceEntries);
+	}
+	pCtx->alloc.fpFree(pCounts);
+	pCtx->alloc.fpFree(pVertTable);
+	pCtx->alloc.fpFree(pVertEntries);
+	if (pEdgeTable) {
+		pCtx->alloc.fpFree(pEdgeTable);
+		pCtx->alloc.fpFree(pEdgeEntries);
+	}
+	return err;
+}
+
+//maps a run of compatible entries as a single merged in-mesh,
+//so each mapping stage's jobs span the faces of every mesh in the run
+static
+StucErr mapBatchRun(
+	StucContext pCtx,
+	const StucMapArr *pMapArr,
+	I32 entryCount,
+	const StucMapToMeshBatchEntry *pEntries,
+	F32 wScale,
+	F32 receiveLen,
+	bool triangulate,
+	const JobCancel *pCancel
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	const StucMapToMeshBatchEntry *pFirst = pEntries;
+	if (entryCount == 1) {
+		RoiRange roi = {.pRoi = pFirst->pRoi, .faceEnd = pFirst->pMeshIn->faceCount};
+		return mapToMesh(
+			pCtx,
+			pMapArr,
+			pFirst->pMeshIn,
+			pFirst->pInIndexedAttribs,
+			pFirst->pMeshOut,
+			pFirst->pOutIndexedAttribs,
+			wScale,
+			receiveLen,
+			pFirst->keepExistingIdxAttribs,
+			triangulate,
+			1, &roi,
+			pCancel
+		);
+	}
+	Mesh merged = {0};
+	StucMesh mergedOut = {0};
+	RoiRange *pRois = pCtx->alloc.fpCalloc(entryCount, sizeof(RoiRange));
+	err = batchMergeInMeshes(pCtx, entryCount, pEntries, &merged, pRois);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	//triangulated per entry, once the out-mesh is split
+	err = mapToMesh(
+		pCtx,
+		pMapArr,
+		&merged.core,
+		pFirst->pInIndexedAttribs,
+		&mergedOut,
+		pFirst->pOutIndexedAttribs,
+		wScale,
+		receiveLen,
+		pFirst->keepExistingIdxAttribs,
+		false,
+		entryCount, pRois,
+		pCancel
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	err = batchSplitOutMesh(pCtx, &mergedOut, entryCount, pEntries);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	//entries share in indexed attribs, so the out indexed attribs are the same too.
+	//Like with pFirst, the caller's arr is overwritten rather than appended to
+	for (I32 i = 1; i < entryCount; ++i) {
+		const StucAttribIndexedArr *pSrc = pFirst->pOutIndexedAttribs;
+		StucAttribIndexedArr *pDest = pEntries[i].pOutIndexedAttribs;
+		*pDest = (StucAttribIndexedArr){.size = pSrc->size};
+		pDest->pArr = pCtx->alloc.fpCalloc(pDest->size, sizeof(AttribIndexed));
+		for (I32 j = 0; j < pSrc->count; ++j) {
+			err = stucAppendAndCopyIdxAttrib(pCtx, pSrc->pArr + j, pDest);
+			PIX_ERR_THROW_IFNOT(err, "", 1);
+		}
+	}
+	if (triangulate) {
+		for (I32 i = 0; i < entryCount; ++i) {
+			err = stucMeshTriangulate(pCtx, pEntries[i].pMeshOut);
+			PIX_ERR_THROW_IFNOT(err, "", 1);
+		}
+	}
+	PIX_ERR_CATCH(1, err,
+		destroyBatchOutMeshes(pCtx, entryCount, pEntries);
+	);
+	PIX_ERR_CATCH(0, err, ;);
+	if (merged.core.pFaces) {
+		stucMeshDestroy(pCtx, &merged.core);
+	}
+	stucMeshDestroy(pCtx, &mergedOut);
+	pCtx->alloc.fpFree(pRois);
+	return err;
+}
+
+StucErr stucMapToMeshBatch(
+	StucContext pCtx,
+	const StucMapArr *pMapArr,
+	I32 entryCount,
+	const StucMapToMeshBatchEntry *pEntries,
+	F32 wScale,
+	F32 receiveLen,
+	bool triangulate,
+	StucCancelToken *pCancel
+) {
+	StucErr err = PIX_ERR_SUCCESS;
+	PIX_ERR_RETURN_IFNOT_COND(err, entryCount >= 0, "");
+	PIX_ERR_RETURN_IFNOT_COND(err, !entryCount || pEntries, "");
+	PIX_ERR_RETURN_IFNOT_COND(
+		err,
+		pMapArr && pMapArr->count && pMapArr->pArr,
+		""
+	);
+	for (I32 i = 0; i < entryCount; ++i) {
+		PIX_ERR_RETURN_IFNOT_COND(
+			err,
+			pEntries[i].pMeshIn && pEntries[i].pMeshOut && pEntries[i].pOutIndexedAttribs,
+			""
+		);
+	}
+	JobCancel cancel = {0};
+	stucJobCancelInit(&cancel, pCancel);
+	for (I32 i = 0; i < entryCount;) {
+		I32 runCount = 1;
+		while (i + runCount < entryCount &&
+			isBatchEntryCompatible(pEntries + i, pEntries + i + runCount)
+		) {
+			++runCount;
+		}
+		err = mapBatchRun(
+			pCtx,
+			pMapArr,
+			runCount, pEntries + i,
+			wScale,
+			receiveLen,
+			triangulate,
+			&cancel
+		);
+		PIX_ERR_RETURN_IFNOT(err, "");
+		i += runCount;
+	}
 	return err;
 }
 
@@ -2537,6 +3798,67 @@ StucErr stucObjectInit(
 	return err;
 }
 
+typedef struct CornerToVertShared {
+	StucMesh *pMesh;
+	const I32 *pFirstCorner;
+	I8 *pSplit;
+} CornerToVertShared;
+
+typedef struct CornerToVertJobArgs {
+	JobArgs core;
+	I32 splitCount;
+	I32 splitStart;
+} CornerToVertJobArgs;
+
+static
+I32 cornerToVertJobsGetRange(StucContext pCtx, const void *pShared, void *pInitInfo) {
+	return ((const CornerToVertShared *)pShared)->pMesh->cornerCount;
+}
+
+//a corner is split into a new vert if it's attribs differ from those of the first
+//corner to reference it's vert
+static
+StucErr cornerToVertFindSplits(void *pArgsVoid) {
+	StucErr err = PIX_ERR_SUCCESS;
+	CornerToVertJobArgs *pArgs = pArgsVoid;
+	const CornerToVertShared *pShared = pArgs->core.pShared;
+	StucMesh *pMesh = pShared->pMesh;
+	//count is 0 so stucCmpAttribs indexes corner attribs from the start of the arr
+	AttribArray firstCorners = {.pArr = pMesh->cornerAttribs.pArr};
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		I32 first = pShared->pFirstCorner[pMesh->pCorners[i]];
+		pShared->pSplit[i] = first != i &&
+			!stucCmpAttribs(&firstCorners, first, &pMesh->cornerAttribs, i);
+		pArgs->splitCount += pShared->pSplit[i];
+	}
+	return err;
+}
+
+static
+StucErr cornerToVertFill(void *pArgsVoid) {
+	StucErr err = PIX_ERR_SUCCESS;
+	CornerToVertJobArgs *pArgs = pArgsVoid;
+	const CornerToVertShared *pShared = pArgs->core.pShared;
+	StucMesh *pMesh = pShared->pMesh;
+	I32 newVert = pMesh->vertCount + pArgs->splitStart;
+	for (I32 i = pArgs->core.range.start; i < pArgs->core.range.end; ++i) {
+		I32 vert = pMesh->pCorners[i];
+		if (pShared->pSplit[i]) {
+			//vertAttribs.count doesn't yet include the appended corner attribs,
+			//so only the existing vert attribs are copied here
+			stucCopyInSameAttrib(&pMesh->vertAttribs, newVert, vert);
+			vert = newVert;
+			++newVert;
+			pMesh->pCorners[i] = vert;
+		}
+		else if (pShared->pFirstCorner[vert] != i) {
+			continue;
+		}
+		stucCopyAttribs(&pMesh->vertAttribs, vert, &pMesh->cornerAttribs, i);
+	}
+	return err;
+}
+
 StucErr stucMeshAttribsCornerToVert(StucContext pCtx, StucMesh *pMesh) {
 	StucErr err = PIX_ERR_SUCCESS;
 	I32 newSize = pMesh->vertAttribs.count + pMesh->cornerAttribs.count;
@@ -2546,40 +3868,71 @@ StucErr stucMeshAttribsCornerToVert(StucContext pCtx, StucMesh *pMesh) {
 		pMesh->cornerAttribs.pArr,
 		sizeof(Attrib) * pMesh->cornerAttribs.count
 	);
-	I8Arr flags = {
-		.count = pMesh->vertCount,
-		.pArr = pCtx->alloc.fpCalloc(pMesh->vertCount, 1)
-	};
 	for (I32 i = 0; i < pMesh->cornerAttribs.count; ++i) {
 		AttribCore *pAttrib = &pMesh->vertAttribs.pArr[pMesh->vertAttribs.count + i].core;
 		I32 attribSize = stucGetAttribSizeIntern(pAttrib->type);
 		pAttrib->pData = pCtx->alloc.fpCalloc(pMesh->vertCount, attribSize);
 	}
-	I32 vertSize = pMesh->vertCount;
-	for (I32 i = 0; i < pMesh->cornerCount; ++i) {
-		I32 vert = pMesh->pCorners[i];
-		if (!flags.pArr[vert]) {
-			flags.pArr[vert] = true;
-			stucCopyAttribs(&pMesh->vertAttribs, vert, &pMesh->cornerAttribs, i);
-			continue;
-		}
-		bool split = !stucCmpAttribs(&pMesh->vertAttribs, vert, &pMesh->cornerAttribs, i);
-		if (split) {
-			stucReallocVertAttribsIfNeeded(pCtx, pMesh, &vertSize);
-			stucCopyInSameAttrib(&pMesh->vertAttribs, pMesh->vertCount, vert);
-			vert = pMesh->vertCount;
-			++pMesh->vertCount;
-			pMesh->pCorners[i] = vert;
+	//unreferenced verts are left unset, they're never read
+	I32 *pFirstCorner = pCtx->alloc.fpMalloc(pMesh->vertCount * sizeof(I32));
+	for (I32 i = pMesh->cornerCount - 1; i >= 0; --i) {
+		pFirstCorner[pMesh->pCorners[i]] = i;
+	}
+	CornerToVertShared shared = {
+		.pMesh = pMesh,
+		.pFirstCorner = pFirstCorner,
+		.pSplit = pCtx->alloc.fpMalloc(pMesh->cornerCount)
+	};
+	I32 jobCount = 0;
+	CornerToVertJobArgs jobArgs[PIX_THREAD_MAX_SUB_MAPPING_JOBS] = {0};
+	stucMakeJobArgs(
+		pCtx,
+		&shared,
+		&jobCount, jobArgs, sizeof(CornerToVertJobArgs),
+		NULL,
+		cornerToVertJobsGetRange, NULL
+	);
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, jobArgs, sizeof(CornerToVertJobArgs),
+		cornerToVertFindSplits
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	//new verts are numbered in corner order, same as if this were done serially
+	I32 splitCount = 0;
+	for (I32 i = 0; i < jobCount; ++i) {
+		jobArgs[i].splitStart = splitCount;
+		splitCount += jobArgs[i].splitCount;
+	}
+	if (splitCount) {
+		for (I32 i = 0; i < newSize; ++i) {
+			AttribCore *pAttrib = &pMesh->vertAttribs.pArr[i].core;
+			if (pAttrib->pData) {
+				stucReallocAttrib(
+					&pCtx->alloc,
+					NULL,
+					pAttrib,
+					pMesh->vertCount + splitCount
+				);
+			}
 		}
-		stucCopyAttribs(&pMesh->vertAttribs, vert, &pMesh->cornerAttribs, i);
 	}
+	err = stucDoJobInParallel(
+		pCtx,
+		jobCount, jobArgs, sizeof(CornerToVertJobArgs),
+		cornerToVertFill
+	);
+	PIX_ERR_THROW_IFNOT(err, "", 0);
+	pMesh->vertCount += splitCount;
 	pMesh->vertAttribs.count = newSize;
-	pCtx->alloc.fpFree(flags.pArr);
 	for (I32 i = 0; i < pMesh->cornerAttribs.count; ++i) {
 		pCtx->alloc.fpFree(pMesh->cornerAttribs.pArr[i].core.pData);
 	}
 	pCtx->alloc.fpFree(pMesh->cornerAttribs.pArr);
 	pMesh->cornerAttribs = (AttribArray){0};
+	PIX_ERR_CATCH(0, err, ;);
+	pCtx->alloc.fpFree(pFirstCorner);
+	pCtx->alloc.fpFree(shared.pSplit);
 	return err;
 }
 
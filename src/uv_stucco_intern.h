@@ -38,6 +38,9 @@ typedef struct MapToMeshBasic {
 	const F32 wScale;
 	const F32 receiveLen;
 	const I8 maskIdx;
+	const JobCancel *pCancel;
+	//false if nothing reads the tangent & bitangent of the in-mesh tbn
+	bool needsTbn;
 } MapToMeshBasic;
 
 typedef struct OutBufIdx {
@@ -79,10 +82,12 @@ void stucAddVertsToOutMesh(
 	PixuctHTable *pMergeTable,
 	I32 vertAllocIdx
 );
+void stucOutEdgeTableInit(MapToMeshBasic *pBasic, PixuctHTable *pEdgeTable);
 void stucAddFacesAndCornersToOutMesh(
 	MapToMeshBasic *pBasic,
 	const InPieceArr *pInPieces,
 	PixuctHTable *pMergeTable,
+	PixuctHTable *pEdgeTable,
 	OutBufIdxArr *pOutBufIdxArr,
 	BufOutRangeTable *pBufOutTable,
 	bool clip